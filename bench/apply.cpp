@@ -0,0 +1,88 @@
+// opt::apply over four Optionals against the short circuiting chain
+// a && b && c && d, on inputs where each Optional is engaged independently.
+//
+// optional_apply_bench [elements] [percent engaged] [passes]
+//
+// With mixed flags the chain can mispredict once per Optional, apply at most
+// once per call.
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include <optional/apply.hpp>
+#include <optional/optional.hpp>
+
+#include "perf_counters.hpp"
+#include "runner.hpp"
+
+namespace {
+
+using Value = std::int64_t;
+
+struct Row {
+    opt::Optional<Value> a;
+    opt::Optional<Value> b;
+    opt::Optional<Value> c;
+    opt::Optional<Value> d;
+};
+
+auto chain(const Row& r) -> opt::Optional<Value>
+{
+    if (r.a && r.b && r.c && r.d)
+        return *r.a + *r.b + *r.c + *r.d;
+    return opt::none;
+}
+
+auto applied(const Row& r) -> opt::Optional<Value>
+{
+    return opt::apply(
+        [](Value a, Value b, Value c, Value d) { return a + b + c + d; }, r.a,
+        r.b, r.c, r.d);
+}
+
+template <typename F>
+auto sum(const std::vector<Row>& rows, F f) -> Value
+{
+    Value sum = 0;
+    for (auto const& r : rows)
+        sum += f(r).value_or(0);
+    return sum;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    auto const n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1u << 20;
+    auto const percent = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 85u;
+    auto const passes = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 20u;
+
+    std::mt19937_64 rng{40};
+    auto const maybe = [&]() -> opt::Optional<Value> {
+        if (rng() % 100 < percent)
+            return static_cast<Value>(rng() % 1000);
+        return opt::none;
+    };
+    std::vector<Row> rows(n);
+    for (auto& r : rows) {
+        r.a = maybe();
+        r.b = maybe();
+        r.c = maybe();
+        r.d = maybe();
+    }
+
+    std::printf("%zu rows, %zu%% engaged, %zu passes\n",
+                static_cast<std::size_t>(n), static_cast<std::size_t>(percent),
+                static_cast<std::size_t>(passes));
+    bench::Runner runner{n, passes};
+
+    runner.run("a && b && c && d", [&] {
+        bench::do_not_optimize(sum(rows, chain));
+    });
+    runner.run("opt::apply", [&] {
+        bench::do_not_optimize(sum(rows, applied));
+    });
+}
@@ -0,0 +1,95 @@
+// Overflow checked multiplication reported through Optional, through
+// exceptions, and through the array form, against unchecked arithmetic.
+//
+// optional_checked_bench [elements] [percent overflowing] [passes]
+//
+// Each case multiplies n pairs of int32 and sums the results that did not
+// overflow.
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <optional/checked.hpp>
+#include <optional/optional.hpp>
+
+#include "perf_counters.hpp"
+#include "runner.hpp"
+
+namespace {
+
+using Value = std::int32_t;
+
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((noinline))
+#endif
+auto throwing_mul(Value x, Value y) -> Value
+{
+    auto const r = static_cast<std::int64_t>(x) * y;
+    if (r < std::numeric_limits<Value>::min() ||
+        r > std::numeric_limits<Value>::max())
+        throw std::overflow_error("mul");
+    return static_cast<Value>(r);
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    auto const n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1u << 20;
+    auto const percent = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1u;
+    auto const passes = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 20u;
+
+    // Small operands never overflow, large ones always do.
+    std::mt19937_64 rng{34};
+    std::vector<Value> x(n);
+    std::vector<Value> y(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        auto const big = rng() % 100 < percent;
+        x[i] = static_cast<Value>(rng() % 1000) + (big ? 1 << 20 : 0);
+        y[i] = static_cast<Value>(rng() % 1000) + (big ? 1 << 20 : 0);
+    }
+    std::vector<Value> out(n);
+    std::vector<std::uint64_t> validity((n + 63) / 64);
+
+    std::printf("%zu elements, %zu%% overflowing, %zu passes\n",
+                static_cast<std::size_t>(n), static_cast<std::size_t>(percent),
+                static_cast<std::size_t>(passes));
+    bench::Runner runner{n, passes};
+
+    runner.run("unchecked", [&] {
+        std::int64_t sum = 0;
+        for (std::size_t i = 0; i < n; ++i)
+            sum += static_cast<Value>(static_cast<std::uint32_t>(x[i]) *
+                                      static_cast<std::uint32_t>(y[i]));
+        bench::do_not_optimize(sum);
+    });
+    runner.run("checked_mul", [&] {
+        std::int64_t sum = 0;
+        for (std::size_t i = 0; i < n; ++i)
+            sum += opt::checked_mul(x[i], y[i]).value_or(0);
+        bench::do_not_optimize(sum);
+    });
+    runner.run("checked_mul, arrays", [&] {
+        opt::checked_mul(x.data(), y.data(), n, out.data(), validity.data());
+        std::int64_t sum = 0;
+        for (std::size_t i = 0; i < n; ++i)
+            sum += out[i];
+        bench::do_not_optimize(sum);
+    });
+    runner.run("exceptions", [&] {
+        std::int64_t sum = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            try {
+                sum += throwing_mul(x[i], y[i]);
+            }
+            catch (const std::overflow_error&) {
+            }
+        }
+        bench::do_not_optimize(sum);
+    });
+}
@@ -0,0 +1,100 @@
+// Branch mispredictions of element wise comparisons of optionals on mixed
+// data: a branching reference, the Optional and std::optional operators, and
+// opt::compare_n.
+//
+// optional_compare_bench [elements] [percent engaged] [passes]
+//
+// Payloads are drawn from a small range so equal pairs are common. Read the
+// br-miss column, misses per element, where hardware counters are available.
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include <optional/algorithm.hpp>
+#include <optional/optional.hpp>
+
+#include "perf_counters.hpp"
+#include "runner.hpp"
+
+namespace {
+
+using Value = std::int64_t;
+
+// The comparison written with short circuiting branches.
+auto branching_equal(const opt::Optional<Value>& x,
+                     const opt::Optional<Value>& y) -> bool
+{
+    if (x && y)
+        return *x == *y;
+    return !x && !y;
+}
+
+template <typename Sequence, typename Predicate>
+auto count_pairs(const Sequence& a, const Sequence& b, Predicate pred)
+    -> std::size_t
+{
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < a.size(); ++i)
+        count += pred(a[i], b[i]) ? 1 : 0;
+    return count;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    auto const n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1u << 20;
+    auto const percent = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 50u;
+    auto const passes = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 20u;
+
+    std::mt19937_64 rng{31};
+    std::vector<opt::Optional<Value>> a(n);
+    std::vector<opt::Optional<Value>> b(n);
+    std::vector<std::optional<Value>> std_a(n);
+    std::vector<std::optional<Value>> std_b(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        if (rng() % 100 < percent) {
+            a[i] = static_cast<Value>(rng() % 4);
+            std_a[i] = *a[i];
+        }
+        if (rng() % 100 < percent) {
+            b[i] = static_cast<Value>(rng() % 4);
+            std_b[i] = *b[i];
+        }
+    }
+    std::vector<std::uint64_t> mask((n + 63) / 64);
+
+    std::printf("%zu elements, %zu%% engaged, %zu passes\n",
+                static_cast<std::size_t>(n), static_cast<std::size_t>(percent),
+                static_cast<std::size_t>(passes));
+    bench::Runner runner{n, passes};
+
+    runner.run("branching ==", [&] {
+        bench::do_not_optimize(count_pairs(a, b, branching_equal));
+    });
+    runner.run("Optional ==", [&] {
+        bench::do_not_optimize(count_pairs(a, b, std::equal_to<>{}));
+    });
+    runner.run("std::optional ==", [&] {
+        bench::do_not_optimize(count_pairs(std_a, std_b, std::equal_to<>{}));
+    });
+    runner.run("compare_n ==", [&] {
+        bench::do_not_optimize(
+            opt::compare_n(a.data(), b.data(), n, mask.data()));
+    });
+    runner.run("Optional <", [&] {
+        bench::do_not_optimize(count_pairs(a, b, std::less<>{}));
+    });
+    runner.run("std::optional <", [&] {
+        bench::do_not_optimize(count_pairs(std_a, std_b, std::less<>{}));
+    });
+    runner.run("compare_n <", [&] {
+        bench::do_not_optimize(opt::compare_n(a.data(), b.data(), n,
+                                              mask.data(), std::less<>{}));
+    });
+}
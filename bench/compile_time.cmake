@@ -0,0 +1,35 @@
+# Times the front end on a source file and fails if the fastest of several
+# runs exceeds a budget.
+#
+# cmake -DCXX=<compiler> -DSOURCE=<file> -DINCLUDE_DIR=<dir> -DSTANDARD=<flag>
+#       [-DRUNS=<n>] [-DBUDGET_MS=<ms>] -P compile_time.cmake
+
+if(NOT RUNS)
+    set(RUNS 3)
+endif()
+
+if(CMAKE_VERSION VERSION_LESS "3.23")
+    message(FATAL_ERROR "Timing the front end needs CMake 3.23 or later.")
+endif()
+
+set(best "")
+foreach(run RANGE 1 ${RUNS})
+    string(TIMESTAMP start "%s%f")
+    execute_process(
+        COMMAND ${CXX} ${STANDARD} -fsyntax-only -I${INCLUDE_DIR} ${SOURCE}
+        RESULT_VARIABLE result
+        ERROR_VARIABLE errors)
+    string(TIMESTAMP stop "%s%f")
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "Compilation failed:\n${errors}")
+    endif()
+    math(EXPR elapsed "(${stop} - ${start}) / 1000")
+    if(best STREQUAL "" OR elapsed LESS best)
+        set(best ${elapsed})
+    endif()
+endforeach()
+
+message(STATUS "Front end time, best of ${RUNS}: ${best} ms")
+if(BUDGET_MS AND best GREATER BUDGET_MS)
+    message(FATAL_ERROR "Over the compile time budget of ${BUDGET_MS} ms.")
+endif()
@@ -0,0 +1,57 @@
+// Instantiates Optional for OPTIONAL_BENCH_INSTANTIATIONS distinct payload
+// types and exercises the members most code uses, to measure the front end
+// cost of the library per instantiation.
+#include <utility>
+
+#include <optional/optional.hpp>
+
+#ifndef OPTIONAL_BENCH_INSTANTIATIONS
+#define OPTIONAL_BENCH_INSTANTIATIONS 1000
+#endif
+
+namespace {
+
+template <int N>
+struct Payload {
+    int value;
+
+    friend auto operator==(const Payload& x, const Payload& y) -> bool
+    {
+        return x.value == y.value;
+    }
+
+    friend auto operator<(const Payload& x, const Payload& y) -> bool
+    {
+        return x.value < y.value;
+    }
+};
+
+template <int N>
+auto exercise(int x) -> int
+{
+    opt::Optional<Payload<N>> a{Payload<N>{x}};
+    opt::Optional<Payload<N>> b = opt::none;
+    b = a;
+    a.emplace(Payload<N>{x + N});
+    auto c = std::move(b);
+    return (a == c) + (a < c) + a.value_or(Payload<N>{0}).value;
+}
+
+template <int... Ns>
+auto exercise_all(std::integer_sequence<int, Ns...>, int x) -> int
+{
+    int const results[] = {exercise<Ns>(x)...};
+    int sum = 0;
+    for (int r : results)
+        sum += r;
+    return sum;
+}
+
+}  // namespace
+
+int main(int argc, char**)
+{
+    return exercise_all(
+               std::make_integer_sequence<int, OPTIONAL_BENCH_INSTANTIATIONS>{},
+               argc) == 0;
+}
@@ -0,0 +1,120 @@
+// Short circuiting a chain of fallible steps three ways: hand-written early
+// returns, co_await on Optional, and exceptions.
+//
+// optional_coroutine_bench [elements] [percent failing] [passes]
+//
+// Each element runs a chain of four steps, the first failing step ending
+// it. `percent failing` is the share of elements on which some step fails.
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <optional/coroutine.hpp>
+#include <optional/optional.hpp>
+
+#include "perf_counters.hpp"
+#include "runner.hpp"
+
+namespace {
+
+using opt::Optional;
+
+// A step fails when the low bit of its input is set.
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((noinline))
+#endif
+auto step(std::uint32_t x) -> Optional<std::uint32_t>
+{
+    if (x & 1u)
+        return opt::none;
+    return x >> 1;
+}
+
+auto early_return(std::uint32_t x) -> Optional<std::uint32_t>
+{
+    auto const a = step(x);
+    if (!a)
+        return opt::none;
+    auto const b = step(*a);
+    if (!b)
+        return opt::none;
+    auto const c = step(*b);
+    if (!c)
+        return opt::none;
+    return step(*c);
+}
+
+auto coroutine(std::uint32_t x) -> Optional<std::uint32_t>
+{
+    auto const a = co_await step(x);
+    auto const b = co_await step(a);
+    auto const c = co_await step(b);
+    co_return co_await step(c);
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((noinline))
+#endif
+auto throwing_step(std::uint32_t x) -> std::uint32_t
+{
+    if (x & 1u)
+        throw std::domain_error("odd");
+    return x >> 1;
+}
+
+auto exceptions(std::uint32_t x) -> Optional<std::uint32_t>
+{
+    try {
+        return throwing_step(throwing_step(throwing_step(throwing_step(x))));
+    }
+    catch (const std::domain_error&) {
+        return opt::none;
+    }
+}
+
+template <typename F>
+auto sum(const std::vector<std::uint32_t>& inputs, F f) -> std::uint64_t
+{
+    std::uint64_t sum = 0;
+    for (auto x : inputs)
+        sum += f(x).value_or(0);
+    return sum;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    auto const n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1u << 16;
+    auto const percent = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10u;
+    auto const passes = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 20u;
+
+    // Inputs pass all four steps when their low four bits are clear. A
+    // failing input has one of them set, at a random step.
+    std::mt19937_64 rng{26};
+    std::vector<std::uint32_t> inputs(n);
+    for (auto& x : inputs) {
+        x = static_cast<std::uint32_t>(rng() % 1000) << 4;
+        if (rng() % 100 < percent)
+            x |= 1u << (rng() % 4);
+    }
+
+    std::printf("%zu elements, %zu%% failing, %zu passes\n",
+                static_cast<std::size_t>(n), static_cast<std::size_t>(percent),
+                static_cast<std::size_t>(passes));
+    bench::Runner runner{n, passes};
+
+    runner.run("early return", [&] {
+        bench::do_not_optimize(sum(inputs, early_return));
+    });
+    runner.run("co_await", [&] {
+        bench::do_not_optimize(sum(inputs, coroutine));
+    });
+    runner.run("exceptions", [&] {
+        bench::do_not_optimize(sum(inputs, exceptions));
+    });
+}
@@ -0,0 +1,60 @@
+// Contention between threads that each write their own Optional result
+// slot, with the slots packed in a std::vector and padded in a Per_thread.
+//
+// optional_false_sharing [threads] [writes per thread]
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include <optional/aligned_optional.hpp>
+#include <optional/optional.hpp>
+
+#include "perf_counters.hpp"
+
+namespace {
+
+// Each worker repeatedly writes its running count to slots[worker], then
+// returns the wall clock time of the whole run in ms.
+template <typename Slots>
+auto run(Slots& slots, std::size_t threads, std::size_t writes) -> double
+{
+    auto const start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (std::size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&slots, t, writes] {
+            for (std::size_t i = 0; i < writes; ++i) {
+                slots[t] = static_cast<long>(i);
+                bench::do_not_optimize(slots[t]);
+            }
+        });
+    }
+    for (auto& w : workers)
+        w.join();
+    auto const stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    auto const hardware = std::thread::hardware_concurrency();
+    std::size_t const threads =
+        argc > 1 ? std::strtoull(argv[1], nullptr, 10)
+                 : (hardware > 1 ? (hardware < 8 ? hardware : 8) : 2);
+    std::size_t const writes =
+        argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 20000000;
+
+    std::vector<opt::Optional<long>> packed(threads);
+    opt::Per_thread<opt::Optional<long>> padded(threads);
+
+    std::printf("%zu threads, %zu writes each\n", threads, writes);
+    std::printf("%-36s %10s\n", "layout", "ms");
+    std::printf("%-36s %10.1f\n", "std::vector<Optional<long>>",
+                run(packed, threads, writes));
+    std::printf("%-36s %10.1f\n", "Per_thread<Optional<long>>",
+                run(padded, threads, writes));
+}
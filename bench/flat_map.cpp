@@ -0,0 +1,110 @@
+// Optional_flat_map against std::unordered_map: inserts, hit and miss
+// lookups, and erases of random 64 bit keys.
+//
+// optional_flat_map_bench [keys] [passes]
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <optional/optional.hpp>
+#include <optional/optional_flat_map.hpp>
+
+#include "perf_counters.hpp"
+#include "runner.hpp"
+
+namespace {
+
+using Key = std::uint64_t;
+using Value = std::uint64_t;
+
+template <typename Map>
+auto build(const std::vector<Key>& keys) -> Map
+{
+    Map map;
+    for (auto k : keys)
+        map.insert_or_assign(k, k);
+    return map;
+}
+
+auto lookup_sum(const opt::Optional_flat_map<Key, Value>& map,
+                const std::vector<Key>& keys) -> Value
+{
+    Value sum = 0;
+    for (auto k : keys) {
+        if (auto v = map.find(k))
+            sum += *v;
+    }
+    return sum;
+}
+
+auto lookup_sum(const std::unordered_map<Key, Value>& map,
+                const std::vector<Key>& keys) -> Value
+{
+    Value sum = 0;
+    for (auto k : keys) {
+        auto const it = map.find(k);
+        if (it != map.end())
+            sum += it->second;
+    }
+    return sum;
+}
+
+template <typename Map>
+auto run_cases(bench::Runner& runner,
+               const char* name,
+               const std::vector<Key>& keys,
+               const std::vector<Key>& misses) -> void
+{
+    std::string label;
+    label = std::string{name} + " insert";
+    runner.run(label.c_str(), [&] {
+        auto const map = build<Map>(keys);
+        bench::do_not_optimize(map.size());
+    });
+    auto const map = build<Map>(keys);
+    label = std::string{name} + " find hit";
+    runner.run(label.c_str(), [&] {
+        bench::do_not_optimize(lookup_sum(map, keys));
+    });
+    label = std::string{name} + " find miss";
+    runner.run(label.c_str(), [&] {
+        bench::do_not_optimize(lookup_sum(map, misses));
+    });
+    label = std::string{name} + " erase";
+    runner.run(label.c_str(), [&] {
+        auto copy = map;
+        for (auto k : keys)
+            copy.erase(k);
+        bench::do_not_optimize(copy.size());
+    });
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    auto const n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1u << 18;
+    auto const passes = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10u;
+
+    // Odd keys are inserted, even keys miss.
+    std::mt19937_64 rng{37};
+    std::vector<Key> keys(n);
+    std::vector<Key> misses(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        keys[i] = rng() | 1u;
+        misses[i] = rng() & ~Key{1};
+    }
+
+    std::printf("%zu keys, %zu passes\n", static_cast<std::size_t>(n),
+                static_cast<std::size_t>(passes));
+    bench::Runner runner{n, passes};
+    run_cases<opt::Optional_flat_map<Key, Value>>(runner, "Optional_flat_map",
+                                                  keys, misses);
+    run_cases<std::unordered_map<Key, Value>>(runner, "unordered_map", keys,
+                                              misses);
+}
@@ -0,0 +1,219 @@
+// Hardware counter benchmark of the hot operations of Optional<T>,
+// Optional<T&> and the container layouts, against std::optional and raw
+// struct baselines.
+//
+// optional_perfcounters [elements] [percent engaged] [passes]
+//
+// Each case makes `passes` passes over `elements` elements, reported as
+// described in runner.hpp.
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include <optional/optional.hpp>
+#include <optional/optional_column.hpp>
+#include <optional/rle_optional_column.hpp>
+#include <optional/sparse_optional_array.hpp>
+
+#include "perf_counters.hpp"
+#include "runner.hpp"
+
+namespace {
+
+using Value = std::int64_t;
+
+// The layout an Optional replaces: a value and a flag side by side.
+struct Raw_optional {
+    Value value;
+    bool engaged;
+};
+
+auto has(const Raw_optional& x) -> bool { return x.engaged; }
+
+template <typename O>
+auto has(const O& x) -> bool
+{
+    return bool(x);
+}
+
+auto get(const Raw_optional& x) -> Value { return x.value; }
+
+template <typename O>
+auto get(const O& x) -> Value
+{
+    return *x;
+}
+
+auto value_or(const Raw_optional& x, Value d) -> Value
+{
+    return x.engaged ? x.value : d;
+}
+
+template <typename O>
+auto value_or(const O& x, Value d) -> Value
+{
+    return x.value_or(d);
+}
+
+template <typename Sequence>
+auto sum_engaged(const Sequence& xs) -> Value
+{
+    Value sum = 0;
+    for (auto const& x : xs) {
+        if (has(x))
+            sum += get(x);
+    }
+    return sum;
+}
+
+template <typename Sequence>
+auto sum_value_or(const Sequence& xs) -> Value
+{
+    Value sum = 0;
+    for (auto const& x : xs)
+        sum += value_or(x, 0);
+    return sum;
+}
+
+template <typename Sequence>
+auto count_engaged(const Sequence& xs) -> std::size_t
+{
+    std::size_t count = 0;
+    for (auto const& x : xs)
+        count += has(x);
+    return count;
+}
+
+template <typename Sequence>
+auto copy_all(const Sequence& from, Sequence& to) -> void
+{
+    for (std::size_t i = 0; i < from.size(); ++i)
+        to[i] = from[i];
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    auto const n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1u << 20;
+    auto const percent = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 50u;
+    auto const passes = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 20u;
+
+    std::mt19937_64 rng{48};
+    std::vector<Value> values(n);
+    std::vector<bool> engaged(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        values[i] = static_cast<Value>(rng() % 1000);
+        engaged[i] = rng() % 100 < percent;
+    }
+
+    std::vector<opt::Optional<Value>> optionals(n);
+    std::vector<std::optional<Value>> std_optionals(n);
+    std::vector<Raw_optional> raws(n);
+    std::vector<opt::Optional<Value&>> references(n);
+    std::vector<Value*> pointers(n);
+    opt::Optional_column<Value> column;
+    opt::Rle_optional_column<Value> rle;
+    opt::Sparse_optional_array<Value> sparse;
+    for (std::size_t i = 0; i < n; ++i) {
+        raws[i] = {engaged[i] ? values[i] : 0, engaged[i]};
+        if (engaged[i]) {
+            optionals[i] = values[i];
+            std_optionals[i] = values[i];
+            references[i] = opt::Optional<Value&>{values[i]};
+            pointers[i] = &values[i];
+            column.push_back(values[i]);
+            rle.push_back(values[i]);
+            sparse.set(i, values[i]);
+        }
+        else {
+            column.push_back(opt::none);
+            rle.push_back(opt::none);
+        }
+    }
+    auto optionals_copy = optionals;
+    auto std_optionals_copy = std_optionals;
+    auto raws_copy = raws;
+
+    std::printf("%zu elements, %zu%% engaged, %zu passes\n",
+                static_cast<std::size_t>(n), static_cast<std::size_t>(percent),
+                static_cast<std::size_t>(passes));
+    bench::Runner runner{n, passes};
+
+    runner.run("Optional<T> sum", [&] {
+        bench::do_not_optimize(sum_engaged(optionals));
+    });
+    runner.run("std::optional<T> sum", [&] {
+        bench::do_not_optimize(sum_engaged(std_optionals));
+    });
+    runner.run("raw struct sum", [&] {
+        bench::do_not_optimize(sum_engaged(raws));
+    });
+
+    runner.run("Optional<T> value_or", [&] {
+        bench::do_not_optimize(sum_value_or(optionals));
+    });
+    runner.run("std::optional<T> value_or", [&] {
+        bench::do_not_optimize(sum_value_or(std_optionals));
+    });
+    runner.run("raw struct value_or", [&] {
+        bench::do_not_optimize(sum_value_or(raws));
+    });
+
+    runner.run("Optional<T> count", [&] {
+        bench::do_not_optimize(count_engaged(optionals));
+    });
+    runner.run("std::optional<T> count", [&] {
+        bench::do_not_optimize(count_engaged(std_optionals));
+    });
+    runner.run("raw struct count", [&] {
+        bench::do_not_optimize(count_engaged(raws));
+    });
+
+    runner.run("Optional<T> copy", [&] {
+        copy_all(optionals, optionals_copy);
+        bench::do_not_optimize(optionals_copy.data());
+    });
+    runner.run("std::optional<T> copy", [&] {
+        copy_all(std_optionals, std_optionals_copy);
+        bench::do_not_optimize(std_optionals_copy.data());
+    });
+    runner.run("raw struct copy", [&] {
+        copy_all(raws, raws_copy);
+        bench::do_not_optimize(raws_copy.data());
+    });
+
+    runner.run("Optional<T&> sum", [&] {
+        bench::do_not_optimize(sum_engaged(references));
+    });
+    runner.run("raw pointer sum", [&] {
+        Value sum = 0;
+        for (auto p : pointers) {
+            if (p != nullptr)
+                sum += *p;
+        }
+        bench::do_not_optimize(sum);
+    });
+
+    runner.run("Optional_column sum", [&] {
+        Value sum = 0;
+        for (std::size_t i = 0; i < column.size(); ++i) {
+            if (auto x = column[i])
+                sum += *x;
+        }
+        bench::do_not_optimize(sum);
+    });
+    runner.run("Rle_optional_column sum", [&] {
+        bench::do_not_optimize(opt::sum(rle));
+    });
+    runner.run("Sparse_optional_array sum", [&] {
+        Value sum = 0;
+        for (auto entry : sparse)
+            sum += entry.second;
+        bench::do_not_optimize(sum);
+    });
+}
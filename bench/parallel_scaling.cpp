@@ -0,0 +1,78 @@
+// Scaling of the opt::par reductions with the number of threads, against a
+// serial loop.
+//
+// optional_parallel_bench [elements] [percent engaged] [passes] [max threads]
+//
+// Each case is run on pools of 1, 2, 4, ... threads up to `max threads`,
+// which defaults to the hardware concurrency. Speedups are relative to the
+// serial loop.
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <optional/optional.hpp>
+#include <optional/parallel.hpp>
+
+#include "perf_counters.hpp"
+#include "runner.hpp"
+
+int main(int argc, char** argv)
+{
+    using Value = std::int64_t;
+
+    auto const n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1u << 24;
+    auto const percent = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 50u;
+    auto const passes = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 10u;
+    auto const hardware = std::thread::hardware_concurrency();
+    auto const max_threads = argc > 4 ? std::strtoull(argv[4], nullptr, 10)
+                                      : (hardware == 0 ? 1u : hardware);
+
+    std::mt19937_64 rng{29};
+    std::vector<opt::Optional<Value>> xs(n);
+    for (auto& x : xs) {
+        if (rng() % 100 < percent)
+            x = static_cast<Value>(rng() % 1000);
+    }
+
+    std::printf("%zu elements, %zu%% engaged, %zu passes\n",
+                static_cast<std::size_t>(n), static_cast<std::size_t>(percent),
+                static_cast<std::size_t>(passes));
+    bench::Runner runner{n, passes};
+
+    auto const serial = runner.run("serial sum", [&] {
+        Value sum = 0;
+        for (auto const& x : xs) {
+            if (x)
+                sum += *x;
+        }
+        bench::do_not_optimize(sum);
+    });
+
+    std::vector<std::pair<std::string, double>> speedups;
+    for (std::size_t threads = 1; threads <= max_threads; threads *= 2) {
+        opt::par::Thread_pool pool{threads - 1};
+        auto const name = "reduce_engaged, " + std::to_string(threads) + " thr";
+        auto const ns = runner.run(name.c_str(), [&] {
+            bench::do_not_optimize(opt::par::reduce_engaged(
+                pool, xs.begin(), xs.end(), Value{0}, std::plus<Value>{}));
+        });
+        speedups.emplace_back(name, serial / ns);
+        auto const count_name =
+            "count_engaged, " + std::to_string(threads) + " thr";
+        runner.run(count_name.c_str(), [&] {
+            bench::do_not_optimize(
+                opt::par::count_engaged(pool, xs.begin(), xs.end()));
+        });
+    }
+
+    std::printf("\nspeedup over the serial sum\n");
+    for (auto const& s : speedups)
+        std::printf("%-28s %6.2fx\n", s.first.c_str(), s.second);
+}
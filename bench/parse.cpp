@@ -0,0 +1,122 @@
+// Throughput of opt::parse and opt::parse_column on comma separated integers
+// and decimals, against strtoll and strtod.
+//
+// optional_parse_bench [fields] [percent empty] [passes]
+//
+// Empty fields give empty results. Rates are in MB of input per second.
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <optional/optional.hpp>
+#include <optional/optional_column.hpp>
+#include <optional/parse.hpp>
+
+#include "perf_counters.hpp"
+#include "runner.hpp"
+
+namespace {
+
+// Calls f(first, last) for each comma separated field of \p text.
+template <typename F>
+auto for_each_field(const std::string& text, F f) -> void
+{
+    auto first = text.data();
+    auto const end = text.data() + text.size();
+    for (;;) {
+        auto last = first;
+        while (last != end && *last != ',')
+            ++last;
+        f(first, last);
+        if (last == end)
+            return;
+        first = last + 1;
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    auto const n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1u << 20;
+    auto const percent = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10u;
+    auto const passes = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 10u;
+
+    std::mt19937_64 rng{35};
+    std::string integers;
+    std::string decimals;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (i != 0) {
+            integers += ',';
+            decimals += ',';
+        }
+        if (rng() % 100 < percent)
+            continue;
+        integers += std::to_string(static_cast<std::int64_t>(rng() % 2000000) -
+                                   1000000);
+        decimals += std::to_string(rng() % 100000);
+        decimals += '.';
+        decimals += std::to_string(rng() % 1000);
+    }
+
+    std::printf("%zu fields, %zu%% empty, %zu passes\n",
+                static_cast<std::size_t>(n), static_cast<std::size_t>(percent),
+                static_cast<std::size_t>(passes));
+    bench::Runner runner{n, passes};
+    std::vector<std::pair<const char*, double>> rates;
+    // Runs a case over \p text and records its rate in MB/s.
+    auto const run = [&](const char* name, const std::string& text, auto f) {
+        auto const ns = runner.run(name, f);
+        rates.emplace_back(name, static_cast<double>(text.size()) / ns * 1e3);
+    };
+
+    run("strtoll", integers, [&] {
+        std::int64_t sum = 0;
+        for_each_field(integers, [&](const char* first, const char* last) {
+            if (first != last)
+                sum += std::strtoll(first, nullptr, 10);
+        });
+        bench::do_not_optimize(sum);
+    });
+    run("parse<int64_t>", integers, [&] {
+        std::int64_t sum = 0;
+        for_each_field(integers, [&](const char* first, const char* last) {
+            sum += opt::parse<std::int64_t>(first, last).value_or(0);
+        });
+        bench::do_not_optimize(sum);
+    });
+    run("parse_column<int64_t>", integers, [&] {
+        auto const c = opt::parse_column<std::int64_t>(
+            integers.data(), integers.data() + integers.size(), ',');
+        bench::do_not_optimize(c.size());
+    });
+    run("strtod", decimals, [&] {
+        double sum = 0;
+        for_each_field(decimals, [&](const char* first, const char* last) {
+            if (first != last)
+                sum += std::strtod(first, nullptr);
+        });
+        bench::do_not_optimize(sum);
+    });
+    run("parse<double>", decimals, [&] {
+        double sum = 0;
+        for_each_field(decimals, [&](const char* first, const char* last) {
+            sum += opt::parse<double>(first, last).value_or(0);
+        });
+        bench::do_not_optimize(sum);
+    });
+    run("parse_column<double>", decimals, [&] {
+        auto const c = opt::parse_column<double>(
+            decimals.data(), decimals.data() + decimals.size(), ',');
+        bench::do_not_optimize(c.size());
+    });
+
+    std::printf("\n");
+    for (auto const& r : rates)
+        std::printf("%-28s %8.1f MB/s\n", r.first, r.second);
+}
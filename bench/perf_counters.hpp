@@ -0,0 +1,221 @@
+/// \file
+/// \brief Hardware performance counters around a region of code, read with
+/// perf_event_open on Linux.
+///
+/// Counters the kernel refuses, for example under a restrictive
+/// perf_event_paranoid setting, in a container or on another OS, are
+/// reported as empty and only wall clock time is measured.
+#ifndef OPTIONAL_BENCH_PERF_COUNTERS_HPP
+#define OPTIONAL_BENCH_PERF_COUNTERS_HPP
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <optional/none.hpp>
+#include <optional/optional.hpp>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace bench {
+
+enum Event : std::size_t {
+    cycles,
+    instructions,
+    branch_misses,
+    l1d_misses,
+    llc_misses,
+    dtlb_misses,
+    event_count
+};
+
+constexpr const char* event_names[event_count] = {
+    "cycles", "instr", "br-miss", "L1D-miss", "LLC-miss", "dTLB-miss"};
+
+/// Counts over a measured region, empty where a counter is unavailable.
+struct Reading {
+    double nanoseconds;
+    std::array<opt::Optional<double>, event_count> counts;
+};
+
+/// \brief Opens a counter for each Event and measures regions between
+/// start() and stop().
+///
+/// Core events and cache events are opened as two groups, so each group fits
+/// in the PMU at once. If the kernel multiplexes the groups, counts are
+/// scaled by the fraction of the time their group was running.
+class Perf_counters {
+   public:
+    Perf_counters()
+    {
+#if defined(__linux__)
+        auto const cache = [](std::uint64_t cache, std::uint64_t result) {
+            return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (result << 16);
+        };
+        groups_[0].open(cycles, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        groups_[0].open(instructions, PERF_TYPE_HARDWARE,
+                        PERF_COUNT_HW_INSTRUCTIONS);
+        groups_[0].open(branch_misses, PERF_TYPE_HARDWARE,
+                        PERF_COUNT_HW_BRANCH_MISSES);
+        groups_[1].open(
+            l1d_misses, PERF_TYPE_HW_CACHE,
+            cache(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_RESULT_MISS));
+        groups_[1].open(
+            llc_misses, PERF_TYPE_HW_CACHE,
+            cache(PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_RESULT_MISS));
+        groups_[1].open(
+            dtlb_misses, PERF_TYPE_HW_CACHE,
+            cache(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_RESULT_MISS));
+#endif
+    }
+
+    Perf_counters(const Perf_counters&) = delete;
+    auto operator=(const Perf_counters&) -> Perf_counters& = delete;
+
+    ~Perf_counters()
+    {
+        for (auto& group : groups_)
+            group.close();
+    }
+
+    /// \returns True if at least one hardware counter could be opened.
+    auto available() const -> bool
+    {
+        return !groups_[0].events.empty() || !groups_[1].events.empty();
+    }
+
+    auto start() -> void
+    {
+        for (auto& group : groups_)
+            group.control(reset_request, enable_request);
+        start_ = std::chrono::steady_clock::now();
+    }
+
+    /// \returns The counts since the last call to start().
+    auto stop() -> Reading
+    {
+        auto const stop = std::chrono::steady_clock::now();
+        Reading reading;
+        for (auto& group : groups_)
+            group.control(disable_request, disable_request);
+        for (auto& group : groups_)
+            group.read(reading);
+        reading.nanoseconds =
+            std::chrono::duration<double, std::nano>(stop - start_).count();
+        return reading;
+    }
+
+   private:
+#if defined(__linux__)
+    static constexpr unsigned long reset_request = PERF_EVENT_IOC_RESET;
+    static constexpr unsigned long enable_request = PERF_EVENT_IOC_ENABLE;
+    static constexpr unsigned long disable_request = PERF_EVENT_IOC_DISABLE;
+#else
+    static constexpr unsigned long reset_request = 0;
+    static constexpr unsigned long enable_request = 0;
+    static constexpr unsigned long disable_request = 0;
+#endif
+
+    struct Group {
+        int leader{-1};
+        // Open events, in the order the group reads them.
+        std::vector<Event> events;
+        std::vector<int> fds;
+
+#if defined(__linux__)
+        auto open(Event event, std::uint32_t type, std::uint64_t config)
+            -> void
+        {
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = type;
+            attr.config = config;
+            attr.disabled = leader == -1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP |
+                               PERF_FORMAT_TOTAL_TIME_ENABLED |
+                               PERF_FORMAT_TOTAL_TIME_RUNNING;
+            auto const fd = static_cast<int>(
+                syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0));
+            if (fd == -1)
+                return;
+            if (leader == -1)
+                leader = fd;
+            events.push_back(event);
+            fds.push_back(fd);
+        }
+#endif
+
+        auto control(unsigned long first, unsigned long second) -> void
+        {
+#if defined(__linux__)
+            if (leader == -1)
+                return;
+            ioctl(leader, first, PERF_IOC_FLAG_GROUP);
+            if (second != first)
+                ioctl(leader, second, PERF_IOC_FLAG_GROUP);
+#else
+            (void)first;
+            (void)second;
+#endif
+        }
+
+        auto read(Reading& reading) -> void
+        {
+#if defined(__linux__)
+            if (leader == -1)
+                return;
+            // nr, time_enabled, time_running, then one value per event.
+            std::vector<std::uint64_t> buffer(3 + events.size());
+            auto const bytes = buffer.size() * sizeof(std::uint64_t);
+            if (::read(leader, buffer.data(), bytes) !=
+                    static_cast<ssize_t>(bytes) ||
+                buffer[0] != events.size() || buffer[2] == 0)
+                return;
+            auto const scale =
+                static_cast<double>(buffer[1]) / static_cast<double>(buffer[2]);
+            for (std::size_t i = 0; i < events.size(); ++i)
+                reading.counts[events[i]] =
+                    static_cast<double>(buffer[3 + i]) * scale;
+#else
+            (void)reading;
+#endif
+        }
+
+        auto close() -> void
+        {
+#if defined(__linux__)
+            for (auto fd : fds)
+                ::close(fd);
+#endif
+            fds.clear();
+            events.clear();
+            leader = -1;
+        }
+    };
+
+    std::array<Group, 2> groups_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+/// Keeps the compiler from discarding the computation of \p x.
+template <typename T>
+inline auto do_not_optimize(const T& x) -> void
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __asm__ volatile("" : : "r,m"(x) : "memory");
+#else
+    static const T* volatile sink;
+    sink = &x;
+#endif
+}
+
+}  // namespace bench
+#endif  // OPTIONAL_BENCH_PERF_COUNTERS_HPP
@@ -0,0 +1,82 @@
+// Throughput of a filter, map, sum pipeline run as a pull pipeline, as a
+// pull pipeline split across two threads by handoff(), and materialised
+// through a std::vector per stage.
+//
+// optional_pull_bench [elements] [passes]
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include <optional/pull.hpp>
+
+#include "perf_counters.hpp"
+#include "runner.hpp"
+
+namespace {
+
+using Value = std::int64_t;
+
+auto keep(Value x) -> bool { return x % 3 != 0; }
+
+auto transform(Value x) -> Value { return x * x + 1; }
+
+template <typename Source>
+auto drain(Source source) -> Value
+{
+    Value sum = 0;
+    while (auto x = source.next())
+        sum += *x;
+    return sum;
+}
+
+auto materialised(const std::vector<Value>& input) -> Value
+{
+    std::vector<Value> kept;
+    for (auto x : input) {
+        if (keep(x))
+            kept.push_back(x);
+    }
+    std::vector<Value> mapped;
+    mapped.reserve(kept.size());
+    for (auto x : kept)
+        mapped.push_back(transform(x));
+    Value sum = 0;
+    for (auto x : mapped)
+        sum += x;
+    return sum;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    auto const n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1u << 20;
+    auto const passes = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 20u;
+
+    std::mt19937_64 rng{27};
+    std::vector<Value> input(n);
+    for (auto& x : input)
+        x = static_cast<Value>(rng() % 1000);
+
+    std::printf("%zu elements, %zu passes\n", static_cast<std::size_t>(n),
+                static_cast<std::size_t>(passes));
+    bench::Runner runner{n, passes};
+
+    runner.run("std::vector per stage", [&] {
+        bench::do_not_optimize(materialised(input));
+    });
+    runner.run("pull", [&] {
+        bench::do_not_optimize(drain(opt::pull::from(input)
+                                     | opt::pull::filter(keep)
+                                     | opt::pull::map(transform)));
+    });
+    runner.run("pull, handoff(1024)", [&] {
+        bench::do_not_optimize(drain(opt::pull::from(input)
+                                     | opt::pull::filter(keep)
+                                     | opt::pull::handoff(1024)
+                                     | opt::pull::map(transform)));
+    });
+}
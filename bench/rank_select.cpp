@@ -0,0 +1,131 @@
+// Rank_select_index against the plain directories it replaces: a prefix
+// count per 64 bit word for rank, and the sorted positions of the engaged
+// elements for select. Reports directory memory and random query times.
+//
+// optional_rank_select_bench [elements] [percent engaged] [queries] [passes]
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include <optional/detail/bit_ops.hpp>
+#include <optional/optional_column.hpp>
+#include <optional/rank_select_index.hpp>
+
+#include "perf_counters.hpp"
+#include "runner.hpp"
+
+namespace {
+
+// Engaged elements before each word, one entry per word.
+struct Word_ranks {
+    explicit Word_ranks(const opt::Optional_column<std::int32_t>& c)
+        : words{c.validity()}, before(c.word_count() + 1)
+    {
+        for (std::size_t w = 0; w < c.word_count(); ++w)
+            before[w + 1] = before[w] + opt::detail::popcount(words[w]);
+    }
+
+    auto rank(std::size_t i) const -> std::size_t
+    {
+        auto const w = i / 64;
+        auto const bits = i % 64;
+        auto const partial =
+            bits == 0 ? 0 : opt::detail::popcount(words[w] << (64 - bits));
+        return before[w] + partial;
+    }
+
+    const std::uint64_t* words;
+    std::vector<std::size_t> before;
+};
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    auto const n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1u << 24;
+    auto const percent = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10u;
+    auto const queries =
+        argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 1u << 20;
+    auto const passes = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 10u;
+
+    std::mt19937_64 rng{46};
+    opt::Optional_column<std::int32_t> column;
+    std::vector<std::size_t> positions;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (rng() % 100 < percent) {
+            positions.push_back(i);
+            column.push_back(static_cast<std::int32_t>(i));
+        }
+        else {
+            column.push_back(opt::none);
+        }
+    }
+    opt::Rank_select_index const index{column.validity(), column.size()};
+    Word_ranks const ranks{column};
+
+    std::vector<std::size_t> rank_queries(queries);
+    std::vector<std::size_t> select_queries(queries);
+    for (std::size_t q = 0; q < queries; ++q) {
+        rank_queries[q] = rng() % (n + 1);
+        select_queries[q] = positions.empty() ? 0 : rng() % positions.size();
+    }
+
+    std::printf("%zu elements, %zu engaged, %zu queries, %zu passes\n",
+                static_cast<std::size_t>(n), positions.size(),
+                static_cast<std::size_t>(queries),
+                static_cast<std::size_t>(passes));
+    std::printf("%-28s %12zu bytes\n", "Rank_select_index",
+                index.directory_bytes());
+    std::printf("%-28s %12zu bytes\n", "per word rank",
+                ranks.before.size() * sizeof(std::size_t));
+    std::printf("%-28s %12zu bytes\n\n", "position array",
+                positions.size() * sizeof(std::size_t));
+
+    bench::Runner runner{queries, passes};
+    runner.run("Rank_select_index rank", [&] {
+        std::size_t sum = 0;
+        for (auto i : rank_queries)
+            sum += index.rank(i);
+        bench::do_not_optimize(sum);
+    });
+    runner.run("per word rank", [&] {
+        std::size_t sum = 0;
+        for (auto i : rank_queries)
+            sum += ranks.rank(i);
+        bench::do_not_optimize(sum);
+    });
+    if (positions.empty())
+        return 0;
+    runner.run("Rank_select_index select", [&] {
+        std::size_t sum = 0;
+        for (auto k : select_queries)
+            sum += index.select(k);
+        bench::do_not_optimize(sum);
+    });
+    runner.run("position array select", [&] {
+        std::size_t sum = 0;
+        for (auto k : select_queries)
+            sum += positions[k];
+        bench::do_not_optimize(sum);
+    });
+    runner.run("dense_index_of", [&] {
+        std::size_t sum = 0;
+        for (auto i : rank_queries)
+            sum += index.dense_index_of(i % n).value_or(0);
+        bench::do_not_optimize(sum);
+    });
+    runner.run("position array lower_bound", [&] {
+        std::size_t sum = 0;
+        for (auto i : rank_queries) {
+            auto const it =
+                std::lower_bound(positions.begin(), positions.end(), i % n);
+            if (it != positions.end() && *it == i % n)
+                sum += static_cast<std::size_t>(it - positions.begin());
+        }
+        bench::do_not_optimize(sum);
+    });
+}
@@ -0,0 +1,106 @@
+// Rle_optional_column against Optional_column on sensor style data, readings
+// that hold steady for a while with gaps: memory, summing by runs, visiting
+// every element, random access and decoding to the bitmap layout.
+//
+// optional_rle_bench [elements] [mean run length] [passes]
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include <optional/optional.hpp>
+#include <optional/optional_column.hpp>
+#include <optional/rle_optional_column.hpp>
+
+#include "perf_counters.hpp"
+#include "runner.hpp"
+
+namespace {
+
+using Value = std::int64_t;
+
+template <typename Sequence>
+auto sum_elements(const Sequence& xs) -> Value
+{
+    Value sum = 0;
+    for (auto x : xs) {
+        if (x)
+            sum += *x;
+    }
+    return sum;
+}
+
+template <typename Column>
+auto lookup_sum(const Column& c, const std::vector<std::size_t>& indices)
+    -> Value
+{
+    Value sum = 0;
+    for (auto i : indices) {
+        if (auto x = c[i])
+            sum += *x;
+    }
+    return sum;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    auto const n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1u << 22;
+    auto const run = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 500u;
+    auto const passes = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 10u;
+
+    std::mt19937_64 rng{45};
+    opt::Rle_optional_column<Value> rle;
+    opt::Optional_column<Value> column;
+    while (rle.size() < n) {
+        auto const length = std::min<std::size_t>(
+            n - rle.size(), 1 + rng() % (2 * run));
+        opt::Optional<Value> value;
+        if (rng() % 4 != 0)
+            value = static_cast<Value>(rng() % 100);
+        rle.append(value, length);
+        for (std::size_t i = 0; i < length; ++i)
+            column.push_back(value);
+    }
+    std::vector<std::size_t> indices(n);
+    for (auto& i : indices)
+        i = rng() % n;
+
+    std::printf("%zu elements in %zu runs, %zu passes\n",
+                static_cast<std::size_t>(n), rle.run_count(),
+                static_cast<std::size_t>(passes));
+    std::printf("%-28s %12zu bytes\n", "Rle_optional_column",
+                rle.memory_usage());
+    std::printf("%-28s %12zu bytes\n\n", "Optional_column",
+                column.memory_usage());
+
+    bench::Runner runner{n, passes};
+    runner.run("Rle_optional_column sum", [&] {
+        bench::do_not_optimize(opt::sum(rle));
+    });
+    runner.run("Optional_column sum", [&] {
+        Value sum = 0;
+        for (std::size_t i = 0; i < column.size(); ++i) {
+            if (auto x = column[i])
+                sum += *x;
+        }
+        bench::do_not_optimize(sum);
+    });
+    runner.run("Rle_optional_column iterate", [&] {
+        bench::do_not_optimize(sum_elements(rle));
+    });
+    runner.run("Rle_optional_column find", [&] {
+        bench::do_not_optimize(lookup_sum(rle, indices));
+    });
+    runner.run("Optional_column find", [&] {
+        bench::do_not_optimize(lookup_sum(column, indices));
+    });
+    runner.run("Rle_optional_column decode", [&] {
+        auto const decoded = rle.to_column();
+        bench::do_not_optimize(decoded.data());
+    });
+}
@@ -0,0 +1,73 @@
+/// \file
+/// \brief Times cases with Perf_counters and prints one row per case.
+#ifndef OPTIONAL_BENCH_RUNNER_HPP
+#define OPTIONAL_BENCH_RUNNER_HPP
+#include <cstddef>
+#include <cstdio>
+
+#include <optional/optional.hpp>
+
+#include "perf_counters.hpp"
+
+namespace bench {
+
+/// \brief Runs each case once to warm up, then `passes` more times under the
+/// counters.
+///
+/// Results are reported per pass, as ns/op and cycles/op, and per element,
+/// `elements` being the work one pass does, for every counter. Counters the
+/// kernel does not allow are printed as "-".
+class Runner {
+   public:
+    Runner(std::size_t elements, std::size_t passes)
+        : elements_{elements}, passes_{passes}
+    {
+        if (!counters_.available())
+            std::printf("Hardware counters unavailable, wall clock only.\n");
+        std::printf("%-28s %10s %9s %9s", "case", "ns/op", "cycles/op",
+                    "ns/elem");
+        for (auto name : event_names)
+            std::printf(" %9s", name);
+        std::printf("\n");
+    }
+
+    /// \returns The wall clock time of one pass in ns.
+    template <typename F>
+    auto run(const char* name, F f) -> double
+    {
+        f();
+        counters_.start();
+        for (std::size_t i = 0; i < passes_; ++i)
+            f();
+        auto const reading = counters_.stop();
+
+        auto const passes = static_cast<double>(passes_);
+        auto const elements = passes * static_cast<double>(elements_);
+        auto const cycles = reading.counts[bench::cycles];
+        std::printf("%-28s %10.0f ", name, reading.nanoseconds / passes);
+        print(cycles ? opt::Optional<double>{*cycles / passes} : opt::none);
+        std::printf(" %9.3f", reading.nanoseconds / elements);
+        for (auto const& count : reading.counts) {
+            std::printf(" ");
+            print(count ? opt::Optional<double>{*count / elements} : opt::none);
+        }
+        std::printf("\n");
+        return reading.nanoseconds / passes;
+    }
+
+   private:
+    static auto print(const opt::Optional<double>& x) -> void
+    {
+        if (x)
+            std::printf("%9.3f", *x);
+        else
+            std::printf("%9s", "-");
+    }
+
+    Perf_counters counters_;
+    std::size_t elements_;
+    std::size_t passes_;
+};
+
+}  // namespace bench
+#endif  // OPTIONAL_BENCH_RUNNER_HPP
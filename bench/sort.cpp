@@ -0,0 +1,89 @@
+// opt::sort against std::sort with the Optional operator<, on int64 and
+// double payloads, and on string payloads that take the comparison sort.
+//
+// optional_sort_bench [elements] [percent engaged] [passes]
+//
+// Every pass sorts a fresh copy of the same input. The copy is timed too,
+// as its own case, so it can be subtracted.
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <optional/algorithm.hpp>
+#include <optional/optional.hpp>
+
+#include "perf_counters.hpp"
+#include "runner.hpp"
+
+namespace {
+
+template <typename T, typename Make>
+auto make_input(std::size_t n, std::size_t percent, Make make)
+    -> std::vector<opt::Optional<T>>
+{
+    std::mt19937_64 rng{30};
+    std::vector<opt::Optional<T>> xs(n);
+    for (auto& x : xs) {
+        if (rng() % 100 < percent)
+            x = make(rng());
+    }
+    return xs;
+}
+
+template <typename T>
+auto run_cases(bench::Runner& runner,
+               const char* type,
+               const std::vector<opt::Optional<T>>& input) -> void
+{
+    auto work = input;
+    std::string name;
+    name = std::string{"copy, "} + type;
+    runner.run(name.c_str(), [&] {
+        work = input;
+        bench::do_not_optimize(work.data());
+    });
+    name = std::string{"std::sort, "} + type;
+    runner.run(name.c_str(), [&] {
+        work = input;
+        std::sort(work.begin(), work.end());
+        bench::do_not_optimize(work.data());
+    });
+    name = std::string{"opt::sort, "} + type;
+    runner.run(name.c_str(), [&] {
+        work = input;
+        opt::sort(work.begin(), work.end());
+        bench::do_not_optimize(work.data());
+    });
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    auto const n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1u << 20;
+    auto const percent = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 80u;
+    auto const passes = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 5u;
+
+    std::printf("%zu elements, %zu%% engaged, %zu passes\n",
+                static_cast<std::size_t>(n), static_cast<std::size_t>(percent),
+                static_cast<std::size_t>(passes));
+    bench::Runner runner{n, passes};
+
+    run_cases(runner, "int64",
+              make_input<std::int64_t>(n, percent, [](std::uint64_t r) {
+                  return static_cast<std::int64_t>(r);
+              }));
+    run_cases(runner, "double",
+              make_input<double>(n, percent, [](std::uint64_t r) {
+                  return static_cast<double>(r % 1000000) - 500000.0;
+              }));
+    run_cases(runner, "string",
+              make_input<std::string>(n, percent, [](std::uint64_t r) {
+                  return std::to_string(r % 1000000);
+              }));
+}
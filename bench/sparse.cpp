@@ -0,0 +1,126 @@
+// Sparse_optional_array against a std::vector<Optional<T>> and an
+// Optional_column covering the whole index space: memory, random lookups and
+// a scan of the engaged elements, plus filling the sparse array in index
+// order and in random order.
+//
+// optional_sparse_bench [slots] [engaged per million] [lookups] [passes]
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include <optional/optional.hpp>
+#include <optional/optional_column.hpp>
+#include <optional/sparse_optional_array.hpp>
+
+#include "perf_counters.hpp"
+#include "runner.hpp"
+
+namespace {
+
+using Value = std::int32_t;
+
+template <typename Array>
+auto lookup_sum(const Array& xs, const std::vector<std::size_t>& indices)
+    -> Value
+{
+    Value sum = 0;
+    for (auto i : indices) {
+        if (auto x = xs[i])
+            sum += *x;
+    }
+    return sum;
+}
+
+auto fill(const std::vector<std::size_t>& indices)
+    -> opt::Sparse_optional_array<Value>
+{
+    opt::Sparse_optional_array<Value> sparse;
+    for (auto i : indices)
+        sparse.set(i, static_cast<Value>(i));
+    return sparse;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    auto const slots =
+        argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1u << 24;
+    auto const ppm = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000u;
+    auto const lookups =
+        argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 1u << 20;
+    auto const passes = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 10u;
+
+    std::mt19937_64 rng{44};
+    std::vector<std::size_t> engaged;
+    for (std::size_t i = 0; i < slots; ++i) {
+        if (rng() % 1000000 < ppm)
+            engaged.push_back(i);
+    }
+    auto shuffled = engaged;
+    std::shuffle(shuffled.begin(), shuffled.end(), rng);
+
+    // Half the lookups hit an engaged element, half a random index.
+    std::vector<std::size_t> indices(lookups);
+    for (std::size_t i = 0; i < lookups; ++i) {
+        indices[i] = i % 2 == 0 && !engaged.empty()
+                         ? engaged[rng() % engaged.size()]
+                         : rng() % slots;
+    }
+
+    auto const sparse = fill(engaged);
+    std::vector<opt::Optional<Value>> dense(slots);
+    opt::Optional_column<Value> column(slots);
+    for (auto i : engaged) {
+        dense[i] = static_cast<Value>(i);
+        column.set(i, static_cast<Value>(i));
+    }
+
+    std::printf("%zu slots, %zu engaged, %zu lookups, %zu passes\n",
+                static_cast<std::size_t>(slots), engaged.size(),
+                static_cast<std::size_t>(lookups),
+                static_cast<std::size_t>(passes));
+    std::printf("%-28s %12zu bytes\n", "Sparse_optional_array",
+                sparse.memory_usage());
+    std::printf("%-28s %12zu bytes\n", "vector<Optional<T>>",
+                dense.capacity() * sizeof(opt::Optional<Value>));
+    std::printf("%-28s %12zu bytes\n\n", "Optional_column",
+                column.size() * sizeof(Value) +
+                    column.word_count() * sizeof(std::uint64_t));
+
+    bench::Runner lookup_runner{lookups, passes};
+    lookup_runner.run("Sparse_optional_array find", [&] {
+        bench::do_not_optimize(lookup_sum(sparse, indices));
+    });
+    lookup_runner.run("vector<Optional<T>> find", [&] {
+        bench::do_not_optimize(lookup_sum(dense, indices));
+    });
+    lookup_runner.run("Optional_column find", [&] {
+        bench::do_not_optimize(lookup_sum(column, indices));
+    });
+    std::printf("\n");
+
+    bench::Runner engaged_runner{engaged.size(), passes};
+    engaged_runner.run("Sparse_optional_array scan", [&] {
+        Value sum = 0;
+        for (auto entry : sparse)
+            sum += entry.second;
+        bench::do_not_optimize(sum);
+    });
+    engaged_runner.run("vector<Optional<T>> scan", [&] {
+        Value sum = 0;
+        for (auto const& x : dense)
+            sum += x.value_or(0);
+        bench::do_not_optimize(sum);
+    });
+    engaged_runner.run("set in index order", [&] {
+        bench::do_not_optimize(fill(engaged).count());
+    });
+    engaged_runner.run("set in random order", [&] {
+        bench::do_not_optimize(fill(shuffled).count());
+    });
+}
@@ -0,0 +1,91 @@
+// Reading optional fields of packed messages in place with Wire_message
+// views, against decoding every field of each message into Optional first.
+//
+// optional_wire_bench [messages] [percent engaged] [passes]
+//
+// Both cases sum the present bids and asks; the in place case touches only
+// the presence byte and the two payloads it needs.
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include <optional/optional.hpp>
+#include <optional/wire.hpp>
+
+#include "perf_counters.hpp"
+#include "runner.hpp"
+
+namespace {
+
+using Quote = opt::Wire_message<std::uint32_t, std::int64_t, std::int64_t,
+                                double, std::uint16_t>;
+
+struct Decoded {
+    opt::Optional<std::uint32_t> id;
+    opt::Optional<std::int64_t> bid;
+    opt::Optional<std::int64_t> ask;
+    opt::Optional<double> size;
+    opt::Optional<std::uint16_t> venue;
+};
+
+auto decode(const unsigned char* message) -> Decoded
+{
+    return {Quote::view<0>(message).to_optional(),
+            Quote::view<1>(message).to_optional(),
+            Quote::view<2>(message).to_optional(),
+            Quote::view<3>(message).to_optional(),
+            Quote::view<4>(message).to_optional()};
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    auto const n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1u << 20;
+    auto const percent = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 80u;
+    auto const passes = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 20u;
+
+    std::mt19937_64 rng{43};
+    auto const maybe = [&](auto value) -> opt::Optional<decltype(value)> {
+        if (rng() % 100 < percent)
+            return value;
+        return opt::none;
+    };
+    std::vector<unsigned char> buffer(n * Quote::size());
+    for (std::size_t i = 0; i < n; ++i) {
+        Quote::encode(buffer.data() + i * Quote::size(),
+                      maybe(static_cast<std::uint32_t>(i)),
+                      maybe(static_cast<std::int64_t>(rng() % 1000)),
+                      maybe(static_cast<std::int64_t>(rng() % 1000)),
+                      maybe(static_cast<double>(rng() % 100)),
+                      maybe(static_cast<std::uint16_t>(rng() % 16)));
+    }
+
+    std::printf("%zu messages of %zu bytes, %zu%% engaged, %zu passes\n",
+                static_cast<std::size_t>(n), Quote::size(),
+                static_cast<std::size_t>(percent),
+                static_cast<std::size_t>(passes));
+    bench::Runner runner{n, passes};
+
+    runner.run("view in place", [&] {
+        std::int64_t sum = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            auto const message = buffer.data() + i * Quote::size();
+            sum += Quote::view<1>(message).value_or(0) +
+                   Quote::view<2>(message).value_or(0);
+        }
+        bench::do_not_optimize(sum);
+    });
+    runner.run("decode to Optional", [&] {
+        std::int64_t sum = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            auto const quote = decode(buffer.data() + i * Quote::size());
+            bench::do_not_optimize(quote);
+            sum += quote.bid.value_or(0) + quote.ask.value_or(0);
+        }
+        bench::do_not_optimize(sum);
+    });
+}
@@ -0,0 +1,551 @@
+/// \file
+/// \brief Sorting and searching for sequences of optionals.
+///
+/// These follow the ordering of the Optional comparison operators, empty
+/// optionals compare less than any value. Sorting first moves the empties to
+/// the front, so the payload comparisons never need to look at the flags, and
+/// arithmetic payloads are then sorted with an LSD radix sort.
+#ifndef OPTIONAL_ALGORITHM_HPP
+#define OPTIONAL_ALGORITHM_HPP
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <optional/detail/bit_ops.hpp>
+#include <optional/optional_free_functions.hpp>
+
+namespace opt {
+namespace detail {
+
+template <typename Iterator>
+using Payload_t = std::decay_t<decltype(**std::declval<Iterator&>())>;
+
+// True if Iterator visits Optional<T> objects, which own their payloads.
+template <typename Iterator>
+using Owns_payloads = std::is_same<
+    typename std::iterator_traits<Iterator>::value_type,
+    Optional<Payload_t<Iterator>>>;
+
+// Random access iterator over the payloads of a range of engaged optionals.
+// Sorting through it moves payloads only, so no Optional is ever copied into
+// a temporary whose flag the compiler cannot see is set.
+template <typename Iterator>
+class Payload_iterator {
+   public:
+    using value_type = Payload_t<Iterator>;
+    using reference = value_type&;
+    using pointer = value_type*;
+    using difference_type =
+        typename std::iterator_traits<Iterator>::difference_type;
+    using iterator_category = std::random_access_iterator_tag;
+
+    Payload_iterator() = default;
+
+    explicit Payload_iterator(Iterator it) : it_{std::move(it)} {}
+
+    auto operator*() const -> reference { return **it_; }
+
+    auto operator->() const -> pointer { return std::addressof(**it_); }
+
+    auto operator[](difference_type n) const -> reference { return *it_[n]; }
+
+    auto operator++() -> Payload_iterator&
+    {
+        ++it_;
+        return *this;
+    }
+
+    auto operator++(int) -> Payload_iterator { return Payload_iterator{it_++}; }
+
+    auto operator--() -> Payload_iterator&
+    {
+        --it_;
+        return *this;
+    }
+
+    auto operator--(int) -> Payload_iterator { return Payload_iterator{it_--}; }
+
+    auto operator+=(difference_type n) -> Payload_iterator&
+    {
+        it_ += n;
+        return *this;
+    }
+
+    auto operator-=(difference_type n) -> Payload_iterator&
+    {
+        it_ -= n;
+        return *this;
+    }
+
+    auto operator+(difference_type n) const -> Payload_iterator
+    {
+        return Payload_iterator{it_ + n};
+    }
+
+    friend auto operator+(difference_type n, const Payload_iterator& x)
+        -> Payload_iterator
+    {
+        return x + n;
+    }
+
+    auto operator-(difference_type n) const -> Payload_iterator
+    {
+        return Payload_iterator{it_ - n};
+    }
+
+    auto operator-(const Payload_iterator& x) const -> difference_type
+    {
+        return it_ - x.it_;
+    }
+
+    auto operator==(const Payload_iterator& x) const -> bool
+    {
+        return it_ == x.it_;
+    }
+
+    auto operator!=(const Payload_iterator& x) const -> bool
+    {
+        return it_ != x.it_;
+    }
+
+    auto operator<(const Payload_iterator& x) const -> bool
+    {
+        return it_ < x.it_;
+    }
+
+    auto operator>(const Payload_iterator& x) const -> bool
+    {
+        return it_ > x.it_;
+    }
+
+    auto operator<=(const Payload_iterator& x) const -> bool
+    {
+        return it_ <= x.it_;
+    }
+
+    auto operator>=(const Payload_iterator& x) const -> bool
+    {
+        return it_ >= x.it_;
+    }
+
+   private:
+    Iterator it_;
+};
+
+// Sorts the engaged optionals [first, last) by comp on their payloads. The
+// payloads are sorted in place where the optionals own them, otherwise the
+// optionals themselves are moved, so Optional<T&> elements are rebound rather
+// than the referenced objects reordered.
+template <typename Iterator, typename Compare>
+auto sort_engaged(Iterator first, Iterator last, Compare comp, std::true_type)
+    -> void
+{
+    std::sort(Payload_iterator<Iterator>{first},
+              Payload_iterator<Iterator>{last}, comp);
+}
+
+template <typename Iterator, typename Compare>
+auto sort_engaged(Iterator first, Iterator last, Compare comp, std::false_type)
+    -> void
+{
+    std::sort(first, last, [&comp](const auto& x, const auto& y) {
+        return comp(*x, *y);
+    });
+}
+
+template <typename Iterator, typename Compare>
+auto sort_engaged(Iterator first, Iterator last, Compare comp) -> void
+{
+    detail::sort_engaged(first, last, std::move(comp),
+                         Owns_payloads<Iterator>{});
+}
+
+template <std::size_t Size>
+struct Unsigned_of_size;
+
+template <>
+struct Unsigned_of_size<1> {
+    using type = std::uint8_t;
+};
+
+template <>
+struct Unsigned_of_size<2> {
+    using type = std::uint16_t;
+};
+
+template <>
+struct Unsigned_of_size<4> {
+    using type = std::uint32_t;
+};
+
+template <>
+struct Unsigned_of_size<8> {
+    using type = std::uint64_t;
+};
+
+// True for payloads radix sorted by opt::sort.
+template <typename T>
+struct Is_radix_sortable
+    : std::integral_constant<
+          bool,
+          (std::is_integral<T>::value && !std::is_same<T, bool>::value) ||
+              (std::is_floating_point<T>::value &&
+               std::numeric_limits<T>::is_iec559 &&
+               (sizeof(T) == 4 || sizeof(T) == 8))> {};
+
+// Maps T to an unsigned key with the same ordering as operator<. Floating
+// point NaNs sort below -inf or above +inf, depending on their sign bit.
+template <typename T>
+struct Radix_key {
+    using Key = typename Unsigned_of_size<sizeof(T)>::type;
+    static constexpr Key sign_bit = Key(Key{1} << (sizeof(T) * 8 - 1));
+
+    static auto to_key(T x) -> Key
+    {
+        Key k;
+        std::memcpy(&k, &x, sizeof(T));
+        return encode(k, std::is_floating_point<T>{}, std::is_signed<T>{});
+    }
+
+    static auto from_key(Key k) -> T
+    {
+        k = decode(k, std::is_floating_point<T>{}, std::is_signed<T>{});
+        T x;
+        std::memcpy(&x, &k, sizeof(T));
+        return x;
+    }
+
+   private:
+    static auto encode(Key k, std::false_type, std::false_type) -> Key
+    {
+        return k;
+    }
+
+    static auto encode(Key k, std::false_type, std::true_type) -> Key
+    {
+        return Key(k ^ sign_bit);
+    }
+
+    static auto encode(Key k, std::true_type, std::true_type) -> Key
+    {
+        return (k & sign_bit) ? Key(~k) : Key(k | sign_bit);
+    }
+
+    static auto decode(Key k, std::false_type, std::false_type) -> Key
+    {
+        return k;
+    }
+
+    static auto decode(Key k, std::false_type, std::true_type) -> Key
+    {
+        return Key(k ^ sign_bit);
+    }
+
+    static auto decode(Key k, std::true_type, std::true_type) -> Key
+    {
+        return (k & sign_bit) ? Key(k & ~sign_bit) : Key(~k);
+    }
+};
+
+// LSD radix sort on 8 bit digits. All digit histograms are built in a single
+// pass, and passes where every key has the same digit are skipped.
+template <typename Key>
+auto radix_sort(std::vector<Key>& keys) -> void
+{
+    constexpr std::size_t digits = sizeof(Key);
+    std::array<std::array<std::size_t, 256>, digits> counts{};
+    for (auto k : keys) {
+        for (std::size_t d = 0; d < digits; ++d)
+            ++counts[d][(k >> (8 * d)) & 0xFF];
+    }
+    std::vector<Key> buffer(keys.size());
+    for (std::size_t d = 0; d < digits; ++d) {
+        auto& count = counts[d];
+        if (count[(keys.front() >> (8 * d)) & 0xFF] == keys.size())
+            continue;
+        std::size_t offset = 0;
+        for (auto& c : count) {
+            auto const n = c;
+            c = offset;
+            offset += n;
+        }
+        for (auto k : keys)
+            buffer[count[(k >> (8 * d)) & 0xFF]++] = k;
+        keys.swap(buffer);
+    }
+}
+
+// Below this many values a comparison sort is faster than the radix sort.
+constexpr std::size_t radix_threshold = 256;
+
+// The radix sort writes sorted payloads back in place, which is only a
+// reorder for optionals that own their payloads. Optional<T&> ranges are
+// sorted by rebinding the references instead.
+template <typename Iterator>
+using Has_radix_sort = std::integral_constant<
+    bool,
+    Owns_payloads<Iterator>::value &&
+        Is_radix_sortable<Payload_t<Iterator>>::value>;
+
+template <typename Iterator>
+auto sort_values(Iterator first, Iterator last, std::true_type) -> void
+{
+    using T = Payload_t<Iterator>;
+    using Key = typename Radix_key<T>::Key;
+    auto const n = static_cast<std::size_t>(std::distance(first, last));
+    if (n < radix_threshold) {
+        detail::sort_engaged(first, last, std::less<T>{});
+        return;
+    }
+    std::vector<Key> keys;
+    keys.reserve(n);
+    for (auto it = first; it != last; ++it)
+        keys.push_back(Radix_key<T>::to_key(**it));
+    radix_sort(keys);
+    auto k = keys.begin();
+    for (auto it = first; it != last; ++it, ++k)
+        **it = Radix_key<T>::from_key(*k);
+}
+
+template <typename Iterator>
+auto sort_values(Iterator first, Iterator last, std::false_type) -> void
+{
+    detail::sort_engaged(first, last,
+                         [](const auto& x, const auto& y) { return x < y; });
+}
+
+// Predicates compare_n evaluates from flag words. combine() turns the engaged
+// flags of a block and the predicate on the payloads of the pairs that are
+// both engaged into the result word.
+template <typename Predicate>
+struct Flag_word_predicate : std::false_type {};
+
+template <>
+struct Flag_word_predicate<std::equal_to<>> : std::true_type {
+    static auto combine(std::uint64_t a, std::uint64_t b, std::uint64_t values)
+        -> std::uint64_t
+    {
+        return (~a & ~b) | (a & b & values);
+    }
+};
+
+template <>
+struct Flag_word_predicate<std::less<>> : std::true_type {
+    static auto combine(std::uint64_t a, std::uint64_t b, std::uint64_t values)
+        -> std::uint64_t
+    {
+        return b & (~a | values);
+    }
+};
+
+template <typename Iterator>
+using Is_random_access = std::is_base_of<
+    std::random_access_iterator_tag,
+    typename std::iterator_traits<Iterator>::iterator_category>;
+
+// True if compare_n can use the flag word kernel: random access sequences of
+// Optional<T> with the same arithmetic or enum T, and a predicate above.
+template <typename Iterator1, typename Iterator2, typename Predicate>
+using Has_flag_word_kernel = std::integral_constant<
+    bool,
+    Flag_word_predicate<Predicate>::value &&
+        Is_random_access<Iterator1>::value &&
+        Is_random_access<Iterator2>::value &&
+        Owns_payloads<Iterator1>::value &&
+        std::is_same<
+            typename std::iterator_traits<Iterator1>::value_type,
+            typename std::iterator_traits<Iterator2>::value_type>::value &&
+        Is_flag_comparable<Payload_t<Iterator1>>::value>;
+
+template <typename Iterator1, typename Iterator2, typename Predicate>
+auto compare_n(Iterator1 a,
+               Iterator2 b,
+               std::size_t n,
+               std::uint64_t* out,
+               Predicate pred,
+               std::false_type) -> std::size_t
+{
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < n; i += word_bits) {
+        auto const end = std::min(n - i, word_bits);
+        std::uint64_t word = 0;
+        for (std::size_t j = 0; j < end; ++j, ++a, ++b)
+            word |= std::uint64_t{bool(pred(*a, *b))} << j;
+        *out++ = word;
+        count += popcount(word);
+    }
+    return count;
+}
+
+// Gathers the engaged flags of each block of 64 pairs into two words, then
+// applies the predicate only to the payloads of the pairs that are both
+// engaged, visiting their bits in order. No payload of an empty Optional is
+// read, and the only data dependent branch is the exit of the bit loop, once
+// per word rather than once per element.
+template <typename Iterator1, typename Iterator2, typename Predicate>
+auto compare_n(Iterator1 a,
+               Iterator2 b,
+               std::size_t n,
+               std::uint64_t* out,
+               Predicate pred,
+               std::true_type) -> std::size_t
+{
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < n; i += word_bits) {
+        auto const end = std::min(n - i, word_bits);
+        std::uint64_t a_flags = 0;
+        std::uint64_t b_flags = 0;
+        for (std::size_t j = 0; j < end; ++j) {
+            a_flags |= std::uint64_t{bool(a[j])} << j;
+            b_flags |= std::uint64_t{bool(b[j])} << j;
+        }
+        std::uint64_t values = 0;
+        for (auto both = a_flags & b_flags; both != 0; both &= both - 1) {
+            auto const j = static_cast<std::size_t>(countr_zero(both));
+            values |= std::uint64_t{bool(pred(*a[j], *b[j]))} << j;
+        }
+        auto const word =
+            Flag_word_predicate<Predicate>::combine(a_flags, b_flags, values) &
+            low_mask(end);
+        *out++ = word;
+        count += popcount(word);
+        a += end;
+        b += end;
+    }
+    return count;
+}
+
+}  // namespace detail
+
+/// \brief Moves the empty elements of [first, last) to the front in one pass.
+///
+/// The relative order of the engaged elements is not preserved.
+/// \returns An iterator to the first engaged element.
+template <typename Iterator>
+auto partition_empties(Iterator first, Iterator last) -> Iterator
+{
+    return std::partition(first, last,
+                          [](const auto& x) { return !bool(x); });
+}
+
+/// \brief Sorts a sequence of optionals into ascending order, empties first.
+///
+/// Only the engaged payloads are compared, with their operator<. Ranges of
+/// Optional<T> with integral or IEEE floating point T are radix sorted.
+/// Ranges of Optional<T&> are sorted by rebinding the references, so the
+/// referenced objects are never written.
+template <typename Iterator>
+auto sort(Iterator first, Iterator last) -> void
+{
+    auto const mid = opt::partition_empties(first, last);
+    detail::sort_values(mid, last, detail::Has_radix_sort<Iterator>{});
+}
+
+/// \brief Sorts a sequence of optionals, empties first, then the engaged
+/// elements ordered by comp(*x, *y).
+template <typename Iterator, typename Compare>
+auto sort(Iterator first, Iterator last, Compare comp) -> void
+{
+    auto const mid = opt::partition_empties(first, last);
+    detail::sort_engaged(mid, last, std::ref(comp));
+}
+
+/// \returns The first engaged element of a sorted sequence, found by binary
+/// search.
+template <typename Iterator>
+auto first_engaged(Iterator first, Iterator last) -> Iterator
+{
+    return std::partition_point(first, last,
+                                [](const auto& x) { return !bool(x); });
+}
+
+/// \brief Binary search in a sequence sorted as by opt::sort.
+///
+/// The engaged region is found first, so payloads are compared without
+/// checking flags.
+/// \returns The first element not less than \p value.
+template <typename Iterator, typename O>
+auto lower_bound(Iterator first, Iterator last, const O& value) -> Iterator
+{
+    if (!value)
+        return first;
+    return std::lower_bound(
+        opt::first_engaged(first, last), last, *value,
+        [](const auto& x, const auto& v) { return *x < v; });
+}
+
+/// \brief Binary search in a sequence sorted as by opt::sort.
+/// \returns The first element greater than \p value.
+template <typename Iterator, typename O>
+auto upper_bound(Iterator first, Iterator last, const O& value) -> Iterator
+{
+    auto const split = opt::first_engaged(first, last);
+    if (!value)
+        return split;
+    return std::upper_bound(
+        split, last, *value,
+        [](const auto& v, const auto& x) { return v < *x; });
+}
+
+/// \brief Binary search in a sequence sorted as by opt::sort.
+/// \returns The range of elements equal to \p value.
+template <typename Iterator, typename O>
+auto equal_range(Iterator first, Iterator last, const O& value)
+    -> std::pair<Iterator, Iterator>
+{
+    auto const split = opt::first_engaged(first, last);
+    if (!value)
+        return {first, split};
+    auto const lower = std::lower_bound(
+        split, last, *value,
+        [](const auto& x, const auto& v) { return *x < v; });
+    auto const upper = std::upper_bound(
+        lower, last, *value,
+        [](const auto& v, const auto& x) { return v < *x; });
+    return {lower, upper};
+}
+
+/// \brief Compares \p n pairs of optionals into a result bitmask.
+///
+/// Bit i of the mask, bit (i % 64) of out[i / 64], is set if pred(a[i], b[i]).
+/// \p out must have room for one word per 64 elements, bits past \p n are
+/// zero.
+///
+/// For random access sequences of Optional<T> with arithmetic or enum T, and
+/// std::equal_to<> or std::less<>, the flags of each 64 pairs are gathered
+/// into words first and the payloads are compared only where both are
+/// engaged, so there is no branch per element. Other inputs call \p pred on
+/// each pair.
+/// \returns The number of set bits.
+template <typename Iterator1, typename Iterator2, typename Predicate>
+auto compare_n(Iterator1 a,
+               Iterator2 b,
+               std::size_t n,
+               std::uint64_t* out,
+               Predicate pred) -> std::size_t
+{
+    return detail::compare_n(
+        std::move(a), std::move(b), n, out, std::move(pred),
+        detail::Has_flag_word_kernel<Iterator1, Iterator2, Predicate>{});
+}
+
+/// \brief Compares \p n pairs of optionals for equality into a bitmask.
+/// \sa compare_n(Iterator1, Iterator2, std::size_t, std::uint64_t*, Predicate)
+template <typename Iterator1, typename Iterator2>
+auto compare_n(Iterator1 a, Iterator2 b, std::size_t n, std::uint64_t* out)
+    -> std::size_t
+{
+    return opt::compare_n(a, b, n, out, std::equal_to<>{});
+}
+
+}  // namespace opt
+#endif  // OPTIONAL_ALGORITHM_HPP
@@ -0,0 +1,161 @@
+/// \file
+/// \brief Contains Aligned_optional, Padded_optional and Per_thread, for
+/// optionals with over-aligned payloads or that must not share cache lines.
+#ifndef OPTIONAL_ALIGNED_OPTIONAL_HPP
+#define OPTIONAL_ALIGNED_OPTIONAL_HPP
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include <optional/detail/cache_line.hpp>
+#include <optional/optional_value.hpp>
+
+namespace opt {
+
+namespace detail {
+
+// Allocates \p size bytes aligned to \p align, a power of two larger than
+// alignof(std::max_align_t). The pointer malloc returned is kept just below
+// the aligned block.
+inline auto aligned_allocate(std::size_t size, std::size_t align) -> void*
+{
+    void* const raw = std::malloc(size + align);
+    if (raw == nullptr)
+        throw std::bad_alloc();
+    auto const address =
+        (reinterpret_cast<std::uintptr_t>(raw) + align) & ~(align - 1);
+    auto const block = reinterpret_cast<void**>(address);
+    block[-1] = raw;
+    return block;
+}
+
+inline auto aligned_free(void* block) noexcept -> void
+{
+    if (block != nullptr)
+        std::free(static_cast<void**>(block)[-1]);
+}
+
+// Base giving over-aligned classes allocation functions that respect their
+// alignment. From C++17 the global operator new does this already.
+template <std::size_t Align,
+          bool Over_aligned = (Align > alignof(std::max_align_t))>
+struct Aligned_new {};
+
+#if !defined(__cpp_aligned_new)
+template <std::size_t Align>
+struct Aligned_new<Align, true> {
+    static auto operator new(std::size_t size) -> void*
+    {
+        return aligned_allocate(size, Align);
+    }
+
+    static auto operator new[](std::size_t size) -> void*
+    {
+        return aligned_allocate(size, Align);
+    }
+
+    static auto operator delete(void* p) noexcept -> void { aligned_free(p); }
+
+    static auto operator delete[](void* p) noexcept -> void
+    {
+        aligned_free(p);
+    }
+};
+#endif
+
+template <typename T>
+constexpr auto padded_alignment() -> std::size_t
+{
+    return alignof(T) > cache_line_size ? alignof(T) : cache_line_size;
+}
+
+}  // namespace detail
+
+/// \brief An Optional<T> whose payload is aligned to \p Align bytes.
+///
+/// The payload is the first member of Optional<T>, so aligning the whole
+/// object aligns the payload. sizeof is rounded up to a multiple of Align.
+/// Every Optional<T> operation is available, and an Aligned_optional
+/// converts to Optional<T> by copy or reference. new respects Align in every
+/// language version; containers need an allocator that does so before C++17.
+template <typename T, std::size_t Align>
+class alignas(Align) Aligned_optional : public Optional<T>,
+                                        public detail::Aligned_new<Align> {
+    static_assert(Align != 0 && (Align & (Align - 1)) == 0,
+                  "Align must be a power of two.");
+    static_assert(Align >= alignof(T), "Align must be at least alignof(T).");
+
+   public:
+    using Optional<T>::Optional;
+    using Optional<T>::operator=;
+
+    Aligned_optional() = default;
+
+    Aligned_optional(const Optional<T>& x) : Optional<T>(x) {}
+
+    Aligned_optional(Optional<T>&& x) : Optional<T>(std::move(x)) {}
+};
+
+/// \brief An Optional<T> that occupies whole cache lines of its own, so
+/// threads writing neighbouring instances do not false share.
+template <typename T>
+using Padded_optional = Aligned_optional<T, detail::padded_alignment<T>()>;
+
+/// \brief A fixed array of slots, one per worker, each on its own cache
+/// lines.
+///
+/// Typical use is one Per_thread<Optional<R>> of results, where worker i
+/// writes only slots[i] and the owner reads them after joining.
+///
+/// \code
+/// opt::Per_thread<opt::Optional<long>> results(workers);
+/// // In worker i:
+/// results[i] = compute(i);
+/// \endcode
+template <typename T>
+class Per_thread {
+    struct alignas(detail::padded_alignment<T>()) Slot
+        : detail::Aligned_new<detail::padded_alignment<T>()> {
+        T value;
+    };
+
+   public:
+    using Value_type = T;
+
+    /// Constructs \p n value initialized slots.
+    explicit Per_thread(std::size_t n) : slots_{new Slot[n]()}, size_{n} {}
+
+    auto size() const noexcept -> std::size_t { return size_; }
+
+    auto operator[](std::size_t i) -> T& { return slots_[i].value; }
+
+    auto operator[](std::size_t i) const -> const T&
+    {
+        return slots_[i].value;
+    }
+
+    /// Calls \p f on each slot in order.
+    template <typename F>
+    auto for_each(F f) -> void
+    {
+        for (std::size_t i = 0; i < size_; ++i)
+            f(slots_[i].value);
+    }
+
+    template <typename F>
+    auto for_each(F f) const -> void
+    {
+        for (std::size_t i = 0; i < size_; ++i)
+            f(static_cast<const T&>(slots_[i].value));
+    }
+
+   private:
+    std::unique_ptr<Slot[]> slots_;
+    std::size_t size_;
+};
+
+}  // namespace opt
+#endif  // OPTIONAL_ALIGNED_OPTIONAL_HPP
@@ -0,0 +1,117 @@
+/// \file
+/// \brief Calling a function with the values of several Optionals at once.
+///
+/// \code
+/// Optional<int> a = ..., b = ..., c = ...;
+/// Optional<int> sum = opt::apply([](int x, int y, int z) { return x + y + z; },
+///                                a, b, c);
+/// if (auto t = opt::zip(a, b))
+///     std::swap(std::get<0>(*t), std::get<1>(*t));
+/// \endcode
+///
+/// The engaged flags are added up and compared once, so there is a single
+/// branch however many Optionals are passed, instead of the chain of
+/// branches that a && b && c short circuits into.
+#ifndef OPTIONAL_APPLY_HPP
+#define OPTIONAL_APPLY_HPP
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <optional/detail/conjunction.hpp>
+#include <optional/none.hpp>
+#include <optional/optional_reference.hpp>
+#include <optional/optional_value.hpp>
+
+namespace opt {
+namespace detail {
+
+template <typename T>
+struct Is_optional : std::false_type {};
+
+template <typename T>
+struct Is_optional<Optional<T>> : std::true_type {};
+
+template <typename... Os>
+using Enable_optionals = std::enable_if_t<
+    Conjunction<Is_optional<std::decay_t<Os>>...>::value>;
+
+// Counts the engaged flags rather than and-ing them. GCC threads a jump on
+// a chain of ands back through it, recreating a branch per flag, but keeps
+// the comparison of a sum as one branch.
+template <typename... Os>
+auto all_engaged(const Os&... os) noexcept -> bool
+{
+    unsigned engaged = 0;
+    using Expand = unsigned[];
+    (void)Expand{0u, (engaged += static_cast<unsigned>(bool(os)))...};
+    return engaged == sizeof...(Os);
+}
+
+template <typename F, typename... Os>
+using Apply_result_t =
+    decltype(std::declval<F>()(*std::declval<Os>()...));
+
+// Lvalue references are returned as Optional references, anything else by
+// value.
+template <typename R>
+using Apply_optional_t =
+    Optional<std::conditional_t<std::is_lvalue_reference<R>::value,
+                                R,
+                                std::remove_cv_t<std::remove_reference_t<R>>>>;
+
+template <typename F, typename... Os>
+auto apply(std::true_type, F&& f, Os&&... os) -> bool
+{
+    if (!all_engaged(os...))
+        return false;
+    std::forward<F>(f)(*std::forward<Os>(os)...);
+    return true;
+}
+
+template <typename F, typename... Os>
+auto apply(std::false_type, F&& f, Os&&... os)
+    -> Apply_optional_t<Apply_result_t<F, Os...>>
+{
+    if (!all_engaged(os...))
+        return opt::none;
+    return std::forward<F>(f)(*std::forward<Os>(os)...);
+}
+
+}  // namespace detail
+
+/// \brief Calls \p f with the values of \p os if all of them are engaged.
+///
+/// Arguments are passed as *o, so Optional<T&> arguments pass their referent
+/// and Optional rvalues pass their value as an rvalue.
+/// \returns The result of \p f, or empty if any of \p os is empty. A result
+/// that is an lvalue reference is returned as an Optional reference. If \p f
+/// returns void, returns whether it was called.
+template <typename F,
+          typename... Os,
+          typename = detail::Enable_optionals<Os...>>
+auto apply(F&& f, Os&&... os) -> decltype(detail::apply(
+    std::is_void<detail::Apply_result_t<F, Os...>>{},
+    std::forward<F>(f),
+    std::forward<Os>(os)...))
+{
+    return detail::apply(std::is_void<detail::Apply_result_t<F, Os...>>{},
+                         std::forward<F>(f), std::forward<Os>(os)...);
+}
+
+/// \brief Combines several Optionals into one Optional tuple of references.
+/// \returns A tuple referring to the values of \p os, or empty if any of \p os
+/// is empty. References are const where the Optional is.
+template <typename... Os, typename = detail::Enable_optionals<Os...>>
+auto zip(Os&... os) -> Optional<std::tuple<decltype(*os)...>>
+{
+    if (!detail::all_engaged(os...))
+        return opt::none;
+    return std::tuple<decltype(*os)...>{*os...};
+}
+
+template <typename... Os>
+auto zip(const Os&&... os) -> void = delete;
+
+}  // namespace opt
+#endif  // OPTIONAL_APPLY_HPP
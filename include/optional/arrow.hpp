@@ -0,0 +1,321 @@
+/// \file
+/// \brief Zero copy exchange of optional columns through the Apache Arrow C
+/// Data Interface.
+///
+/// An Arrow primitive array is a validity bitmap plus a values buffer, the
+/// same layout as Optional_column. Exporting hands Arrow pointers to the
+/// column's own buffers, importing reads the Arrow buffers in place. No
+/// Arrow library is needed, the ArrowSchema and ArrowArray structs are
+/// declared here as in the specification.
+///
+/// \code
+/// opt::Optional_column<double> column = ...;
+/// ArrowArray array;
+/// ArrowSchema schema;
+/// opt::arrow::export_column(std::move(column), &array, &schema);
+/// // ... pass to an Arrow consumer, which calls the release callbacks.
+///
+/// if (auto view = opt::arrow::import_array<double>(array, schema)) {
+///     for (Optional<const double&> x : *view) { ... }
+/// }
+/// \endcode
+///
+/// Arrow bitmaps are little endian, which matches the validity words only on
+/// little endian targets.
+#ifndef OPTIONAL_ARROW_HPP
+#define OPTIONAL_ARROW_HPP
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include <optional/detail/bit_ops.hpp>
+#include <optional/none.hpp>
+#include <optional/optional_reference.hpp>
+#include <optional/optional_value.hpp>
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#error "optional/arrow.hpp requires a little endian target."
+#endif
+
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema {
+    const char* format;
+    const char* name;
+    const char* metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema** children;
+    struct ArrowSchema* dictionary;
+    void (*release)(struct ArrowSchema*);
+    void* private_data;
+};
+
+struct ArrowArray {
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void** buffers;
+    struct ArrowArray** children;
+    struct ArrowArray* dictionary;
+    void (*release)(struct ArrowArray*);
+    void* private_data;
+};
+
+#endif  // ARROW_C_DATA_INTERFACE
+
+namespace opt {
+namespace arrow {
+
+/// \returns The Arrow format string of the primitive type T, or nullptr if T
+/// has none.
+template <typename T>
+constexpr auto format_of() -> const char*
+{
+    using U = std::remove_cv_t<T>;
+    if (std::is_same<U, float>::value)
+        return "f";
+    if (std::is_same<U, double>::value)
+        return "g";
+    if (!std::is_integral<U>::value || std::is_same<U, bool>::value)
+        return nullptr;
+    bool const s = std::is_signed<U>::value;
+    switch (sizeof(U)) {
+        case 1: return s ? "c" : "C";
+        case 2: return s ? "s" : "S";
+        case 4: return s ? "i" : "I";
+        case 8: return s ? "l" : "L";
+        default: return nullptr;
+    }
+}
+
+namespace detail {
+
+// Keeps the exported buffers alive until the consumer releases the array.
+// Owner is the column itself for owning exports, a pointer for borrowing ones.
+template <typename Owner>
+struct Export_holder {
+    Owner owner;
+    const void* buffers[2];
+};
+
+template <typename Owner>
+auto release_array(ArrowArray* array) -> void
+{
+    delete static_cast<Export_holder<Owner>*>(array->private_data);
+    array->release = nullptr;
+}
+
+inline auto release_schema(ArrowSchema* schema) -> void
+{
+    schema->release = nullptr;
+}
+
+template <typename Layout>
+auto deref(const Layout& l) -> const Layout&
+{
+    return l;
+}
+
+template <typename Layout>
+auto deref(const Layout* l) -> const Layout&
+{
+    return *l;
+}
+
+template <typename Owner>
+auto export_impl(Owner owner, ArrowArray* array, ArrowSchema* schema) -> void
+{
+    auto holder = new Export_holder<Owner>{std::move(owner), {}};
+    auto const& column = deref(holder->owner);
+    using T = std::remove_const_t<std::remove_pointer_t<decltype(column.data())>>;
+    static_assert(format_of<T>() != nullptr,
+                  "Only arithmetic types other than bool export to Arrow.");
+    auto const size = column.size();
+    holder->buffers[0] = column.validity();
+    holder->buffers[1] = column.data();
+
+    array->length = static_cast<int64_t>(size);
+    array->null_count = static_cast<int64_t>(
+        size - opt::detail::count_bits(column.validity(), size));
+    array->offset = 0;
+    array->n_buffers = 2;
+    array->n_children = 0;
+    array->buffers = holder->buffers;
+    array->children = nullptr;
+    array->dictionary = nullptr;
+    array->release = &release_array<Owner>;
+    array->private_data = holder;
+
+    if (schema != nullptr) {
+        schema->format = format_of<T>();
+        schema->name = "";
+        schema->metadata = nullptr;
+        schema->flags = ARROW_FLAG_NULLABLE;
+        schema->n_children = 0;
+        schema->children = nullptr;
+        schema->dictionary = nullptr;
+        schema->release = &release_schema;
+        schema->private_data = nullptr;
+    }
+}
+
+}  // namespace detail
+
+/// \brief Exports a bitmap layout, such as Optional_column, by reference.
+///
+/// \p array points into \p column's buffers, so \p column must not be
+/// modified or destroyed until the array is released.
+/// \param schema Filled in if not null.
+template <typename Layout>
+auto export_column(const Layout& column, ArrowArray* array, ArrowSchema* schema)
+    -> void
+{
+    detail::export_impl(&column, array, schema);
+}
+
+/// \brief Exports a bitmap layout, such as Optional_column, moving it into
+/// the exported array.
+///
+/// The buffers are moved, not copied, and are freed when the consumer
+/// releases the array.
+/// \param schema Filled in if not null.
+template <typename Layout,
+          typename = std::enable_if_t<!std::is_lvalue_reference<Layout>::value>>
+auto export_column(Layout&& column, ArrowArray* array, ArrowSchema* schema)
+    -> void
+{
+    detail::export_impl(std::move(column), array, schema);
+}
+
+/// \brief A read only view of an Arrow primitive array as a sequence of
+/// Optional<const T&>.
+///
+/// The view does not take ownership, the array must stay alive and
+/// unreleased while the view is in use.
+template <typename T>
+class Array_view {
+   public:
+    class Iterator;
+
+    using Value_type = T;
+
+    /// \brief Views \p array, whose type must be known to be T.
+    /// \sa import_array
+    explicit Array_view(const ArrowArray& array)
+        : validity_{static_cast<const std::uint8_t*>(array.buffers[0])},
+          values_{static_cast<const T*>(array.buffers[1])},
+          offset_{static_cast<std::size_t>(array.offset)},
+          size_{static_cast<std::size_t>(array.length)}
+    {}
+
+    auto size() const noexcept -> std::size_t { return size_; }
+
+    auto empty() const noexcept -> bool { return size_ == 0; }
+
+    /// \returns True if element \p i is not null.
+    auto is_engaged(std::size_t i) const noexcept -> bool
+    {
+        auto const bit = offset_ + i;
+        return validity_ == nullptr || ((validity_[bit / 8] >> (bit % 8)) & 1u);
+    }
+
+    /// \returns The number of elements that are not null.
+    auto count_engaged() const noexcept -> std::size_t
+    {
+        if (validity_ == nullptr)
+            return size_;
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < size_; ++i)
+            count += this->is_engaged(i);
+        return count;
+    }
+
+    /// \returns A reference to element \p i, or empty if it is null.
+    auto operator[](std::size_t i) const -> Optional<const T&>
+    {
+        return {this->is_engaged(i), values_[offset_ + i]};
+    }
+
+    /// \returns The first element's slot in the values buffer.
+    auto values() const noexcept -> const T* { return values_ + offset_; }
+
+    auto begin() const -> Iterator { return {this, 0}; }
+    auto end() const -> Iterator { return {this, size_}; }
+
+   private:
+    const std::uint8_t* validity_;
+    const T* values_;
+    std::size_t offset_;
+    std::size_t size_;
+};
+
+/// Presents an Array_view as a sequence of Optional<const T&>.
+template <typename T>
+class Array_view<T>::Iterator {
+   public:
+    using value_type = Optional<const T&>;
+    using reference = Optional<const T&>;
+    using pointer = void;
+    using difference_type = std::ptrdiff_t;
+    using iterator_category = std::input_iterator_tag;
+
+    Iterator() = default;
+
+    Iterator(const Array_view* view, std::size_t i) : view_{view}, i_{i} {}
+
+    auto operator*() const -> reference { return (*view_)[i_]; }
+
+    auto operator++() -> Iterator&
+    {
+        ++i_;
+        return *this;
+    }
+
+    auto operator++(int) -> Iterator
+    {
+        auto copy = *this;
+        ++i_;
+        return copy;
+    }
+
+    auto operator==(const Iterator& x) const -> bool { return i_ == x.i_; }
+
+    auto operator!=(const Iterator& x) const -> bool { return i_ != x.i_; }
+
+   private:
+    const Array_view* view_{nullptr};
+    std::size_t i_{0};
+};
+
+/// \brief Views an Arrow array as a sequence of Optional<const T&>.
+/// \returns The view, or empty if \p schema is not a primitive array of T or
+/// either struct has been released.
+template <typename T>
+auto import_array(const ArrowArray& array, const ArrowSchema& schema)
+    -> Optional<Array_view<T>>
+{
+    static_assert(format_of<T>() != nullptr,
+                  "Only arithmetic types other than bool import from Arrow.");
+    if (array.release == nullptr || schema.release == nullptr ||
+        schema.format == nullptr ||
+        std::strcmp(schema.format, format_of<T>()) != 0 ||
+        array.n_buffers != 2 || array.n_children != 0 || array.length < 0 ||
+        array.offset < 0 || (array.length > 0 && array.buffers[1] == nullptr))
+        return opt::none;
+    return Array_view<T>{array};
+}
+
+}  // namespace arrow
+}  // namespace opt
+#endif  // OPTIONAL_ARROW_HPP
@@ -0,0 +1,172 @@
+/// \file
+/// \brief Checks that Optional has the layout declared in optional_c.h and
+/// views arrays of Optional as arrays of the C structs, and back, in place.
+///
+/// \code
+/// std::vector<opt::Optional<double>> xs = ...;
+/// const opt_optional_double* c = opt::c_abi::as_c(xs.data());
+/// rust_consume(c, xs.size());
+/// \endcode
+///
+/// The casts rely on the layouts matching, which this header checks for
+/// every type it maps. OPTIONAL_C_ABI_MAP(name, T) adds the mapping, and
+/// the same checks, for a struct declared with OPT_C_DEFINE_OPTIONAL.
+#ifndef OPTIONAL_C_ABI_HPP
+#define OPTIONAL_C_ABI_HPP
+#include <cstddef>
+#include <type_traits>
+
+#include <optional/optional_c.h>
+#include <optional/optional_reference.hpp>
+#include <optional/optional_value.hpp>
+
+#if defined(__has_include)
+#if __has_include(<version>)
+#include <version>
+#endif
+#endif
+#if defined(__cpp_lib_bit_cast)
+#include <bit>
+#endif
+
+namespace opt {
+namespace detail {
+
+template <typename T>
+struct Optional_layout {
+    static constexpr std::size_t value_offset = offsetof(Optional<T>, storage_);
+    static constexpr std::size_t engaged_offset =
+        offsetof(Optional<T>, initialized_);
+};
+
+template <>
+struct Optional_layout<bool> {
+    static constexpr std::size_t state_offset =
+        offsetof(Optional<bool>, storage_);
+    static constexpr unsigned char empty_byte = Optional<bool>::empty_byte;
+};
+
+}  // namespace detail
+
+namespace c_abi {
+
+/// Maps T to the C struct with the layout of Optional<T>.
+template <typename T>
+struct C_optional;
+
+template <typename T>
+using C_optional_t = typename C_optional<T>::type;
+
+/// Maps a C struct back to the payload type of its Optional.
+template <typename C>
+struct Payload_of;
+
+template <typename C>
+using Payload_of_t = typename Payload_of<C>::type;
+
+/// \returns \p xs viewed as an array of the C structs.
+template <typename T>
+auto as_c(const Optional<T>* xs) noexcept -> const C_optional_t<T>*
+{
+    return reinterpret_cast<const C_optional_t<T>*>(xs);
+}
+
+template <typename T>
+auto as_c(Optional<T>* xs) noexcept -> C_optional_t<T>*
+{
+    return reinterpret_cast<C_optional_t<T>*>(xs);
+}
+
+/// \returns \p xs viewed as an array of Optional.
+template <typename C>
+auto from_c(const C* xs) noexcept -> const Optional<Payload_of_t<C>>*
+{
+    return reinterpret_cast<const Optional<Payload_of_t<C>>*>(xs);
+}
+
+template <typename C>
+auto from_c(C* xs) noexcept -> Optional<Payload_of_t<C>>*
+{
+    return reinterpret_cast<Optional<Payload_of_t<C>>*>(xs);
+}
+
+/// \returns \p xs viewed as an array of nullable pointers.
+template <typename T>
+auto as_c(const Optional<T&>* xs) noexcept -> T* const*
+{
+    return reinterpret_cast<T* const*>(xs);
+}
+
+/// \returns \p ps, nullable pointers, viewed as an array of Optional<T&>.
+template <typename T>
+auto from_c(T* const* ps) noexcept -> const Optional<T&>*
+{
+    return reinterpret_cast<const Optional<T&>*>(ps);
+}
+
+inline auto as_c(const Optional<bool>* xs) noexcept -> const opt_optional_bool*
+{
+    return reinterpret_cast<const opt_optional_bool*>(xs);
+}
+
+inline auto from_c(const opt_optional_bool* xs) noexcept
+    -> const Optional<bool>*
+{
+    return reinterpret_cast<const Optional<bool>*>(xs);
+}
+
+}  // namespace c_abi
+}  // namespace opt
+
+/// \brief Maps Optional<T> to the C struct NAME and checks their layouts
+/// match. Use at global scope.
+#define OPTIONAL_C_ABI_MAP(NAME, T)                                          \
+    template <>                                                              \
+    struct opt::c_abi::C_optional<T> {                                       \
+        using type = NAME;                                                   \
+    };                                                                       \
+    template <>                                                              \
+    struct opt::c_abi::Payload_of<NAME> {                                    \
+        using type = T;                                                      \
+    };                                                                       \
+    static_assert(std::is_trivially_copyable<T>::value &&                    \
+                      std::is_standard_layout<T>::value,                     \
+                  #T " must be trivially copyable and standard layout.");    \
+    static_assert(std::is_standard_layout<opt::Optional<T>>::value,          \
+                  "Optional<" #T "> must be standard layout.");              \
+    static_assert(sizeof(opt::Optional<T>) == sizeof(NAME),                  \
+                  "Optional<" #T "> and " #NAME " differ in size.");         \
+    static_assert(alignof(opt::Optional<T>) == alignof(NAME),                \
+                  "Optional<" #T "> and " #NAME " differ in alignment.");    \
+    static_assert(opt::detail::Optional_layout<T>::value_offset ==           \
+                      offsetof(NAME, value),                                 \
+                  "Optional<" #T "> and " #NAME " differ in value offset."); \
+    static_assert(opt::detail::Optional_layout<T>::engaged_offset ==         \
+                      offsetof(NAME, engaged),                               \
+                  "Optional<" #T "> and " #NAME " differ in flag offset.");
+
+OPT_C_ARITHMETIC_TYPES(OPTIONAL_C_ABI_MAP)
+
+static_assert(sizeof(bool) == 1, "The C ABI needs a one byte bool.");
+static_assert(sizeof(opt::Optional<bool>) == sizeof(opt_optional_bool),
+              "Optional<bool> and opt_optional_bool differ in size.");
+static_assert(opt::detail::Optional_layout<bool>::state_offset ==
+                  offsetof(opt_optional_bool, state),
+              "Optional<bool> and opt_optional_bool differ in state offset.");
+static_assert(opt::detail::Optional_layout<bool>::empty_byte ==
+                  OPT_C_BOOL_EMPTY,
+              "Optional<bool> and OPT_C_BOOL_EMPTY differ in the empty byte.");
+#if defined(__cpp_lib_bit_cast)
+// An engaged Optional<bool> holds a bool object, so the C side's 0 and 1 are
+// the object representations of false and true.
+static_assert(std::bit_cast<unsigned char>(false) == 0 &&
+                  std::bit_cast<unsigned char>(true) == 1,
+              "opt_optional_bool needs bool represented as 0 and 1.");
+#endif
+static_assert(sizeof(opt::Optional<int&>) == sizeof(int*) &&
+                  alignof(opt::Optional<int&>) == alignof(int*),
+              "Optional<T&> must have the layout of T*.");
+static_assert(std::is_standard_layout<opt::Optional<int&>>::value,
+              "Optional<T&> must be standard layout.");
+
+#endif  // OPTIONAL_C_ABI_HPP
@@ -0,0 +1,304 @@
+/// \file
+/// \brief Integer arithmetic and numeric conversions that return an empty
+/// Optional instead of overflowing or losing information.
+///
+/// \code
+/// auto const total = opt::checked_add(a, b);  // Optional<int>
+/// auto const byte = opt::narrow<std::uint8_t>(total.value_or(-1));
+/// \endcode
+///
+/// With GCC and Clang the checks are the compiler's overflow builtins, which
+/// compile to the arithmetic instruction followed by a test of its overflow
+/// or carry flag.
+#ifndef OPTIONAL_CHECKED_HPP
+#define OPTIONAL_CHECKED_HPP
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include <optional/detail/bit_ops.hpp>
+#include <optional/none.hpp>
+#include <optional/optional_value.hpp>
+
+namespace opt {
+namespace detail {
+
+template <typename T>
+using Enable_checked = std::enable_if_t<std::is_integral<T>::value &&
+                                            !std::is_same<T, bool>::value,
+                                        Optional<T>>;
+
+template <typename T>
+auto is_negative(T x, std::true_type) -> bool
+{
+    return x < T{0};
+}
+
+template <typename T>
+auto is_negative(T, std::false_type) -> bool
+{
+    return false;
+}
+
+template <typename T>
+auto is_negative(T x) -> bool
+{
+    return is_negative(x, std::is_signed<T>{});
+}
+
+// Each stores the wrapped result in r and returns true on overflow.
+
+template <typename T>
+auto add_overflow(T x, T y, T& r) -> bool
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_add_overflow(x, y, &r);
+#else
+    using U = std::make_unsigned_t<T>;
+    r = static_cast<T>(static_cast<U>(x) + static_cast<U>(y));
+    if (std::is_signed<T>::value)
+        return y > 0 ? x > std::numeric_limits<T>::max() - y
+                     : x < std::numeric_limits<T>::min() - y;
+    return static_cast<U>(r) < static_cast<U>(x);
+#endif
+}
+
+template <typename T>
+auto sub_overflow(T x, T y, T& r) -> bool
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_sub_overflow(x, y, &r);
+#else
+    using U = std::make_unsigned_t<T>;
+    r = static_cast<T>(static_cast<U>(x) - static_cast<U>(y));
+    if (std::is_signed<T>::value)
+        return y > 0 ? x < std::numeric_limits<T>::min() + y
+                     : x > std::numeric_limits<T>::max() + y;
+    return x < y;
+#endif
+}
+
+template <typename T>
+auto mul_overflow(T x, T y, T& r) -> bool
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_mul_overflow(x, y, &r);
+#else
+    using U = std::make_unsigned_t<T>;
+    using L = std::numeric_limits<T>;
+    r = static_cast<T>(static_cast<U>(x) * static_cast<U>(y));
+    if (!std::is_signed<T>::value)
+        return x != 0 && r / x != y;
+    if (x > 0)
+        return y > 0 ? x > L::max() / y : y < L::min() / x;
+    if (x < 0)
+        return y > 0 ? x < L::min() / y : y < L::max() / x;
+    return false;
+#endif
+}
+
+// Converts x to To when the value is preserved, returns false otherwise.
+
+template <typename To, typename From>
+auto narrow_into(From x, To& r, std::true_type, std::true_type) -> bool
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return !__builtin_add_overflow(x, From{0}, &r);
+#else
+    r = static_cast<To>(x);
+    return static_cast<From>(r) == x && is_negative(x) == is_negative(r);
+#endif
+}
+
+// Floating point to integer, in range and with no fractional part.
+template <typename To, typename From>
+auto narrow_into(From x, To& r, std::true_type, std::false_type) -> bool
+{
+    From const upper = std::ldexp(From{1}, std::numeric_limits<To>::digits);
+    From const lower = std::is_signed<To>::value ? -upper : From{0};
+    if (!(x >= lower && x < upper))
+        return false;
+    r = static_cast<To>(x);
+    return static_cast<From>(r) == x;
+}
+
+// Integer to floating point, exactly representable.
+template <typename To, typename From>
+auto narrow_into(From x, To& r, std::false_type, std::true_type) -> bool
+{
+    r = static_cast<To>(x);
+    From back;
+    return narrow_into(r, back, std::true_type{}, std::false_type{}) &&
+           back == x;
+}
+
+// Floating point to floating point, exactly representable or NaN.
+template <typename To, typename From>
+auto narrow_into(From x, To& r, std::false_type, std::false_type) -> bool
+{
+    if (std::isnan(x)) {
+        r = std::numeric_limits<To>::quiet_NaN();
+        return true;
+    }
+    if (std::isinf(x)) {
+        r = static_cast<To>(x);
+        return true;
+    }
+    if (std::fabs(x) > static_cast<From>(std::numeric_limits<To>::max()) &&
+        sizeof(From) > sizeof(To))
+        return false;
+    r = static_cast<To>(x);
+    return static_cast<From>(r) == x;
+}
+
+// Applies the overflow check f to n pairs, writing results and a validity
+// bitmap laid out as in Optional_column.
+template <typename T, typename F>
+auto checked_span(const T* x,
+                  const T* y,
+                  std::size_t n,
+                  T* out,
+                  std::uint64_t* validity,
+                  F f) -> std::size_t
+{
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < n; i += word_bits) {
+        auto const end = n - i < word_bits ? n - i : word_bits;
+        std::uint64_t word = 0;
+        for (std::size_t j = 0; j < end; ++j) {
+            T r;
+            bool const overflow = f(x[i + j], y[i + j], r);
+            out[i + j] = overflow ? T{} : r;
+            word |= std::uint64_t{!overflow} << j;
+        }
+        validity[i / word_bits] = word;
+        count += static_cast<std::size_t>(popcount(word));
+    }
+    return count;
+}
+
+}  // namespace detail
+
+/// \returns x + y, or empty if the result overflows T.
+template <typename T>
+auto checked_add(T x, T y) -> detail::Enable_checked<T>
+{
+    T r;
+    return {!detail::add_overflow(x, y, r), r};
+}
+
+/// \returns x - y, or empty if the result overflows T.
+template <typename T>
+auto checked_sub(T x, T y) -> detail::Enable_checked<T>
+{
+    T r;
+    return {!detail::sub_overflow(x, y, r), r};
+}
+
+/// \returns x * y, or empty if the result overflows T.
+template <typename T>
+auto checked_mul(T x, T y) -> detail::Enable_checked<T>
+{
+    T r;
+    return {!detail::mul_overflow(x, y, r), r};
+}
+
+/// \returns x / y, or empty if y is zero or the quotient overflows T.
+template <typename T>
+auto checked_div(T x, T y) -> detail::Enable_checked<T>
+{
+    if (y == 0 || (std::is_signed<T>::value && y == T(-1) &&
+                   x == std::numeric_limits<T>::min()))
+        return opt::none;
+    return static_cast<T>(x / y);
+}
+
+/// \returns -x, or empty if it is not representable in T.
+template <typename T>
+auto checked_neg(T x) -> detail::Enable_checked<T>
+{
+    return checked_sub(T{0}, x);
+}
+
+/// \returns x << n, or empty if n is out of range for T, x is negative, or
+/// any set bit would be shifted out or into the sign bit.
+template <typename T>
+auto checked_shl(T x, int n) -> detail::Enable_checked<T>
+{
+    using U = std::make_unsigned_t<T>;
+    int const bits = std::numeric_limits<U>::digits;
+    if (n < 0 || n >= bits || detail::is_negative(x))
+        return opt::none;
+    U const r = static_cast<U>(static_cast<U>(x) << n);
+    bool const fits = (r >> n) == static_cast<U>(x) &&
+                      r <= static_cast<U>(std::numeric_limits<T>::max());
+    return {fits, static_cast<T>(r)};
+}
+
+/// \brief Converts \p x to an arithmetic type To.
+/// \returns The converted value, or empty if it does not represent the same
+/// value as \p x. NaN and infinities narrow between floating point types.
+template <typename To, typename From>
+auto narrow(From x) -> Optional<To>
+{
+    static_assert(std::is_arithmetic<To>::value &&
+                      std::is_arithmetic<From>::value &&
+                      !std::is_same<To, bool>::value &&
+                      !std::is_same<From, bool>::value,
+                  "narrow converts between non-bool arithmetic types.");
+    To r{};
+    return {detail::narrow_into(x, r, std::is_integral<To>{},
+                                std::is_integral<From>{}),
+            r};
+}
+
+/// \brief Checked x[i] + y[i] for \p n elements.
+///
+/// out[i] is the sum, or a value initialized T where it overflows. The
+/// validity bitmap, one word per 64 elements as in Optional_column, marks the
+/// elements that did not overflow.
+/// \returns The number of elements that did not overflow.
+template <typename T>
+auto checked_add(const T* x,
+                 const T* y,
+                 std::size_t n,
+                 T* out,
+                 std::uint64_t* validity) -> std::size_t
+{
+    return detail::checked_span(x, y, n, out, validity, [](T a, T b, T& r) {
+        return detail::add_overflow(a, b, r);
+    });
+}
+
+/// \brief Checked x[i] - y[i] for \p n elements.
+/// \sa checked_add(const T*, const T*, std::size_t, T*, std::uint64_t*)
+template <typename T>
+auto checked_sub(const T* x,
+                 const T* y,
+                 std::size_t n,
+                 T* out,
+                 std::uint64_t* validity) -> std::size_t
+{
+    return detail::checked_span(x, y, n, out, validity, [](T a, T b, T& r) {
+        return detail::sub_overflow(a, b, r);
+    });
+}
+
+/// \brief Checked x[i] * y[i] for \p n elements.
+/// \sa checked_add(const T*, const T*, std::size_t, T*, std::uint64_t*)
+template <typename T>
+auto checked_mul(const T* x,
+                 const T* y,
+                 std::size_t n,
+                 T* out,
+                 std::uint64_t* validity) -> std::size_t
+{
+    return detail::checked_span(x, y, n, out, validity, [](T a, T b, T& r) {
+        return detail::mul_overflow(a, b, r);
+    });
+}
+
+}  // namespace opt
+#endif  // OPTIONAL_CHECKED_HPP
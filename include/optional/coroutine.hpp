@@ -0,0 +1,274 @@
+/// \file
+/// \brief Lets Optional<T> be used as a C++20 coroutine return type.
+///
+/// Inside such a coroutine, `co_await` on an Optional yields the held value,
+/// or returns opt::none from the whole coroutine if the Optional is empty.
+/// This replaces chains of `if (!x) return opt::none;`.
+///
+/// \code
+/// Optional<int> sum(Optional<int> a, Optional<int> b) {
+///     co_return co_await a + co_await b;
+/// }
+/// \endcode
+///
+/// Only available when the compiler supports coroutines, otherwise this header
+/// is empty.
+#ifndef OPTIONAL_COROUTINE_HPP
+#define OPTIONAL_COROUTINE_HPP
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#define OPTIONAL_HAS_COROUTINES 1
+#endif
+#endif
+
+#if defined(OPTIONAL_HAS_COROUTINES)
+#include <coroutine>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include <optional/detail/result_sink.hpp>
+#include <optional/none.hpp>
+#include <optional/optional_value.hpp>
+
+namespace opt {
+namespace detail {
+
+/// \brief Thread local stack allocator for Optional coroutine frames.
+///
+/// An Optional coroutine never suspends past its own return, so frames on a
+/// thread are always released in reverse order of allocation. Frames are
+/// bumped off a fixed buffer, falling back to the global operator new when
+/// the buffer is exhausted.
+class Coroutine_frame_arena {
+   public:
+    static constexpr std::size_t capacity = 16 * 1024;
+    static constexpr std::size_t alignment = alignof(std::max_align_t);
+
+    /// Return the arena for the calling thread.
+    static auto local() noexcept -> Coroutine_frame_arena&
+    {
+        thread_local Coroutine_frame_arena arena;
+        return arena;
+    }
+
+    auto allocate(std::size_t size) -> void*
+    {
+        auto const rounded = round_up(size);
+        if (capacity - top_ < rounded)
+            return ::operator new(size);
+        void* p = buffer_ + top_;
+        top_ += rounded;
+        return p;
+    }
+
+    auto deallocate(void* p, std::size_t size) noexcept -> void
+    {
+        if (!this->owns(p)) {
+            ::operator delete(p);
+            return;
+        }
+        top_ -= round_up(size);
+    }
+
+    /// \returns True if \p p points into the arena buffer.
+    auto owns(const void* p) const noexcept -> bool
+    {
+        auto const* c = static_cast<const unsigned char*>(p);
+        return c >= buffer_ && c < buffer_ + capacity;
+    }
+
+    /// \returns The number of bytes currently handed out from the buffer.
+    auto used() const noexcept -> std::size_t { return top_; }
+
+   private:
+    alignas(alignment) unsigned char buffer_[capacity];
+    std::size_t top_{0};
+
+    static constexpr auto round_up(std::size_t size) -> std::size_t
+    {
+        return (size + alignment - 1) & ~(alignment - 1);
+    }
+};
+
+template <typename T>
+class Optional_promise;
+
+/// \brief Object returned from Optional_promise::get_return_object().
+///
+/// Compilers differ on whether the return object is converted to the
+/// coroutine's return type before the body runs or after it completes, both
+/// are handled. When conversion is deferred the result is written into
+/// result_, otherwise directly into the Optional produced by the conversion.
+template <typename T>
+class Optional_return_object {
+   public:
+    explicit Optional_return_object(Optional_promise<T>& promise) noexcept
+        : promise_{&promise}
+    {
+        promise_->bind(*this);
+    }
+
+    Optional_return_object(Optional_return_object&& other) noexcept
+        : promise_{other.promise_},
+          result_{std::move(other.result_)}
+    {
+        other.promise_ = nullptr;
+        if (promise_ != nullptr)
+            promise_->bind(*this);
+    }
+
+    Optional_return_object(const Optional_return_object&) = delete;
+    auto operator=(const Optional_return_object&)
+        -> Optional_return_object& = delete;
+
+    ~Optional_return_object()
+    {
+        if (promise_ != nullptr)
+            promise_->unbind(*this);
+    }
+
+    operator Optional<T>()
+    {
+        if (promise_ != nullptr)  // Eager conversion, body has not yet run.
+            return Optional<T>{Result_sink_tag{}, *promise_};
+        return std::move(result_);
+    }
+
+   private:
+    Optional_promise<T>* promise_;
+    Optional<T> result_;
+
+    friend class Optional_promise<T>;
+};
+
+/// Awaiter that resumes with the value of an engaged Optional, or destroys
+/// the awaiting coroutine, leaving its result empty.
+template <typename Optional_ref>
+class Optional_awaiter {
+   public:
+    explicit Optional_awaiter(Optional_ref opt) noexcept
+        : opt_{std::addressof(opt)}
+    {}
+
+    auto await_ready() const noexcept -> bool { return bool(*opt_); }
+
+    auto await_suspend(std::coroutine_handle<> handle) const noexcept -> void
+    {
+        handle.destroy();
+    }
+
+    auto await_resume() const -> decltype(*std::declval<Optional_ref>())
+    {
+        return *static_cast<Optional_ref>(*opt_);
+    }
+
+   private:
+    std::remove_reference_t<Optional_ref>* opt_;
+};
+
+/// \brief Promise type for coroutines returning Optional<T>.
+///
+/// The coroutine never suspends except to short-circuit on an empty
+/// Optional, at which point its frame is destroyed. Frames are allocated from
+/// the thread's Coroutine_frame_arena.
+template <typename T>
+class Optional_promise {
+    static_assert(!std::is_reference<T>::value,
+                  "Optional<T&> is not supported as a coroutine return type.");
+
+   public:
+    Optional_promise() = default;
+    Optional_promise(const Optional_promise&) = delete;
+    auto operator=(const Optional_promise&) -> Optional_promise& = delete;
+
+    ~Optional_promise()
+    {
+        if (return_object_ != nullptr)
+            return_object_->promise_ = nullptr;
+    }
+
+    static auto operator new(std::size_t size) -> void*
+    {
+        return Coroutine_frame_arena::local().allocate(size);
+    }
+
+    static auto operator delete(void* p, std::size_t size) noexcept -> void
+    {
+        Coroutine_frame_arena::local().deallocate(p, size);
+    }
+
+    auto get_return_object() noexcept -> Optional_return_object<T>
+    {
+        return Optional_return_object<T>{*this};
+    }
+
+    auto initial_suspend() const noexcept -> std::suspend_never { return {}; }
+
+    auto final_suspend() const noexcept -> std::suspend_never { return {}; }
+
+    template <typename U>
+    auto return_value(U&& value) -> void
+    {
+        *result_ = std::forward<U>(value);
+    }
+
+    /// Exceptions leave the coroutine and propagate to the caller.
+    [[noreturn]] auto unhandled_exception() const -> void { throw; }
+
+    template <typename U>
+    auto await_transform(Optional<U>& opt) const noexcept
+        -> Optional_awaiter<Optional<U>&>
+    {
+        return Optional_awaiter<Optional<U>&>{opt};
+    }
+
+    template <typename U>
+    auto await_transform(const Optional<U>& opt) const noexcept
+        -> Optional_awaiter<const Optional<U>&>
+    {
+        return Optional_awaiter<const Optional<U>&>{opt};
+    }
+
+    template <typename U>
+    auto await_transform(Optional<U>&& opt) const noexcept
+        -> Optional_awaiter<Optional<U>&&>
+    {
+        return Optional_awaiter<Optional<U>&&>{std::move(opt)};
+    }
+
+    /// Directs the coroutine's result into \p result.
+    auto bind(Optional<T>& result) noexcept -> void { result_ = &result; }
+
+    auto bind(Optional_return_object<T>& object) noexcept -> void
+    {
+        return_object_ = &object;
+        result_ = &object.result_;
+    }
+
+    auto unbind(Optional_return_object<T>& object) noexcept -> void
+    {
+        if (return_object_ == &object)
+            return_object_ = nullptr;
+    }
+
+   private:
+    Optional<T>* result_{nullptr};
+    Optional_return_object<T>* return_object_{nullptr};
+};
+
+}  // namespace detail
+}  // namespace opt
+
+namespace std {
+
+template <typename T, typename... Args>
+struct coroutine_traits<opt::Optional<T>, Args...> {
+    using promise_type = opt::detail::Optional_promise<T>;
+};
+
+}  // namespace std
+
+#endif  // defined(OPTIONAL_HAS_COROUTINES)
+#endif  // OPTIONAL_COROUTINE_HPP
@@ -0,0 +1,97 @@
+#ifndef OPTIONAL_DETAIL_BIT_OPS_HPP
+#define OPTIONAL_DETAIL_BIT_OPS_HPP
+#include <cstddef>
+#include <cstdint>
+
+namespace opt {
+namespace detail {
+
+// Validity bitmaps are stored as 64 bit words, bit i of the bitmap is bit
+// (i % 64) of word (i / 64). Bits past the logical size are kept zero.
+constexpr std::size_t word_bits = 64;
+
+// Number of words needed to hold \p bits bits.
+constexpr auto words_for(std::size_t bits) -> std::size_t
+{
+    return (bits + word_bits - 1) / word_bits;
+}
+
+// Mask with the lowest \p n bits set, n in [0, 64].
+constexpr auto low_mask(std::size_t n) -> std::uint64_t
+{
+    return n >= word_bits ? ~std::uint64_t{0} : (std::uint64_t{1} << n) - 1;
+}
+
+inline auto test_bit(const std::uint64_t* words, std::size_t i) -> bool
+{
+    return (words[i / word_bits] >> (i % word_bits)) & 1u;
+}
+
+inline auto set_bit(std::uint64_t* words, std::size_t i) -> void
+{
+    words[i / word_bits] |= std::uint64_t{1} << (i % word_bits);
+}
+
+inline auto clear_bit(std::uint64_t* words, std::size_t i) -> void
+{
+    words[i / word_bits] &= ~(std::uint64_t{1} << (i % word_bits));
+}
+
+inline auto popcount(std::uint64_t x) -> int
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555u);
+    x = (x & 0x3333333333333333u) + ((x >> 2) & 0x3333333333333333u);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0Fu;
+    return static_cast<int>((x * 0x0101010101010101u) >> 56);
+#endif
+}
+
+// Index of the lowest set bit, \p x must not be zero.
+inline auto countr_zero(std::uint64_t x) -> int
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#else
+    return popcount((x & (~x + 1)) - 1);
+#endif
+}
+
+// Number of set bits in the first \p n bits of \p words.
+inline auto count_bits(const std::uint64_t* words, std::size_t n)
+    -> std::size_t
+{
+    std::size_t count = 0;
+    auto const full = n / word_bits;
+    for (std::size_t w = 0; w < full; ++w)
+        count += popcount(words[w]);
+    if (n % word_bits != 0)
+        count += popcount(words[full] & low_mask(n % word_bits));
+    return count;
+}
+
+// Index of the first set bit at or after \p i in the first \p n bits of
+// \p words, or \p n if there is none. Empty words are skipped whole.
+inline auto next_set_bit(const std::uint64_t* words,
+                         std::size_t i,
+                         std::size_t n) -> std::size_t
+{
+    if (i >= n)
+        return n;
+    auto w = i / word_bits;
+    auto const last = words_for(n);
+    auto word = words[w] & ~low_mask(i % word_bits);
+    while (word == 0) {
+        if (++w == last)
+            return n;
+        word = words[w];
+    }
+    auto const found = w * word_bits + countr_zero(word);
+    return found < n ? found : n;
+}
+
+}  // namespace detail
+}  // namespace opt
+#endif  // OPTIONAL_DETAIL_BIT_OPS_HPP
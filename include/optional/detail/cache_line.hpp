@@ -0,0 +1,16 @@
+#ifndef OPTIONAL_DETAIL_CACHE_LINE_HPP
+#define OPTIONAL_DETAIL_CACHE_LINE_HPP
+#include <cstddef>
+
+namespace opt {
+
+/// \brief Smallest distance, in bytes, between two objects written by
+/// different threads that keeps them off the same cache line.
+#if defined(__APPLE__) && defined(__aarch64__)
+constexpr std::size_t cache_line_size = 128;
+#else
+constexpr std::size_t cache_line_size = 64;
+#endif
+
+}  // namespace opt
+#endif  // OPTIONAL_DETAIL_CACHE_LINE_HPP
@@ -0,0 +1,20 @@
+#ifndef OPTIONAL_DETAIL_RESULT_SINK_HPP
+#define OPTIONAL_DETAIL_RESULT_SINK_HPP
+
+namespace opt {
+namespace detail {
+
+// Tag type selecting the private Optional constructor that reports the
+// address of the newly constructed, empty Optional to a sink object. Used by
+// the coroutine promise to locate the result object when the return object is
+// converted before the coroutine body runs.
+struct Result_sink_tag {};
+
+// The only user of that constructor, befriended by Optional. Defined in
+// coroutine.hpp.
+template <typename T>
+class Optional_return_object;
+
+}  // namespace detail
+}  // namespace opt
+#endif  // OPTIONAL_DETAIL_RESULT_SINK_HPP
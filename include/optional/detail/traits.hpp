@@ -0,0 +1,57 @@
+#ifndef OPTIONAL_DETAIL_TRAITS_HPP
+#define OPTIONAL_DETAIL_TRAITS_HPP
+#include <type_traits>
+
+// GCC has these builtins from version 11 but only reports them through
+// __has_builtin from version 14.
+#if defined(__clang__)
+#if __has_builtin(__is_nothrow_constructible) && \
+    __has_builtin(__is_nothrow_assignable)
+#define OPTIONAL_NOTHROW_BUILTINS
+#endif
+#elif defined(__GNUC__) && __GNUC__ >= 11
+#define OPTIONAL_NOTHROW_BUILTINS
+#endif
+
+namespace opt {
+namespace detail {
+
+// Noexcept traits used by Optional's special members. Where the compiler
+// exposes them, these evaluate the builtins directly, which does not
+// instantiate a std:: trait class template per payload type and argument
+// list in every translation unit.
+#if defined(OPTIONAL_NOTHROW_BUILTINS)
+template <typename X, typename... Args>
+constexpr bool nothrow_constructible = __is_nothrow_constructible(X, Args...);
+
+template <typename X, typename Y>
+constexpr bool nothrow_assignable = __is_nothrow_assignable(X, Y);
+#else
+template <typename X, typename... Args>
+constexpr bool nothrow_constructible =
+    std::is_nothrow_constructible<X, Args...>::value;
+
+template <typename X, typename Y>
+constexpr bool nothrow_assignable = std::is_nothrow_assignable<X, Y>::value;
+#endif
+
+#if defined(__clang__)
+#if __has_builtin(__is_nothrow_destructible)
+#define OPTIONAL_NOTHROW_DESTRUCTIBLE_BUILTIN
+#endif
+#endif
+
+#if defined(OPTIONAL_NOTHROW_DESTRUCTIBLE_BUILTIN)
+template <typename X>
+constexpr bool nothrow_destructible = __is_nothrow_destructible(X);
+#else
+template <typename X>
+constexpr bool nothrow_destructible = std::is_nothrow_destructible<X>::value;
+#endif
+
+}  // namespace detail
+}  // namespace opt
+
+#undef OPTIONAL_NOTHROW_BUILTINS
+#undef OPTIONAL_NOTHROW_DESTRUCTIBLE_BUILTIN
+#endif  // OPTIONAL_DETAIL_TRAITS_HPP
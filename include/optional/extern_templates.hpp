@@ -0,0 +1,43 @@
+/// \file
+/// \brief Explicit instantiation declarations of Optional for common payload
+/// types.
+///
+/// Translation units that include this header use a single shared
+/// instantiation of each Optional below instead of instantiating its members
+/// themselves. Exactly one translation unit of the program must define
+/// OPTIONAL_INSTANTIATE_EXTERN_TEMPLATES before including this header, to
+/// provide the definitions.
+///
+/// \code
+/// // optional_instances.cpp
+/// #define OPTIONAL_INSTANTIATE_EXTERN_TEMPLATES
+/// #include <optional/extern_templates.hpp>
+/// \endcode
+///
+/// Optional<bool> is a full specialization and needs no instantiation.
+#ifndef OPTIONAL_EXTERN_TEMPLATES_HPP
+#define OPTIONAL_EXTERN_TEMPLATES_HPP
+#include <optional/optional.hpp>
+
+#if defined(OPTIONAL_INSTANTIATE_EXTERN_TEMPLATES)
+#define OPTIONAL_EXTERN_TEMPLATE template
+#else
+#define OPTIONAL_EXTERN_TEMPLATE extern template
+#endif
+
+namespace opt {
+
+OPTIONAL_EXTERN_TEMPLATE class Optional<char>;
+OPTIONAL_EXTERN_TEMPLATE class Optional<int>;
+OPTIONAL_EXTERN_TEMPLATE class Optional<unsigned>;
+OPTIONAL_EXTERN_TEMPLATE class Optional<long>;
+OPTIONAL_EXTERN_TEMPLATE class Optional<unsigned long>;
+OPTIONAL_EXTERN_TEMPLATE class Optional<long long>;
+OPTIONAL_EXTERN_TEMPLATE class Optional<unsigned long long>;
+OPTIONAL_EXTERN_TEMPLATE class Optional<float>;
+OPTIONAL_EXTERN_TEMPLATE class Optional<double>;
+
+}  // namespace opt
+
+#undef OPTIONAL_EXTERN_TEMPLATE
+#endif  // OPTIONAL_EXTERN_TEMPLATES_HPP
@@ -0,0 +1,147 @@
+/// \file
+/// \brief C++20 coroutine generator with a pull interface.
+///
+/// Generator<T>::next() resumes the coroutine until its next co_yield and
+/// returns a reference to the yielded value, or an empty Optional once the
+/// coroutine has finished. A Generator is a source in the sense of pull.hpp,
+/// so it composes with the stages defined there.
+///
+/// \code
+/// opt::Generator<int> iota(int n) {
+///     for (int i = 0; i < n; ++i)
+///         co_yield i;
+/// }
+/// auto g = iota(3);
+/// while (auto i = g.next()) {
+///     foo(*i);
+/// }
+/// \endcode
+///
+/// Only available when the compiler supports coroutines, otherwise this header
+/// is empty; use the iterator based sources in pull.hpp instead.
+#ifndef OPTIONAL_GENERATOR_HPP
+#define OPTIONAL_GENERATOR_HPP
+#include <optional/coroutine.hpp>
+
+#if defined(OPTIONAL_HAS_COROUTINES)
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include <optional/none.hpp>
+#include <optional/optional_reference.hpp>
+
+namespace opt {
+
+/// \brief Lazily produces a sequence of T from a coroutine.
+///
+/// The yielded value is referenced, not copied, and is valid until the next
+/// call to next(). T may be const qualified.
+template <typename T>
+class Generator {
+   public:
+    using Value_type = T;
+
+    class promise_type {
+       public:
+        auto get_return_object() noexcept -> Generator
+        {
+            return Generator{
+                std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+
+        auto initial_suspend() const noexcept -> std::suspend_always
+        {
+            return {};
+        }
+
+        auto final_suspend() const noexcept -> std::suspend_always
+        {
+            return {};
+        }
+
+        auto yield_value(T& value) noexcept -> std::suspend_always
+        {
+            current_ = std::addressof(value);
+            return {};
+        }
+
+        auto yield_value(std::remove_const_t<T>&& value) noexcept
+            -> std::suspend_always
+        {
+            current_ = std::addressof(value);
+            return {};
+        }
+
+        auto return_void() const noexcept -> void {}
+
+        auto unhandled_exception() noexcept -> void
+        {
+            error_ = std::current_exception();
+        }
+
+        /// Generators only suspend through co_yield.
+        template <typename U>
+        auto await_transform(U&&) -> void = delete;
+
+       private:
+        T* current_{nullptr};
+        std::exception_ptr error_;
+
+        friend class Generator;
+    };
+
+    Generator() = default;
+
+    Generator(Generator&& other) noexcept
+        : handle_{std::exchange(other.handle_, nullptr)}
+    {}
+
+    auto operator=(Generator&& other) noexcept -> Generator&
+    {
+        if (this != &other) {
+            this->release();
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+
+    ~Generator() { this->release(); }
+
+    /// \brief Resume the coroutine until it yields or finishes.
+    ///
+    /// Rethrows any exception that escaped the coroutine body.
+    /// \returns The yielded value, or empty if the coroutine has finished.
+    auto next() -> Optional<T&>
+    {
+        if (!handle_ || handle_.done())
+            return opt::none;
+        handle_.resume();
+        auto& promise = handle_.promise();
+        if (promise.error_)
+            std::rethrow_exception(std::exchange(promise.error_, nullptr));
+        if (handle_.done())
+            return opt::none;
+        return *promise.current_;
+    }
+
+   private:
+    std::coroutine_handle<promise_type> handle_{nullptr};
+
+    explicit Generator(std::coroutine_handle<promise_type> handle) noexcept
+        : handle_{handle}
+    {}
+
+    auto release() noexcept -> void
+    {
+        if (handle_)
+            handle_.destroy();
+        handle_ = nullptr;
+    }
+};
+
+}  // namespace opt
+#endif  // defined(OPTIONAL_HAS_COROUTINES)
+#endif  // OPTIONAL_GENERATOR_HPP
@@ -0,0 +1,56 @@
+/// \file
+/// \brief Hashing for Optional.
+///
+/// An engaged Optional<T> hashes as its value does. Every empty Optional, of
+/// any T, hashes to the same constant, so empties collide only with each
+/// other and with the rare value that happens to share that hash.
+#ifndef OPTIONAL_HASH_HPP
+#define OPTIONAL_HASH_HPP
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+
+#include <optional/optional_reference.hpp>
+#include <optional/optional_value.hpp>
+
+namespace opt {
+
+/// The hash of every empty Optional.
+constexpr std::size_t empty_hash =
+    static_cast<std::size_t>(0x9E3779B97F4A7C15ull);
+
+/// \brief Hash function object, std::hash for all types except Optional.
+template <typename T = void>
+struct hash : std::hash<T> {};
+
+/// \brief Hashes an Optional<T> as its value, or as opt::empty_hash if empty.
+template <typename T>
+struct hash<Optional<T>> {
+    auto operator()(const Optional<T>& x) const -> std::size_t
+    {
+        using U = std::remove_const_t<std::remove_reference_t<T>>;
+        return x ? opt::hash<U>{}(*x) : empty_hash;
+    }
+};
+
+/// \brief Transparent hash, deduces the type to hash from the argument.
+template <>
+struct hash<void> {
+    using is_transparent = void;
+
+    template <typename T>
+    auto operator()(const T& x) const -> std::size_t
+    {
+        return opt::hash<T>{}(x);
+    }
+};
+
+}  // namespace opt
+
+namespace std {
+
+template <typename T>
+struct hash<opt::Optional<T>> : opt::hash<opt::Optional<T>> {};
+
+}  // namespace std
+#endif  // OPTIONAL_HASH_HPP
@@ -0,0 +1,183 @@
+/// \file
+/// \brief Container lookups returning Optional references instead of
+/// iterators.
+///
+/// Each function probes the container once and returns a reference into it,
+/// or empty if there is no such element. The reference is invalidated along
+/// with the container's iterators.
+///
+/// \code
+/// std::map<std::string, int, std::less<>> m{{"a", 1}};
+/// if (auto x = opt::find(m, "a")) {
+///     ++*x;
+/// }
+/// \endcode
+#ifndef OPTIONAL_LOOKUP_HPP
+#define OPTIONAL_LOOKUP_HPP
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include <optional/none.hpp>
+#include <optional/optional_reference.hpp>
+#include <optional/optional_value.hpp>
+
+namespace opt {
+namespace detail {
+
+template <typename...>
+using Void_t = void;
+
+template <typename C, typename = void>
+struct Has_mapped_type : std::false_type {};
+
+template <typename C>
+struct Has_mapped_type<C, Void_t<typename C::mapped_type>> : std::true_type {};
+
+template <typename C, typename = void>
+struct Has_front : std::false_type {};
+
+template <typename C>
+struct Has_front<C, Void_t<decltype(std::declval<C&>().front())>>
+    : std::true_type {};
+
+// The mapped value for maps, the element itself for sets.
+template <typename Iterator>
+auto mapped_of(Iterator it, std::true_type) -> decltype((it->second))
+{
+    return it->second;
+}
+
+template <typename Iterator>
+auto mapped_of(Iterator it, std::false_type) -> decltype(*it)
+{
+    return *it;
+}
+
+template <typename C, typename Key>
+using Find_t = std::remove_reference_t<decltype(mapped_of(
+    std::declval<C&>().find(std::declval<const Key&>()),
+    Has_mapped_type<std::remove_const_t<C>>{}))>;
+
+template <typename Range>
+using Reference_t = std::remove_reference_t<decltype(
+    *std::begin(std::declval<Range&>()))>;
+
+template <typename Q>
+auto pop_next(Q& q, std::true_type) -> decltype(std::move(q.front()))
+{
+    return std::move(q.front());
+}
+
+template <typename Q>
+auto pop_next(Q& q, std::false_type) -> decltype(std::move(q.top()))
+{
+    return std::move(q.top());
+}
+
+}  // namespace detail
+
+/// \brief Looks up \p key in an associative container.
+///
+/// Heterogeneous keys are passed straight to the container's find(), so
+/// containers with transparent comparators or hashers do not convert them.
+/// \returns A reference to the mapped value for maps, or to the element for
+/// sets, or empty if \p key is not found.
+template <typename Assoc, typename Key>
+auto find(Assoc& c, const Key& key) -> Optional<detail::Find_t<Assoc, Key>&>
+{
+    auto const it = c.find(key);
+    if (it == c.end())
+        return opt::none;
+    return detail::mapped_of(
+        it, detail::Has_mapped_type<std::remove_const_t<Assoc>>{});
+}
+
+template <typename Assoc, typename Key>
+auto find(const Assoc&& c, const Key& key) -> void = delete;
+
+/// \returns A reference to element \p i of a random access container, or
+/// empty if \p i is out of range.
+template <typename Sequence>
+auto at(Sequence& s, std::size_t i)
+    -> Optional<std::remove_reference_t<decltype(s[i])>&>
+{
+    if (i >= s.size())
+        return opt::none;
+    return s[i];
+}
+
+/// \returns A reference to element \p i of an array, or empty if \p i is out
+/// of range.
+template <typename T, std::size_t N>
+auto at(T (&array)[N], std::size_t i) -> Optional<T&>
+{
+    return {i < N, array[i < N ? i : 0]};
+}
+
+template <typename Sequence>
+auto at(const Sequence&& s, std::size_t i) -> void = delete;
+
+/// \returns A reference to the first element, or empty if there is none.
+template <typename Sequence>
+auto front(Sequence& s)
+    -> Optional<std::remove_reference_t<decltype(s.front())>&>
+{
+    if (s.empty())
+        return opt::none;
+    return s.front();
+}
+
+template <typename Sequence>
+auto front(const Sequence&& s) -> void = delete;
+
+/// \returns A reference to the last element, or empty if there is none.
+template <typename Sequence>
+auto back(Sequence& s)
+    -> Optional<std::remove_reference_t<decltype(s.back())>&>
+{
+    if (s.empty())
+        return opt::none;
+    return s.back();
+}
+
+template <typename Sequence>
+auto back(const Sequence&& s) -> void = delete;
+
+/// \returns A reference to the first element of \p range satisfying \p pred,
+/// or empty if there is none.
+template <typename Range, typename Predicate>
+auto find_if(Range& range, Predicate pred)
+    -> Optional<detail::Reference_t<Range>&>
+{
+    auto const last = std::end(range);
+    auto const it = std::find_if(std::begin(range), last, std::move(pred));
+    if (it == last)
+        return opt::none;
+    return *it;
+}
+
+template <typename Range, typename Predicate>
+auto find_if(const Range&& range, Predicate pred) -> void = delete;
+
+/// \brief Removes and returns the next element of a std::queue, std::stack or
+/// std::priority_queue.
+///
+/// Elements are moved out, except from std::priority_queue, whose top() is
+/// const and so is copied.
+/// \returns The removed element, or empty if \p q is empty.
+template <typename Queue>
+auto pop(Queue& q) -> Optional<typename Queue::value_type>
+{
+    if (q.empty())
+        return opt::none;
+    Optional<typename Queue::value_type> next{
+        detail::pop_next(q, detail::Has_front<Queue>{})};
+    q.pop();
+    return next;
+}
+
+}  // namespace opt
+#endif  // OPTIONAL_LOOKUP_HPP
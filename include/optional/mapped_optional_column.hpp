@@ -0,0 +1,483 @@
+/// \file
+/// \brief A file format for optional columns, read in place through mmap.
+///
+/// A column file has three regions, each starting on a 64 byte boundary:
+/// - a 64 byte Mapped_column_header,
+/// - the dense value array, sizeof(T) bytes per element, empty elements hold
+///   value initialized T objects,
+/// - the validity bitmap, laid out as in Optional_column.
+///
+/// Files are written with Mapped_column_writer and read with
+/// Mapped_optional_column. Both use the native byte order, and the header
+/// records it so a file from a machine of the other byte order is rejected.
+///
+/// \code
+/// {
+///     opt::Mapped_column_writer<double> w{"prices.col"};
+///     for (auto const& p : prices)
+///         w.push_back(p);  // Optional<double>
+/// }
+/// auto column = opt::Mapped_optional_column<double>::open("prices.col");
+/// if (column) {
+///     for (double p : *column | opt::views::engaged) { ... }
+/// }
+/// \endcode
+///
+/// Requires POSIX open, mmap and pwrite.
+#ifndef OPTIONAL_MAPPED_OPTIONAL_COLUMN_HPP
+#define OPTIONAL_MAPPED_OPTIONAL_COLUMN_HPP
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <optional/detail/bit_ops.hpp>
+#include <optional/none.hpp>
+#include <optional/optional_reference.hpp>
+#include <optional/optional_value.hpp>
+
+namespace opt {
+
+/// \brief The first 64 bytes of a column file.
+struct Mapped_column_header {
+    char magic[8];
+    std::uint32_t version;
+    // Written as 0x01020304 in the writer's byte order.
+    std::uint32_t byte_order;
+    std::uint32_t value_size;
+    std::uint32_t value_align;
+    std::uint64_t size;
+    std::uint64_t values_offset;
+    std::uint64_t validity_offset;
+    // Checksum of the value array followed by the validity bitmap.
+    std::uint64_t checksum;
+    std::uint64_t reserved;
+};
+
+static_assert(sizeof(Mapped_column_header) == 64,
+              "The header fills the first 64 bytes of a column file.");
+
+namespace detail {
+
+constexpr char mapped_column_magic[8] = {'O', 'P', 'T', 'C',
+                                         'O', 'L', '\0', '\0'};
+constexpr std::uint32_t mapped_column_version = 1;
+constexpr std::uint32_t mapped_column_byte_order = 0x01020304;
+constexpr std::size_t mapped_column_alignment = 64;
+
+constexpr auto align_up(std::uint64_t n, std::uint64_t align) -> std::uint64_t
+{
+    return (n + align - 1) / align * align;
+}
+
+// Running 64 bit checksum of a byte stream, eight bytes per step. The result
+// does not depend on how the stream is split into update() calls.
+class Checksum {
+   public:
+    auto update(const void* data, std::size_t n) -> void
+    {
+        auto p = static_cast<const unsigned char*>(data);
+        while (n != 0 && pending_ != 0) {
+            this->push_byte(*p++);
+            --n;
+        }
+        for (; n >= 8; p += 8, n -= 8) {
+            std::uint64_t word;
+            std::memcpy(&word, p, 8);
+            this->mix(word);
+        }
+        while (n-- != 0)
+            this->push_byte(*p++);
+    }
+
+    auto value() const -> std::uint64_t
+    {
+        auto h = state_;
+        if (pending_ != 0) {
+            std::uint64_t word = 0;
+            std::memcpy(&word, buffer_, pending_);
+            h = (h ^ word ^ pending_) * 0x9E3779B97F4A7C15ull;
+        }
+        return h ^ (h >> 29);
+    }
+
+   private:
+    std::uint64_t state_{0xCBF29CE484222325ull};
+    unsigned char buffer_[8];
+    std::size_t pending_{0};
+
+    auto mix(std::uint64_t word) -> void
+    {
+        state_ = (state_ ^ word) * 0x9E3779B97F4A7C15ull;
+        state_ ^= state_ >> 32;
+    }
+
+    auto push_byte(unsigned char b) -> void
+    {
+        buffer_[pending_++] = b;
+        if (pending_ == 8) {
+            std::uint64_t word;
+            std::memcpy(&word, buffer_, 8);
+            this->mix(word);
+            pending_ = 0;
+        }
+    }
+};
+
+inline auto write_all(int fd, const void* data, std::size_t n, off_t offset)
+    -> void
+{
+    auto p = static_cast<const char*>(data);
+    while (n != 0) {
+        auto const written = ::pwrite(fd, p, n, offset);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            throw std::system_error{errno, std::generic_category(),
+                                    "Mapped_column_writer: write failed."};
+        }
+        p += written;
+        n -= static_cast<std::size_t>(written);
+        offset += written;
+    }
+}
+
+}  // namespace detail
+
+/// \brief Writes a column file one element or one chunk at a time.
+///
+/// Values are buffered and written a chunk at a time. Only the validity
+/// bitmap, one bit per element, is kept until finish() writes it after the
+/// values, followed by the header. The destructor calls finish() if it has
+/// not been called, discarding any error.
+template <typename T>
+class Mapped_column_writer {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Mapped columns store T as raw bytes.");
+
+   public:
+    /// \brief Creates or truncates the file at \p path.
+    /// \param chunk_size The number of values buffered between writes.
+    /// \throws std::system_error If the file cannot be opened.
+    explicit Mapped_column_writer(const std::string& path,
+                                  std::size_t chunk_size = 1 << 16)
+        : fd_{::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644)},
+          chunk_size_{chunk_size == 0 ? 1 : chunk_size}
+    {
+        if (fd_ < 0) {
+            throw std::system_error{errno, std::generic_category(),
+                                    "Mapped_column_writer: cannot open " +
+                                        path + "."};
+        }
+        buffer_.reserve(chunk_size_);
+    }
+
+    Mapped_column_writer(const Mapped_column_writer&) = delete;
+    auto operator=(const Mapped_column_writer&)
+        -> Mapped_column_writer& = delete;
+
+    ~Mapped_column_writer()
+    {
+        try {
+            this->finish();
+        }
+        catch (...) {
+        }
+    }
+
+    /// \returns The number of elements written so far.
+    auto size() const noexcept -> std::size_t { return size_; }
+
+    /// Appends an element, engaged if \p value is.
+    auto push_back(const Optional<T>& value) -> void
+    {
+        if (value)
+            this->push_back(*value);
+        else
+            this->push_back(opt::none);
+    }
+
+    auto push_back(const T& value) -> void
+    {
+        this->grow();
+        detail::set_bit(validity_.data(), size_++);
+        this->buffer(value);
+    }
+
+    auto push_back(opt::None_t) -> void
+    {
+        this->grow();
+        ++size_;
+        this->buffer(T{});
+    }
+
+    /// \brief Appends \p n elements given as a value array and a validity
+    /// bitmap laid out as in Optional_column, such as a whole Optional_column.
+    auto append(const T* values, const std::uint64_t* validity, std::size_t n)
+        -> void
+    {
+        auto const shift = size_ % detail::word_bits;
+        validity_.resize(detail::words_for(size_ + n));
+        for (std::size_t w = 0; w < detail::words_for(n); ++w) {
+            auto const bits = validity[w] &
+                              detail::low_mask(n - w * detail::word_bits);
+            auto const out = size_ / detail::word_bits + w;
+            validity_[out] |= bits << shift;
+            if (shift != 0 && out + 1 < validity_.size())
+                validity_[out + 1] |= bits >> (detail::word_bits - shift);
+        }
+        size_ += n;
+        while (n != 0) {
+            auto const room = chunk_size_ - buffer_.size();
+            auto const count = n < room ? n : room;
+            buffer_.insert(buffer_.end(), values, values + count);
+            values += count;
+            n -= count;
+            if (buffer_.size() == chunk_size_)
+                this->flush();
+        }
+    }
+
+    /// \brief Writes the remaining values, the validity bitmap and the
+    /// header, then closes the file. Later calls do nothing.
+    /// \throws std::system_error If a write fails.
+    auto finish() -> void
+    {
+        if (fd_ < 0)
+            return;
+        this->flush();
+        Mapped_column_header header{};
+        std::memcpy(header.magic, detail::mapped_column_magic, 8);
+        header.version = detail::mapped_column_version;
+        header.byte_order = detail::mapped_column_byte_order;
+        header.value_size = sizeof(T);
+        header.value_align = alignof(T);
+        header.size = size_;
+        header.values_offset = sizeof(Mapped_column_header);
+        header.validity_offset = detail::align_up(
+            header.values_offset + size_ * sizeof(T),
+            detail::mapped_column_alignment);
+        auto const padding = header.validity_offset - offset_;
+        char const zeros[detail::mapped_column_alignment] = {};
+        checksum_.update(zeros, padding);
+        auto const bitmap_bytes = validity_.size() * sizeof(std::uint64_t);
+        checksum_.update(validity_.data(), bitmap_bytes);
+        header.checksum = checksum_.value();
+
+        int const fd = fd_;
+        fd_ = -1;
+        detail::write_all(fd, zeros, padding, static_cast<off_t>(offset_));
+        detail::write_all(fd, validity_.data(), bitmap_bytes,
+                          static_cast<off_t>(header.validity_offset));
+        detail::write_all(fd, &header, sizeof(header), 0);
+        if (::close(fd) != 0) {
+            throw std::system_error{errno, std::generic_category(),
+                                    "Mapped_column_writer: close failed."};
+        }
+    }
+
+   private:
+    int fd_;
+    std::size_t chunk_size_;
+    std::vector<T> buffer_;
+    std::vector<std::uint64_t> validity_;
+    std::size_t size_{0};
+    // File offset of the next value, the values start after the header.
+    std::uint64_t offset_{sizeof(Mapped_column_header)};
+    detail::Checksum checksum_;
+
+    auto grow() -> void
+    {
+        if (size_ % detail::word_bits == 0)
+            validity_.push_back(0);
+    }
+
+    auto buffer(const T& value) -> void
+    {
+        buffer_.push_back(value);
+        if (buffer_.size() == chunk_size_)
+            this->flush();
+    }
+
+    auto flush() -> void
+    {
+        auto const bytes = buffer_.size() * sizeof(T);
+        checksum_.update(buffer_.data(), bytes);
+        detail::write_all(fd_, buffer_.data(), bytes,
+                          static_cast<off_t>(offset_));
+        offset_ += bytes;
+        buffer_.clear();
+    }
+};
+
+/// \brief A read only optional column backed by a memory mapped column file.
+///
+/// Opening maps the file and checks its header, without reading the values,
+/// so it takes the same time for any size of file. Elements are read from the
+/// mapped pages as they are accessed. The column is a bitmap layout, so the
+/// views in views.hpp work on it directly.
+template <typename T>
+class Mapped_optional_column {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Mapped columns store T as raw bytes.");
+
+   public:
+    using Value_type = T;
+
+    /// \brief Maps the column file at \p path.
+    /// \returns The column, or empty if the file cannot be mapped, or its
+    /// header is not that of a column of T written on a machine of this byte
+    /// order, or its regions do not fit in the file.
+    static auto open(const std::string& path) -> Optional<Mapped_optional_column>
+    {
+        int const fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return opt::none;
+        struct stat st;
+        if (::fstat(fd, &st) != 0 ||
+            static_cast<std::uint64_t>(st.st_size) <
+                sizeof(Mapped_column_header)) {
+            ::close(fd);
+            return opt::none;
+        }
+        auto const length = static_cast<std::size_t>(st.st_size);
+        void* const address =
+            ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (address == MAP_FAILED)
+            return opt::none;
+        Mapped_optional_column column{address, length};
+        if (!column.valid_header())
+            return opt::none;
+        return Optional<Mapped_optional_column>{std::move(column)};
+    }
+
+    Mapped_optional_column(Mapped_optional_column&& x) noexcept
+        : address_{std::exchange(x.address_, nullptr)},
+          length_{std::exchange(x.length_, 0)}
+    {}
+
+    auto operator=(Mapped_optional_column&& x) noexcept
+        -> Mapped_optional_column&
+    {
+        std::swap(address_, x.address_);
+        std::swap(length_, x.length_);
+        return *this;
+    }
+
+    ~Mapped_optional_column()
+    {
+        if (address_ != nullptr)
+            ::munmap(address_, length_);
+    }
+
+    /// \returns The number of elements, engaged or not.
+    auto size() const noexcept -> std::size_t
+    {
+        return static_cast<std::size_t>(this->header().size);
+    }
+
+    auto empty() const noexcept -> bool { return this->size() == 0; }
+
+    /// \returns The number of engaged elements.
+    auto count_engaged() const noexcept -> std::size_t
+    {
+        return detail::count_bits(this->validity(), this->size());
+    }
+
+    auto is_engaged(std::size_t i) const -> bool
+    {
+        return detail::test_bit(this->validity(), i);
+    }
+
+    /// \returns A reference to element \p i, or empty if it is not engaged.
+    auto operator[](std::size_t i) const -> Optional<const T&>
+    {
+        return {this->is_engaged(i), this->data()[i]};
+    }
+
+    /// \returns The value array, including the slots of empty elements.
+    auto data() const noexcept -> const T*
+    {
+        return reinterpret_cast<const T*>(this->bytes() +
+                                          this->header().values_offset);
+    }
+
+    /// \returns The validity bitmap words.
+    auto validity() const noexcept -> const std::uint64_t*
+    {
+        return reinterpret_cast<const std::uint64_t*>(
+            this->bytes() + this->header().validity_offset);
+    }
+
+    /// \returns The number of words in the validity bitmap.
+    auto word_count() const noexcept -> std::size_t
+    {
+        return detail::words_for(this->size());
+    }
+
+    auto header() const noexcept -> const Mapped_column_header&
+    {
+        return *static_cast<const Mapped_column_header*>(address_);
+    }
+
+    /// \brief Reads the whole file to compare it against the header checksum.
+    /// \returns True if the values and validity bitmap are intact.
+    auto verify() const -> bool
+    {
+        auto const& h = this->header();
+        detail::Checksum checksum;
+        checksum.update(this->bytes() + h.values_offset,
+                        h.validity_offset - h.values_offset);
+        checksum.update(this->validity(),
+                        this->word_count() * sizeof(std::uint64_t));
+        return checksum.value() == h.checksum;
+    }
+
+   private:
+    void* address_;
+    std::size_t length_;
+
+    Mapped_optional_column(void* address, std::size_t length)
+        : address_{address}, length_{length}
+    {}
+
+    auto bytes() const noexcept -> const unsigned char*
+    {
+        return static_cast<const unsigned char*>(address_);
+    }
+
+    auto valid_header() const -> bool
+    {
+        auto const& h = this->header();
+        auto const align = detail::mapped_column_alignment;
+        if (std::memcmp(h.magic, detail::mapped_column_magic, 8) != 0 ||
+            h.version != detail::mapped_column_version ||
+            h.byte_order != detail::mapped_column_byte_order ||
+            h.value_size != sizeof(T) || h.value_align != alignof(T) ||
+            h.values_offset % align != 0 || h.validity_offset % align != 0 ||
+            h.values_offset < sizeof(Mapped_column_header)) {
+            return false;
+        }
+        // Bounds are checked by division so huge sizes cannot overflow.
+        auto const words = detail::words_for(h.size);
+        return h.validity_offset <= length_ &&
+               (length_ - h.validity_offset) / sizeof(std::uint64_t) >=
+                   words &&
+               h.values_offset <= h.validity_offset &&
+               (h.validity_offset - h.values_offset) / sizeof(T) >= h.size;
+    }
+};
+
+}  // namespace opt
+#endif  // OPTIONAL_MAPPED_OPTIONAL_COLUMN_HPP
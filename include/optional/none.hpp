@@ -13,10 +13,17 @@ class None_t {
    public:
     /// Safe bool conversion.
     explicit operator bool() const { return false; }
-} const none;
+};
 
 ///	\var none
-/// Convenience global None_t object.
+/// Convenience global None_t object. An inline variable where the language
+/// has them, so it has external linkage and can be exported from the opt
+/// module.
+#if defined(__cpp_inline_variables)
+inline constexpr None_t none{};
+#else
+const None_t none{};
+#endif
 
 }  // namespace opt
 #endif  // NONE_HPP
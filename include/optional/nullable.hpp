@@ -0,0 +1,602 @@
+/// \file
+/// \brief Null propagating arithmetic over Optional_column, fused with
+/// expression templates.
+///
+/// Operators on columns build an expression tree instead of computing a
+/// result. evaluate() then makes a single pass: the validity of each output
+/// word is the AND of the operand validity words, and the values are computed
+/// for every element, engaged or not, in a loop with no branches for the
+/// compiler to vectorize. An empty operand makes the result empty, as with
+/// SQL NULL. No intermediate columns are allocated.
+///
+/// \code
+/// using namespace opt::nullable;
+/// Optional_column<double> a, b, c;
+/// ...
+/// Optional_column<double> r = evaluate(a * b + c);
+/// Optional_bool_vector big = evaluate(greater(a, 10.0));
+/// \endcode
+///
+/// Operands are columns, expressions and arithmetic scalars, at least one
+/// operand of each operator must be a column or an expression. Expressions
+/// refer to their columns, which must outlive them and not be resized.
+#ifndef OPTIONAL_NULLABLE_HPP
+#define OPTIONAL_NULLABLE_HPP
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <optional/detail/bit_ops.hpp>
+#include <optional/detail/conjunction.hpp>
+#include <optional/optional_bool_vector.hpp>
+#include <optional/optional_column.hpp>
+
+namespace opt {
+namespace nullable {
+namespace detail {
+
+using opt::detail::low_mask;
+using opt::detail::test_bit;
+using opt::detail::word_bits;
+using opt::detail::words_for;
+
+// Base of arithmetic expression nodes.
+struct Expr_base {};
+
+// Base of comparison expression nodes, which yield bool.
+struct Predicate_base {};
+
+template <typename E>
+using Is_expr = std::is_base_of<Expr_base, E>;
+
+template <typename E>
+using Is_predicate = std::is_base_of<Predicate_base, E>;
+
+// Size of a scalar operand, which matches any column.
+constexpr std::size_t any_size = static_cast<std::size_t>(-1);
+
+inline auto merge_sizes(std::size_t a, std::size_t b) -> std::size_t
+{
+    if (a == any_size)
+        return b;
+    if (b != any_size && a != b)
+        throw std::invalid_argument{"nullable: operand sizes differ."};
+    return a;
+}
+
+// Bits of word w set where pred(i) holds, for the elements of a column of n.
+template <typename Predicate>
+auto word_where(std::size_t w, std::size_t n, Predicate pred) -> std::uint64_t
+{
+    auto const first = w * word_bits;
+    auto const count = n - first < word_bits ? n - first : word_bits;
+    std::uint64_t word = 0;
+    for (std::size_t j = 0; j < count; ++j)
+        word |= std::uint64_t{bool(pred(first + j))} << j;
+    return word;
+}
+
+}  // namespace detail
+
+/// \brief Leaf expression reading an Optional_column.
+template <typename T>
+class Column_ref : public detail::Expr_base {
+   public:
+    using Value_type = T;
+
+    explicit Column_ref(const Optional_column<T>& column)
+        : values_{column.data()},
+          validity_{column.validity()},
+          size_{column.size()}
+    {}
+
+    auto size() const -> std::size_t { return size_; }
+
+    auto valid_word(std::size_t w) const -> std::uint64_t
+    {
+        return validity_[w];
+    }
+
+    auto value(std::size_t i) const -> T { return values_[i]; }
+
+   private:
+    const T* values_;
+    const std::uint64_t* validity_;
+    std::size_t size_;
+};
+
+/// \brief Leaf expression repeating a single engaged value.
+template <typename T>
+class Scalar : public detail::Expr_base {
+   public:
+    using Value_type = T;
+
+    explicit Scalar(T value) : value_{value} {}
+
+    auto size() const -> std::size_t { return detail::any_size; }
+
+    auto valid_word(std::size_t) const -> std::uint64_t
+    {
+        return ~std::uint64_t{0};
+    }
+
+    auto value(std::size_t) const -> T { return value_; }
+
+   private:
+    T value_;
+};
+
+namespace detail {
+
+// Binary operations. valid_word() may clear the validity of elements that
+// have no defined result, apply() must be defined for every input.
+
+struct No_mask {
+    template <typename R>
+    static auto valid_word(const R&, std::size_t, std::size_t) -> std::uint64_t
+    {
+        return ~std::uint64_t{0};
+    }
+};
+
+struct Add : No_mask {
+    template <typename V>
+    static auto apply(V x, V y) -> V
+    {
+        return x + y;
+    }
+};
+
+struct Sub : No_mask {
+    template <typename V>
+    static auto apply(V x, V y) -> V
+    {
+        return x - y;
+    }
+};
+
+struct Mul : No_mask {
+    template <typename V>
+    static auto apply(V x, V y) -> V
+    {
+        return x * y;
+    }
+};
+
+struct Min : No_mask {
+    template <typename V>
+    static auto apply(V x, V y) -> V
+    {
+        return y < x ? y : x;
+    }
+};
+
+struct Max : No_mask {
+    template <typename V>
+    static auto apply(V x, V y) -> V
+    {
+        return x < y ? y : x;
+    }
+};
+
+// Floating point division follows IEEE 754. Integer division by zero gives an
+// empty result, and the divisor is replaced so the division, which is also
+// computed for empty elements, can never trap.
+struct Div {
+    template <typename R>
+    static auto valid_word(const R& r, std::size_t w, std::size_t n)
+        -> std::uint64_t
+    {
+        return valid_word(r, w, n,
+                          std::is_integral<typename R::Value_type>{});
+    }
+
+    template <typename V>
+    static auto apply(V x, V y) -> V
+    {
+        return apply(x, y, std::is_integral<V>{}, std::is_signed<V>{});
+    }
+
+   private:
+    template <typename R>
+    static auto valid_word(const R&, std::size_t, std::size_t, std::false_type)
+        -> std::uint64_t
+    {
+        return ~std::uint64_t{0};
+    }
+
+    template <typename R>
+    static auto valid_word(const R& r,
+                           std::size_t w,
+                           std::size_t n,
+                           std::true_type) -> std::uint64_t
+    {
+        return word_where(w, n, [&r](std::size_t i) {
+            return r.value(i) != typename R::Value_type{0};
+        });
+    }
+
+    template <typename V, typename Signed>
+    static auto apply(V x, V y, std::false_type, Signed) -> V
+    {
+        return x / y;
+    }
+
+    template <typename V>
+    static auto apply(V x, V y, std::true_type, std::false_type) -> V
+    {
+        return x / (y == 0 ? V{1} : y);
+    }
+
+    // Also avoids the overflow of dividing the minimum value by -1.
+    template <typename V>
+    static auto apply(V x, V y, std::true_type, std::true_type) -> V
+    {
+        using U = std::make_unsigned_t<V>;
+        auto const negated = static_cast<V>(U{0} - static_cast<U>(x));
+        auto const quotient = x / (y == 0 || y == -1 ? V{1} : y);
+        return y == -1 ? negated : quotient;
+    }
+};
+
+struct Equal {
+    template <typename V>
+    static auto apply(V x, V y) -> bool
+    {
+        return x == y;
+    }
+};
+
+struct Not_equal {
+    template <typename V>
+    static auto apply(V x, V y) -> bool
+    {
+        return x != y;
+    }
+};
+
+struct Less {
+    template <typename V>
+    static auto apply(V x, V y) -> bool
+    {
+        return x < y;
+    }
+};
+
+struct Less_equal {
+    template <typename V>
+    static auto apply(V x, V y) -> bool
+    {
+        return x <= y;
+    }
+};
+
+struct Greater {
+    template <typename V>
+    static auto apply(V x, V y) -> bool
+    {
+        return x > y;
+    }
+};
+
+struct Greater_equal {
+    template <typename V>
+    static auto apply(V x, V y) -> bool
+    {
+        return x >= y;
+    }
+};
+
+}  // namespace detail
+
+/// \brief Expression node applying Op to two operand expressions.
+template <typename Op, typename L, typename R>
+class Binary_expr : public detail::Expr_base {
+   public:
+    using Value_type = std::common_type_t<typename L::Value_type,
+                                          typename R::Value_type>;
+
+    Binary_expr(L l, R r)
+        : l_{std::move(l)},
+          r_{std::move(r)},
+          size_{detail::merge_sizes(l_.size(), r_.size())}
+    {}
+
+    auto size() const -> std::size_t { return size_; }
+
+    auto valid_word(std::size_t w) const -> std::uint64_t
+    {
+        return l_.valid_word(w) & r_.valid_word(w) &
+               Op::valid_word(r_, w, size_);
+    }
+
+    auto value(std::size_t i) const -> Value_type
+    {
+        return Op::template apply<Value_type>(l_.value(i), r_.value(i));
+    }
+
+   private:
+    L l_;
+    R r_;
+    std::size_t size_;
+};
+
+/// \brief Expression node computing x * y + z with a single rounding for
+/// floating point types.
+template <typename X, typename Y, typename Z>
+class Fma_expr : public detail::Expr_base {
+   public:
+    using Value_type = std::common_type_t<typename X::Value_type,
+                                          typename Y::Value_type,
+                                          typename Z::Value_type>;
+
+    Fma_expr(X x, Y y, Z z)
+        : x_{std::move(x)},
+          y_{std::move(y)},
+          z_{std::move(z)},
+          size_{detail::merge_sizes(detail::merge_sizes(x_.size(), y_.size()),
+                                    z_.size())}
+    {}
+
+    auto size() const -> std::size_t { return size_; }
+
+    auto valid_word(std::size_t w) const -> std::uint64_t
+    {
+        return x_.valid_word(w) & y_.valid_word(w) & z_.valid_word(w);
+    }
+
+    auto value(std::size_t i) const -> Value_type
+    {
+        return fma(x_.value(i), y_.value(i), z_.value(i),
+                   std::is_floating_point<Value_type>{});
+    }
+
+   private:
+    X x_;
+    Y y_;
+    Z z_;
+    std::size_t size_;
+
+    static auto fma(Value_type x, Value_type y, Value_type z, std::true_type)
+        -> Value_type
+    {
+        return std::fma(x, y, z);
+    }
+
+    static auto fma(Value_type x, Value_type y, Value_type z, std::false_type)
+        -> Value_type
+    {
+        return x * y + z;
+    }
+};
+
+/// \brief Expression node comparing two operand expressions, evaluates to an
+/// Optional_bool_vector.
+template <typename Op, typename L, typename R>
+class Compare_expr : public detail::Predicate_base {
+   public:
+    using Value_type = bool;
+
+    Compare_expr(L l, R r)
+        : l_{std::move(l)},
+          r_{std::move(r)},
+          size_{detail::merge_sizes(l_.size(), r_.size())}
+    {}
+
+    auto size() const -> std::size_t { return size_; }
+
+    auto valid_word(std::size_t w) const -> std::uint64_t
+    {
+        return l_.valid_word(w) & r_.valid_word(w);
+    }
+
+    auto value(std::size_t i) const -> bool
+    {
+        using V = std::common_type_t<typename L::Value_type,
+                                     typename R::Value_type>;
+        return Op::template apply<V>(l_.value(i), r_.value(i));
+    }
+
+   private:
+    L l_;
+    R r_;
+    std::size_t size_;
+};
+
+namespace detail {
+
+template <typename T>
+struct Is_column : std::false_type {};
+
+template <typename T>
+struct Is_column<Optional_column<T>> : std::true_type {};
+
+template <typename T>
+using Is_node =
+    std::integral_constant<bool, Is_expr<T>::value || Is_column<T>::value>;
+
+template <typename T>
+using Is_operand = std::integral_constant<bool,
+                                          Is_node<T>::value ||
+                                              std::is_arithmetic<T>::value>;
+
+template <typename T>
+using Is_not_node = std::integral_constant<bool, !Is_node<T>::value>;
+
+// At least one column or expression, and nothing that is not an operand.
+template <typename... Ts>
+using Enable_operands =
+    std::enable_if_t<!opt::detail::Conjunction<Is_not_node<Ts>...>::value &&
+                     opt::detail::Conjunction<Is_operand<Ts>...>::value>;
+
+template <typename E>
+auto as_expr(const E& e) -> std::enable_if_t<Is_expr<E>::value, const E&>
+{
+    return e;
+}
+
+template <typename T>
+auto as_expr(const Optional_column<T>& c) -> Column_ref<T>
+{
+    return Column_ref<T>{c};
+}
+
+template <typename T>
+auto as_expr(T x) -> std::enable_if_t<std::is_arithmetic<T>::value, Scalar<T>>
+{
+    return Scalar<T>{x};
+}
+
+template <typename T>
+using Expr_t = std::decay_t<decltype(as_expr(std::declval<const T&>()))>;
+
+template <typename Op, typename X, typename Y>
+using Binary_t = Binary_expr<Op, Expr_t<X>, Expr_t<Y>>;
+
+template <typename Op, typename X, typename Y>
+using Compare_t = Compare_expr<Op, Expr_t<X>, Expr_t<Y>>;
+
+}  // namespace detail
+
+/// \returns An expression reading \p column.
+template <typename T>
+auto ref(const Optional_column<T>& column) -> Column_ref<T>
+{
+    return Column_ref<T>{column};
+}
+
+template <typename X, typename Y, typename = detail::Enable_operands<X, Y>>
+auto operator+(const X& x, const Y& y) -> detail::Binary_t<detail::Add, X, Y>
+{
+    return {detail::as_expr(x), detail::as_expr(y)};
+}
+
+template <typename X, typename Y, typename = detail::Enable_operands<X, Y>>
+auto operator-(const X& x, const Y& y) -> detail::Binary_t<detail::Sub, X, Y>
+{
+    return {detail::as_expr(x), detail::as_expr(y)};
+}
+
+template <typename X, typename Y, typename = detail::Enable_operands<X, Y>>
+auto operator*(const X& x, const Y& y) -> detail::Binary_t<detail::Mul, X, Y>
+{
+    return {detail::as_expr(x), detail::as_expr(y)};
+}
+
+/// Integer division by zero yields an empty element.
+template <typename X, typename Y, typename = detail::Enable_operands<X, Y>>
+auto operator/(const X& x, const Y& y) -> detail::Binary_t<detail::Div, X, Y>
+{
+    return {detail::as_expr(x), detail::as_expr(y)};
+}
+
+template <typename X, typename Y, typename = detail::Enable_operands<X, Y>>
+auto min(const X& x, const Y& y) -> detail::Binary_t<detail::Min, X, Y>
+{
+    return {detail::as_expr(x), detail::as_expr(y)};
+}
+
+template <typename X, typename Y, typename = detail::Enable_operands<X, Y>>
+auto max(const X& x, const Y& y) -> detail::Binary_t<detail::Max, X, Y>
+{
+    return {detail::as_expr(x), detail::as_expr(y)};
+}
+
+/// x * y + z, rounded once for floating point values.
+template <typename X,
+          typename Y,
+          typename Z,
+          typename = detail::Enable_operands<X, Y, Z>>
+auto fma(const X& x, const Y& y, const Z& z)
+    -> Fma_expr<detail::Expr_t<X>, detail::Expr_t<Y>, detail::Expr_t<Z>>
+{
+    return {detail::as_expr(x), detail::as_expr(y), detail::as_expr(z)};
+}
+
+template <typename X, typename Y, typename = detail::Enable_operands<X, Y>>
+auto equal(const X& x, const Y& y) -> detail::Compare_t<detail::Equal, X, Y>
+{
+    return {detail::as_expr(x), detail::as_expr(y)};
+}
+
+template <typename X, typename Y, typename = detail::Enable_operands<X, Y>>
+auto not_equal(const X& x, const Y& y)
+    -> detail::Compare_t<detail::Not_equal, X, Y>
+{
+    return {detail::as_expr(x), detail::as_expr(y)};
+}
+
+template <typename X, typename Y, typename = detail::Enable_operands<X, Y>>
+auto less(const X& x, const Y& y) -> detail::Compare_t<detail::Less, X, Y>
+{
+    return {detail::as_expr(x), detail::as_expr(y)};
+}
+
+template <typename X, typename Y, typename = detail::Enable_operands<X, Y>>
+auto less_equal(const X& x, const Y& y)
+    -> detail::Compare_t<detail::Less_equal, X, Y>
+{
+    return {detail::as_expr(x), detail::as_expr(y)};
+}
+
+template <typename X, typename Y, typename = detail::Enable_operands<X, Y>>
+auto greater(const X& x, const Y& y)
+    -> detail::Compare_t<detail::Greater, X, Y>
+{
+    return {detail::as_expr(x), detail::as_expr(y)};
+}
+
+template <typename X, typename Y, typename = detail::Enable_operands<X, Y>>
+auto greater_equal(const X& x, const Y& y)
+    -> detail::Compare_t<detail::Greater_equal, X, Y>
+{
+    return {detail::as_expr(x), detail::as_expr(y)};
+}
+
+/// \brief Computes an arithmetic expression in one pass.
+///
+/// Empty elements of the result hold value initialized objects, as with any
+/// Optional_column.
+template <typename E, typename = std::enable_if_t<detail::Is_expr<E>::value>>
+auto evaluate(const E& e) -> Optional_column<typename E::Value_type>
+{
+    using V = typename E::Value_type;
+    auto const n = e.size();
+    Optional_column<V> result(n);
+    auto* const validity = result.validity();
+    auto* const values = result.data();
+    for (std::size_t w = 0; w < result.word_count(); ++w)
+        validity[w] = e.valid_word(w);
+    if (n % detail::word_bits != 0)
+        validity[n / detail::word_bits] &= detail::low_mask(n % detail::word_bits);
+    for (std::size_t i = 0; i < n; ++i) {
+        V const x = e.value(i);
+        values[i] = detail::test_bit(validity, i) ? x : V{};
+    }
+    return result;
+}
+
+/// \brief Computes a comparison expression in one pass.
+template <typename E,
+          typename = std::enable_if_t<detail::Is_predicate<E>::value>,
+          typename = void>
+auto evaluate(const E& e) -> Optional_bool_vector
+{
+    auto const n = e.size();
+    std::vector<std::uint64_t> validity(detail::words_for(n));
+    std::vector<std::uint64_t> values(validity.size());
+    for (std::size_t w = 0; w < validity.size(); ++w) {
+        validity[w] = e.valid_word(w);
+        values[w] = detail::word_where(
+            w, n, [&e](std::size_t i) { return e.value(i); });
+    }
+    return {n, std::move(validity), std::move(values)};
+}
+
+}  // namespace nullable
+}  // namespace opt
+#endif  // OPTIONAL_NULLABLE_HPP
@@ -0,0 +1,33 @@
+/// \file
+/// \brief C++20 module interface unit exporting the headers in optional.hpp
+/// as module opt.
+///
+/// The standard headers are included in the global module fragment, then the
+/// library headers are included inside an export block, so importers see the
+/// same opt:: declarations as with #include <optional/optional.hpp>.
+///
+/// \code
+/// // GCC 11 or later:
+/// g++ -std=c++20 -fmodules-ts -I<prefix>/include -x c++ -c optional.cppm
+/// // Clang 16 or later:
+/// clang++ -std=c++20 -I<prefix>/include --precompile optional.cppm -o opt.pcm
+///
+/// import opt;
+/// opt::Optional<int> x = opt::none;
+/// \endcode
+///
+/// GCC before 14 does not find placement new from the global module fragment
+/// when an importer instantiates Optional, importers built with it should
+/// also #include <new>.
+module;
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+export module opt;
+
+export {
+#include <optional/optional.hpp>
+}
@@ -0,0 +1,299 @@
+/// \file
+/// \brief Contains the single byte Optional<bool> specialization.
+#ifndef OPTIONAL_BOOL_HPP
+#define OPTIONAL_BOOL_HPP
+#include <new>
+#include <utility>
+
+#include <optional/bad_optional_access.hpp>
+#include <optional/detail/result_sink.hpp>
+#include <optional/none.hpp>
+#include <optional/optional_value.hpp>
+
+namespace opt {
+
+/// \brief Optional<bool> specialization, one byte in size.
+///
+/// The flag and the value share a single byte. An engaged Optional holds a
+/// bool object in that byte, an empty Optional holds a byte value that is not
+/// the object representation of either bool value. The interface is the same
+/// as the primary Optional<T> template.
+template <>
+class Optional<bool> {
+   public:
+    using Value_type = bool;
+
+    /// \brief Default constructs an empty Optional.
+    Optional() noexcept = default;
+
+    /// \brief Constructs an empty Optional.
+    /// \param n    Use opt::none provided in none.hpp.
+    /// \sa none
+    Optional(opt::None_t) noexcept {}
+
+    /// \brief Constructs an initialized Optional holding \p value.
+    Optional(bool value) noexcept { this->construct(value); }
+
+    /// \brief Conditionally constructs an initialized Optional.
+    ///
+    /// If condition is true, *this holds \p value, otherwise it is empty.
+    Optional(bool condition, bool value) noexcept
+    {
+        if (condition)
+            this->construct(value);
+    }
+
+    Optional(const Optional&) noexcept = default;
+
+    /// \brief Move constructs an Optional, \p rhs is left empty.
+    Optional(Optional&& rhs) noexcept : storage_{rhs.storage_}
+    {
+        rhs.destroy();
+    }
+
+    /// \brief Copy constructs from an Optional of a type convertible to bool.
+    template <typename U>
+    explicit Optional(const Optional<U>& rhs)
+    {
+        if (rhs.is_initialized())
+            this->construct(static_cast<bool>(rhs.get()));
+    }
+
+    /// \brief Move constructs from an Optional of a type convertible to bool.
+    ///
+    /// \p rhs is left empty.
+    template <typename U>
+    explicit Optional(Optional<U>&& rhs)
+    {
+        if (rhs.is_initialized()) {
+            this->construct(static_cast<bool>(std::move(rhs.get())));
+            rhs.destroy();
+        }
+    }
+
+    auto operator=(const Optional&) noexcept -> Optional& = default;
+
+    /// \brief Move assignment operator, \p rhs is left empty.
+    auto operator=(Optional&& rhs) noexcept -> Optional&
+    {
+        storage_ = rhs.storage_;
+        if (&rhs != this)
+            rhs.destroy();
+        return *this;
+    }
+
+    /// \brief Converting copy assignment operator.
+    template <typename U>
+    auto operator=(const Optional<U>& rhs) -> Optional&
+    {
+        if (rhs.is_initialized())
+            this->construct(static_cast<bool>(rhs.get()));
+        else
+            this->destroy();
+        return *this;
+    }
+
+    /// \brief Converting move assignment operator, \p rhs is left empty.
+    template <typename U>
+    auto operator=(Optional<U>&& rhs) -> Optional&
+    {
+        if (rhs.is_initialized())
+            this->construct(static_cast<bool>(std::move(rhs.get())));
+        else
+            this->destroy();
+        rhs.destroy();
+        return *this;
+    }
+
+    /// \brief Value assignment operator, *this is left holding \p value.
+    auto operator=(bool value) noexcept -> Optional&
+    {
+        this->construct(value);
+        return *this;
+    }
+
+    /// \brief None_t assignment operator, leaves *this empty.
+    /// \sa none
+    auto operator=(opt::None_t) noexcept -> Optional&
+    {
+        this->destroy();
+        return *this;
+    }
+
+    /// \brief Constructs a bool from \p args inside of *this.
+    template <typename... Args>
+    auto emplace(Args&&... args) -> void
+    {
+        this->construct(bool(std::forward<Args>(args)...));
+    }
+
+    /// \brief Return a reference to the held value.
+    ///
+    /// Undefined if *this is uninitialized.
+    auto get() const -> const bool& { return *this->get_ptr(); }
+
+    /// \brief Return a reference to the held value.
+    ///
+    /// Undefined if *this is uninitialized.
+    auto get() -> bool& { return *this->get_ptr(); }
+
+    /// \brief Pointer to the held value.
+    ///
+    /// Undefined if *this is uninitialized.
+    auto operator-> () const -> const bool* { return this->get_ptr(); }
+
+    /// \brief Pointer to the held value.
+    ///
+    /// Undefined if *this is uninitialized.
+    auto operator-> () -> bool* { return this->get_ptr(); }
+
+    /// \brief Provides direct access to the held value.
+    ///
+    /// Undefined if *this is uninitialized.
+    auto operator*() const& -> const bool& { return this->get(); }
+
+    /// \brief Provides direct access to the held value.
+    ///
+    /// Undefined if *this is uninitialized.
+    auto operator*() & -> bool& { return this->get(); }
+
+    /// \brief Provides direct access to the held value.
+    ///
+    /// Undefined if *this is uninitialized.
+    auto operator*() && -> bool&& { return std::move(this->get()); }
+
+    /// \brief Direct access to the held value, or throw exception.
+    ///
+    /// Throws Bad_optional_access if *this is uninitialized.
+    auto value() const& -> const bool&
+    {
+        if (this->is_initialized())
+            return this->get();
+        throw Bad_optional_access();
+    }
+
+    /// \brief Direct access to the held value, or throw exception.
+    ///
+    /// Throws Bad_optional_access if *this is uninitialized.
+    auto value() & -> bool&
+    {
+        if (this->is_initialized())
+            return this->get();
+        throw Bad_optional_access();
+    }
+
+    /// \brief Direct access to the held value, or throw exception.
+    ///
+    /// Throws Bad_optional_access if *this is uninitialized.
+    auto value() && -> bool&&
+    {
+        if (this->is_initialized())
+            return std::move(this->get());
+        throw Bad_optional_access();
+    }
+
+    /// \returns The held value, or \p val if *this is uninitialized.
+    template <typename U>
+    auto value_or(U&& val) const& -> bool
+    {
+        if (this->is_initialized())
+            return this->get();
+        return val;
+    }
+
+    /// \returns The held value, or \p val if *this is uninitialized. *this is
+    /// left empty.
+    template <typename U>
+    auto value_or(U&& val) && -> bool
+    {
+        if (this->is_initialized()) {
+            bool const result = this->get();
+            this->destroy();
+            return result;
+        }
+        return val;
+    }
+
+    /// \returns The held value, or the result of \p f() if *this is
+    /// uninitialized.
+    template <typename F>
+    auto value_or_eval(F f) const& -> bool
+    {
+        if (this->is_initialized())
+            return this->get();
+        return f();
+    }
+
+    /// \returns The held value, or the result of \p f() if *this is
+    /// uninitialized. *this is left empty.
+    template <typename F>
+    auto value_or_eval(F f) && -> bool
+    {
+        if (this->is_initialized()) {
+            bool const result = this->get();
+            this->destroy();
+            return result;
+        }
+        return f();
+    }
+
+    /// \brief Access to the held value's pointer.
+    auto get_ptr() const -> const bool*
+    {
+        return static_cast<const bool*>(static_cast<const void*>(&storage_));
+    }
+
+    /// \brief Access to the held value's pointer.
+    auto get_ptr() -> bool*
+    {
+        return static_cast<bool*>(static_cast<void*>(&storage_));
+    }
+
+    /// \brief Safe conversion to bool.
+    /// \returns True if object contains a value, false otherwise.
+    explicit operator bool() const noexcept { return this->is_initialized(); }
+
+    /// \returns Opposite of operator bool.
+    bool operator!() const noexcept { return !this->is_initialized(); }
+
+    template <typename U>
+    friend class Optional;
+
+    template <typename U>
+    friend struct detail::Optional_layout;
+
+    template <typename U>
+    friend class detail::Optional_return_object;
+
+   private:
+    // Constructs an empty Optional and calls sink.bind(*this), so \p sink can
+    // later assign the result into it. Only the coroutine return object in
+    // coroutine.hpp uses this.
+    template <typename Sink>
+    Optional(detail::Result_sink_tag, Sink& sink) noexcept
+    {
+        sink.bind(*this);
+    }
+
+    static_assert(sizeof(bool) == 1, "Optional<bool> requires a 1 byte bool.");
+
+    // Neither bool value has this object representation.
+    static constexpr unsigned char empty_byte = 0xFF;
+
+    alignas(bool) unsigned char storage_{empty_byte};
+
+    auto is_initialized() const noexcept -> bool
+    {
+        return storage_ != empty_byte;
+    }
+
+    auto construct(bool value) noexcept -> void
+    {
+        ::new (static_cast<void*>(&storage_)) bool(value);
+    }
+
+    auto destroy() noexcept -> void { storage_ = empty_byte; }
+};
+
+}  // namespace opt
+#endif  // OPTIONAL_BOOL_HPP
@@ -0,0 +1,413 @@
+/// \file
+/// \brief Contains Optional_bool_vector, a packed sequence of three valued
+/// booleans, and Kleene logic over it.
+///
+/// Empty elements are the SQL 'unknown' value. and/or/not follow Kleene's
+/// strong three valued logic: false and unknown is false, true or unknown is
+/// true, any other combination involving unknown is unknown.
+#ifndef OPTIONAL_OPTIONAL_BOOL_VECTOR_HPP
+#define OPTIONAL_OPTIONAL_BOOL_VECTOR_HPP
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include <optional/detail/bit_ops.hpp>
+#include <optional/none.hpp>
+#include <optional/optional_value.hpp>
+
+namespace opt {
+
+/// \returns Kleene conjunction of \p x and \p y.
+inline auto kleene_and(Optional<bool> x, Optional<bool> y) -> Optional<bool>
+{
+    if ((x && !*x) || (y && !*y))
+        return false;
+    if (x && y)
+        return true;
+    return opt::none;
+}
+
+/// \returns Kleene disjunction of \p x and \p y.
+inline auto kleene_or(Optional<bool> x, Optional<bool> y) -> Optional<bool>
+{
+    if ((x && *x) || (y && *y))
+        return true;
+    if (x && y)
+        return false;
+    return opt::none;
+}
+
+/// \returns Kleene negation of \p x, unknown stays unknown.
+inline auto kleene_not(Optional<bool> x) -> Optional<bool>
+{
+    return {bool(x), x && !*x};
+}
+
+namespace detail {
+
+// Word kernels over (validity, value) bitmap pairs. Value bits are only ever
+// set where the validity bit is set, which keeps each result a handful of
+// bitwise operations.
+
+struct Kleene_and_word {
+    static auto valid(std::uint64_t va,
+                      std::uint64_t xa,
+                      std::uint64_t vb,
+                      std::uint64_t xb) -> std::uint64_t
+    {
+        return (va & vb) | (va & ~xa) | (vb & ~xb);
+    }
+
+    static auto value(std::uint64_t xa, std::uint64_t xb) -> std::uint64_t
+    {
+        return xa & xb;
+    }
+
+#if defined(__AVX2__)
+    static auto valid(__m256i va, __m256i xa, __m256i vb, __m256i xb)
+        -> __m256i
+    {
+        return _mm256_or_si256(
+            _mm256_and_si256(va, vb),
+            _mm256_or_si256(_mm256_andnot_si256(xa, va),
+                            _mm256_andnot_si256(xb, vb)));
+    }
+
+    static auto value(__m256i xa, __m256i xb) -> __m256i
+    {
+        return _mm256_and_si256(xa, xb);
+    }
+#endif
+};
+
+struct Kleene_or_word {
+    static auto valid(std::uint64_t va,
+                      std::uint64_t xa,
+                      std::uint64_t vb,
+                      std::uint64_t xb) -> std::uint64_t
+    {
+        return (va & vb) | xa | xb;
+    }
+
+    static auto value(std::uint64_t xa, std::uint64_t xb) -> std::uint64_t
+    {
+        return xa | xb;
+    }
+
+#if defined(__AVX2__)
+    static auto valid(__m256i va, __m256i xa, __m256i vb, __m256i xb)
+        -> __m256i
+    {
+        return _mm256_or_si256(_mm256_and_si256(va, vb),
+                               _mm256_or_si256(xa, xb));
+    }
+
+    static auto value(__m256i xa, __m256i xb) -> __m256i
+    {
+        return _mm256_or_si256(xa, xb);
+    }
+#endif
+};
+
+// Applies Op to \p words words of each bitmap, four words per instruction
+// when AVX2 is enabled at compile time. The outputs may alias the inputs.
+template <typename Op>
+auto kleene_words(const std::uint64_t* va,
+                  const std::uint64_t* xa,
+                  const std::uint64_t* vb,
+                  const std::uint64_t* xb,
+                  std::uint64_t* valid_out,
+                  std::uint64_t* value_out,
+                  std::size_t words) -> void
+{
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    auto load = [](const std::uint64_t* p) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    };
+    for (; i + 4 <= words; i += 4) {
+        auto const v1 = load(va + i);
+        auto const x1 = load(xa + i);
+        auto const v2 = load(vb + i);
+        auto const x2 = load(xb + i);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(valid_out + i),
+                            Op::valid(v1, x1, v2, x2));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(value_out + i),
+                            Op::value(x1, x2));
+    }
+#endif
+    for (; i < words; ++i) {
+        auto const valid = Op::valid(va[i], xa[i], vb[i], xb[i]);
+        value_out[i] = Op::value(xa[i], xb[i]);
+        valid_out[i] = valid;
+    }
+}
+
+}  // namespace detail
+
+/// \brief A sequence of Optional<bool> stored as two bitmaps.
+///
+/// Each element takes two bits, one validity bit and one value bit, instead
+/// of the byte or more used by std::vector<Optional<bool>>. The bitmaps use
+/// the layout of Optional_column: bit i is bit (i % 64) of word i / 64, and
+/// bits past size() are zero. A value bit is never set without its validity
+/// bit, so the bitmaps of equal vectors are identical.
+///
+/// The Kleene operators work on whole words at a time, and on four words at a
+/// time when compiled with AVX2 enabled.
+class Optional_bool_vector {
+   public:
+    using Value_type = bool;
+
+    /// \brief Proxy for a single element, see operator[].
+    class Reference {
+       public:
+        operator Optional<bool>() const { return vec_->get(i_); }
+
+        auto operator=(Optional<bool> x) -> Reference&
+        {
+            vec_->set(i_, x);
+            return *this;
+        }
+
+        auto operator=(const Reference& other) -> Reference&
+        {
+            return *this = Optional<bool>(other);
+        }
+
+       private:
+        Optional_bool_vector* vec_;
+        std::size_t i_;
+
+        Reference(Optional_bool_vector* vec, std::size_t i) : vec_{vec}, i_{i}
+        {}
+
+        friend class Optional_bool_vector;
+    };
+
+    /// Constructs an empty vector.
+    Optional_bool_vector() = default;
+
+    /// Constructs a vector of \p n unknown elements.
+    explicit Optional_bool_vector(std::size_t n)
+        : validity_(detail::words_for(n)), values_(detail::words_for(n)), size_{n}
+    {}
+
+    /// Constructs a vector from a sequence of Optional-like objects.
+    template <typename Iterator>
+    Optional_bool_vector(Iterator first, Iterator last)
+    {
+        for (; first != last; ++first)
+            this->push_back(Optional<bool>(*first));
+    }
+
+    Optional_bool_vector(std::initializer_list<Optional<bool>> init)
+        : Optional_bool_vector(init.begin(), init.end())
+    {}
+
+    /// \brief Constructs a vector of \p n elements from its two bitmaps.
+    ///
+    /// The bitmaps are resized to fit \p n elements, value bits without a
+    /// validity bit and bits past \p n are cleared.
+    Optional_bool_vector(std::size_t n,
+                         std::vector<std::uint64_t> validity,
+                         std::vector<std::uint64_t> values)
+        : validity_{std::move(validity)}, values_{std::move(values)}, size_{n}
+    {
+        validity_.resize(detail::words_for(n));
+        values_.resize(detail::words_for(n));
+        if (n % detail::word_bits != 0)
+            validity_.back() &= detail::low_mask(n % detail::word_bits);
+        for (std::size_t i = 0; i < values_.size(); ++i)
+            values_[i] &= validity_[i];
+    }
+
+    /// \returns The number of elements, including unknown elements.
+    auto size() const noexcept -> std::size_t { return size_; }
+
+    auto empty() const noexcept -> bool { return size_ == 0; }
+
+    /// \returns The number of elements that are true.
+    auto count_true() const noexcept -> std::size_t
+    {
+        return detail::count_bits(values_.data(), size_);
+    }
+
+    /// \returns The number of elements that are false.
+    auto count_false() const noexcept -> std::size_t
+    {
+        return detail::count_bits(validity_.data(), size_) - this->count_true();
+    }
+
+    /// \returns The number of unknown, or empty, elements.
+    auto count_unknown() const noexcept -> std::size_t
+    {
+        return size_ - detail::count_bits(validity_.data(), size_);
+    }
+
+    /// \returns A copy of element \p i.
+    auto get(std::size_t i) const -> Optional<bool>
+    {
+        return {detail::test_bit(validity_.data(), i),
+                detail::test_bit(values_.data(), i)};
+    }
+
+    /// Sets element \p i to \p x, which may be empty.
+    auto set(std::size_t i, Optional<bool> x) -> void
+    {
+        if (x)
+            detail::set_bit(validity_.data(), i);
+        else
+            detail::clear_bit(validity_.data(), i);
+        if (x && *x)
+            detail::set_bit(values_.data(), i);
+        else
+            detail::clear_bit(values_.data(), i);
+    }
+
+    /// \returns A proxy reference to element \p i, convertible to and
+    /// assignable from Optional<bool>.
+    auto operator[](std::size_t i) -> Reference { return {this, i}; }
+
+    /// \returns A copy of element \p i.
+    auto operator[](std::size_t i) const -> Optional<bool>
+    {
+        return this->get(i);
+    }
+
+    /// Appends \p x, which may be empty.
+    auto push_back(Optional<bool> x) -> void
+    {
+        if (size_ % detail::word_bits == 0) {
+            validity_.push_back(0);
+            values_.push_back(0);
+        }
+        this->set(size_++, x);
+    }
+
+    /// Resizes to \p n elements, new elements are unknown.
+    auto resize(std::size_t n) -> void
+    {
+        validity_.resize(detail::words_for(n));
+        values_.resize(detail::words_for(n));
+        if (n < size_ && n % detail::word_bits != 0) {
+            validity_.back() &= detail::low_mask(n % detail::word_bits);
+            values_.back() &= detail::low_mask(n % detail::word_bits);
+        }
+        size_ = n;
+    }
+
+    auto reserve(std::size_t n) -> void
+    {
+        validity_.reserve(detail::words_for(n));
+        values_.reserve(detail::words_for(n));
+    }
+
+    auto clear() -> void
+    {
+        validity_.clear();
+        values_.clear();
+        size_ = 0;
+    }
+
+    /// \returns The validity bitmap words, a bit is set if the element is
+    /// known.
+    auto validity() const noexcept -> const std::uint64_t*
+    {
+        return validity_.data();
+    }
+
+    /// \returns The value bitmap words, a bit is set if the element is true.
+    auto values() const noexcept -> const std::uint64_t*
+    {
+        return values_.data();
+    }
+
+    /// \returns The number of words in each bitmap.
+    auto word_count() const noexcept -> std::size_t { return validity_.size(); }
+
+    /// \brief Element wise Kleene and, in place.
+    ///
+    /// Throws std::invalid_argument if the sizes differ.
+    auto operator&=(const Optional_bool_vector& other) -> Optional_bool_vector&
+    {
+        return this->apply<detail::Kleene_and_word>(other);
+    }
+
+    /// \brief Element wise Kleene or, in place.
+    ///
+    /// Throws std::invalid_argument if the sizes differ.
+    auto operator|=(const Optional_bool_vector& other) -> Optional_bool_vector&
+    {
+        return this->apply<detail::Kleene_or_word>(other);
+    }
+
+    /// \brief Element wise Kleene not, unknown elements stay unknown.
+    auto operator~() const -> Optional_bool_vector
+    {
+        auto result = *this;
+        for (std::size_t i = 0; i < values_.size(); ++i)
+            result.values_[i] = validity_[i] & ~values_[i];
+        return result;
+    }
+
+    friend auto operator==(const Optional_bool_vector& x,
+                           const Optional_bool_vector& y) -> bool
+    {
+        return x.size_ == y.size_ && x.validity_ == y.validity_ &&
+               x.values_ == y.values_;
+    }
+
+    friend auto operator!=(const Optional_bool_vector& x,
+                           const Optional_bool_vector& y) -> bool
+    {
+        return !(x == y);
+    }
+
+   private:
+    std::vector<std::uint64_t> validity_;
+    std::vector<std::uint64_t> values_;
+    std::size_t size_{0};
+
+    template <typename Op>
+    auto apply(const Optional_bool_vector& other) -> Optional_bool_vector&
+    {
+        if (size_ != other.size_)
+            throw std::invalid_argument{"Optional_bool_vector size mismatch."};
+        detail::kleene_words<Op>(validity_.data(), values_.data(),
+                                 other.validity_.data(), other.values_.data(),
+                                 validity_.data(), values_.data(),
+                                 validity_.size());
+        return *this;
+    }
+};
+
+/// \brief Element wise Kleene and.
+///
+/// Throws std::invalid_argument if the sizes differ.
+inline auto operator&(Optional_bool_vector x, const Optional_bool_vector& y)
+    -> Optional_bool_vector
+{
+    x &= y;
+    return x;
+}
+
+/// \brief Element wise Kleene or.
+///
+/// Throws std::invalid_argument if the sizes differ.
+inline auto operator|(Optional_bool_vector x, const Optional_bool_vector& y)
+    -> Optional_bool_vector
+{
+    x |= y;
+    return x;
+}
+
+}  // namespace opt
+#endif  // OPTIONAL_OPTIONAL_BOOL_VECTOR_HPP
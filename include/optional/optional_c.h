@@ -0,0 +1,162 @@
+/**
+ * \file
+ * \brief C declarations with the memory layout of opt::Optional, for passing
+ * optionals across C, Rust and Python boundaries without copying.
+ *
+ * Optional<T>, for arithmetic and other trivially copyable standard layout T,
+ * is laid out as the C struct
+ *
+ * \code
+ * struct { T value; bool engaged; };
+ * \endcode
+ *
+ * value is indeterminate when engaged is false. This is the layout of the
+ * Rust type
+ *
+ * \code
+ * #[repr(C)]
+ * struct OptionalI64 { value: core::mem::MaybeUninit<i64>, engaged: bool }
+ * \endcode
+ *
+ * Optional<T&> is a single T*, null when empty, the layout of Rust's
+ * Option<&T>, so it crosses the boundary as a plain pointer.
+ *
+ * Optional<bool> is one byte: 0 false, 1 true, OPT_C_BOOL_EMPTY empty.
+ *
+ * c_abi.hpp checks these layouts with static_assert and converts arrays of
+ * Optional to arrays of the structs below in place.
+ *
+ * OPT_C_DEFINE_OPTIONAL(name, T) declares the struct `name` for another
+ * trivially copyable T, with these inline functions:
+ * - name_some(value), name_none()
+ * - name_has_value(x), name_value_or(x, fallback)
+ * - name_count(xs, n): the number of engaged elements.
+ * - name_values_or(xs, n, fallback, out): each value, or fallback, into out.
+ * - name_compact(xs, n, out): the engaged values into out, returns the count.
+ * - name_validity(xs, n, words): the engaged flags as a validity bitmap of
+ *   (n + 63) / 64 words, bit i of words[i / 64] set if xs[i] is engaged, the
+ *   layout of Optional_column and of Arrow.
+ */
+#ifndef OPTIONAL_OPTIONAL_C_H
+#define OPTIONAL_OPTIONAL_C_H
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#ifndef __cplusplus
+#include <stdbool.h>
+#endif
+
+#define OPT_C_DEFINE_OPTIONAL(NAME, T)                                       \
+    typedef struct NAME {                                                    \
+        T value;                                                             \
+        bool engaged;                                                        \
+    } NAME;                                                                  \
+                                                                             \
+    static inline NAME NAME##_some(T value)                                  \
+    {                                                                        \
+        NAME x;                                                              \
+        memset(&x, 0, sizeof(x));                                            \
+        x.value = value;                                                     \
+        x.engaged = true;                                                    \
+        return x;                                                            \
+    }                                                                        \
+                                                                             \
+    static inline NAME NAME##_none(void)                                     \
+    {                                                                        \
+        NAME x;                                                              \
+        memset(&x, 0, sizeof(x));                                            \
+        return x;                                                            \
+    }                                                                        \
+                                                                             \
+    static inline bool NAME##_has_value(const NAME* x) { return x->engaged; } \
+                                                                             \
+    static inline T NAME##_value_or(const NAME* x, T fallback)               \
+    {                                                                        \
+        return x->engaged ? x->value : fallback;                             \
+    }                                                                        \
+                                                                             \
+    static inline size_t NAME##_count(const NAME* xs, size_t n)              \
+    {                                                                        \
+        size_t count = 0;                                                    \
+        size_t i;                                                            \
+        for (i = 0; i < n; ++i)                                              \
+            count += xs[i].engaged;                                          \
+        return count;                                                        \
+    }                                                                        \
+                                                                             \
+    static inline void NAME##_values_or(const NAME* xs, size_t n,            \
+                                        T fallback, T* out)                  \
+    {                                                                        \
+        size_t i;                                                            \
+        for (i = 0; i < n; ++i)                                              \
+            out[i] = xs[i].engaged ? xs[i].value : fallback;                 \
+    }                                                                        \
+                                                                             \
+    static inline size_t NAME##_compact(const NAME* xs, size_t n, T* out)    \
+    {                                                                        \
+        size_t count = 0;                                                    \
+        size_t i;                                                            \
+        for (i = 0; i < n; ++i) {                                            \
+            if (xs[i].engaged)                                               \
+                out[count++] = xs[i].value;                                  \
+        }                                                                    \
+        return count;                                                        \
+    }                                                                        \
+                                                                             \
+    static inline void NAME##_validity(const NAME* xs, size_t n,             \
+                                       uint64_t* words)                      \
+    {                                                                        \
+        size_t i;                                                            \
+        memset(words, 0, (n + 63) / 64 * sizeof(uint64_t));                  \
+        for (i = 0; i < n; ++i)                                              \
+            words[i / 64] |= (uint64_t)xs[i].engaged << (i % 64);            \
+    }
+
+/* X(name, T) for every Optional<T> declared here. */
+#define OPT_C_ARITHMETIC_TYPES(X)  \
+    X(opt_optional_int8, int8_t)     \
+    X(opt_optional_uint8, uint8_t)   \
+    X(opt_optional_int16, int16_t)   \
+    X(opt_optional_uint16, uint16_t) \
+    X(opt_optional_int32, int32_t)   \
+    X(opt_optional_uint32, uint32_t) \
+    X(opt_optional_int64, int64_t)   \
+    X(opt_optional_uint64, uint64_t) \
+    X(opt_optional_float, float)     \
+    X(opt_optional_double, double)
+
+OPT_C_ARITHMETIC_TYPES(OPT_C_DEFINE_OPTIONAL)
+
+#define OPT_C_BOOL_EMPTY 0xFF
+
+/** Optional<bool>, one byte. */
+typedef struct opt_optional_bool {
+    uint8_t state;
+} opt_optional_bool;
+
+static inline opt_optional_bool opt_optional_bool_some(bool value)
+{
+    opt_optional_bool x;
+    x.state = value ? 1 : 0;
+    return x;
+}
+
+static inline opt_optional_bool opt_optional_bool_none(void)
+{
+    opt_optional_bool x;
+    x.state = OPT_C_BOOL_EMPTY;
+    return x;
+}
+
+static inline bool opt_optional_bool_has_value(const opt_optional_bool* x)
+{
+    return x->state != OPT_C_BOOL_EMPTY;
+}
+
+static inline bool opt_optional_bool_value_or(const opt_optional_bool* x,
+                                              bool fallback)
+{
+    return x->state == OPT_C_BOOL_EMPTY ? fallback : x->state != 0;
+}
+
+#endif /* OPTIONAL_OPTIONAL_C_H */
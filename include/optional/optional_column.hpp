@@ -0,0 +1,193 @@
+/// \file
+/// \brief Contains the Optional_column class, a bitmap backed array of
+/// optional values.
+#ifndef OPTIONAL_OPTIONAL_COLUMN_HPP
+#define OPTIONAL_OPTIONAL_COLUMN_HPP
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <optional/detail/bit_ops.hpp>
+#include <optional/none.hpp>
+#include <optional/optional_reference.hpp>
+#include <optional/optional_value.hpp>
+
+namespace opt {
+
+/// \brief A sequence of optional T stored as a dense value array plus a
+/// validity bitmap.
+///
+/// Compared to std::vector<Optional<T>>, there is no per element flag or
+/// padding, and empty regions can be skipped a word of the bitmap at a time.
+/// Slots of empty elements hold value initialized T objects, so T must be
+/// default constructible.
+///
+/// Bit i of the bitmap is bit (i % 64) of validity()[i / 64]. Bits past size()
+/// are always zero.
+template <typename T>
+class Optional_column {
+    static_assert(!std::is_same<T, bool>::value,
+                  "Use Optional_bool_vector for a column of optional bools.");
+
+   public:
+    using Value_type = T;
+
+    /// Constructs an empty column.
+    Optional_column() = default;
+
+    /// Constructs a column of \p n empty elements.
+    explicit Optional_column(std::size_t n)
+        : values_(n), validity_(detail::words_for(n)), size_{n}
+    {}
+
+    /// Constructs a column from a sequence of Optional-like objects.
+    template <typename Iterator>
+    Optional_column(Iterator first, Iterator last)
+    {
+        for (; first != last; ++first) {
+            auto&& x = *first;
+            if (x)
+                this->push_back(*x);
+            else
+                this->push_back(opt::none);
+        }
+    }
+
+    Optional_column(std::initializer_list<Optional<T>> init)
+        : Optional_column(init.begin(), init.end())
+    {}
+
+    /// \returns The number of elements, engaged or not.
+    auto size() const noexcept -> std::size_t { return size_; }
+
+    auto empty() const noexcept -> bool { return size_ == 0; }
+
+    /// \returns The number of engaged elements.
+    auto count_engaged() const noexcept -> std::size_t
+    {
+        return detail::count_bits(validity_.data(), size_);
+    }
+
+    auto is_engaged(std::size_t i) const -> bool
+    {
+        return detail::test_bit(validity_.data(), i);
+    }
+
+    /// \returns A reference to element \p i, or empty if it is not engaged.
+    auto operator[](std::size_t i) -> Optional<T&>
+    {
+        return {this->is_engaged(i), values_[i]};
+    }
+
+    /// \returns A reference to element \p i, or empty if it is not engaged.
+    auto operator[](std::size_t i) const -> Optional<const T&>
+    {
+        return {this->is_engaged(i), values_[i]};
+    }
+
+    /// Appends an element, engaged if \p value is.
+    auto push_back(const Optional<T>& value) -> void
+    {
+        if (value)
+            this->push_back(*value);
+        else
+            this->push_back(opt::none);
+    }
+
+    auto push_back(const T& value) -> void
+    {
+        this->grow();
+        values_.push_back(value);
+        detail::set_bit(validity_.data(), size_++);
+    }
+
+    auto push_back(T&& value) -> void
+    {
+        this->grow();
+        values_.push_back(std::move(value));
+        detail::set_bit(validity_.data(), size_++);
+    }
+
+    auto push_back(opt::None_t) -> void
+    {
+        this->grow();
+        values_.emplace_back();
+        ++size_;
+    }
+
+    /// Engages element \p i with \p value.
+    auto set(std::size_t i, T value) -> void
+    {
+        values_[i] = std::move(value);
+        detail::set_bit(validity_.data(), i);
+    }
+
+    /// Empties element \p i, its slot is reset to a value initialized T.
+    auto reset(std::size_t i) -> void
+    {
+        values_[i] = T{};
+        detail::clear_bit(validity_.data(), i);
+    }
+
+    /// Resizes to \p n elements, new elements are empty.
+    auto resize(std::size_t n) -> void
+    {
+        values_.resize(n);
+        validity_.resize(detail::words_for(n));
+        if (n < size_ && n % detail::word_bits != 0)
+            validity_.back() &= detail::low_mask(n % detail::word_bits);
+        size_ = n;
+    }
+
+    auto reserve(std::size_t n) -> void
+    {
+        values_.reserve(n);
+        validity_.reserve(detail::words_for(n));
+    }
+
+    auto clear() -> void
+    {
+        values_.clear();
+        validity_.clear();
+        size_ = 0;
+    }
+
+    /// \returns The value array, including the slots of empty elements.
+    auto data() noexcept -> T* { return values_.data(); }
+    auto data() const noexcept -> const T* { return values_.data(); }
+
+    /// \returns The validity bitmap words.
+    auto validity() noexcept -> std::uint64_t* { return validity_.data(); }
+    auto validity() const noexcept -> const std::uint64_t*
+    {
+        return validity_.data();
+    }
+
+    /// \returns The number of words in the validity bitmap.
+    auto word_count() const noexcept -> std::size_t { return validity_.size(); }
+
+    /// \returns The number of bytes allocated for values and the bitmap,
+    /// counting reserved capacity.
+    auto memory_usage() const noexcept -> std::size_t
+    {
+        return values_.capacity() * sizeof(T) +
+               validity_.capacity() * sizeof(std::uint64_t);
+    }
+
+   private:
+    std::vector<T> values_;
+    std::vector<std::uint64_t> validity_;
+    std::size_t size_{0};
+
+    auto grow() -> void
+    {
+        if (size_ % detail::word_bits == 0)
+            validity_.push_back(0);
+    }
+};
+
+}  // namespace opt
+#endif  // OPTIONAL_OPTIONAL_COLUMN_HPP
@@ -0,0 +1,389 @@
+/// \file
+/// \brief Contains Optional_flat_map, an open addressing hash map whose
+/// buckets are Optional<std::pair<K, V>> slots.
+#ifndef OPTIONAL_OPTIONAL_FLAT_MAP_HPP
+#define OPTIONAL_OPTIONAL_FLAT_MAP_HPP
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+#include <optional/detail/bit_ops.hpp>
+#include <optional/hash.hpp>
+#include <optional/none.hpp>
+#include <optional/optional_reference.hpp>
+#include <optional/optional_value.hpp>
+
+namespace opt {
+namespace detail {
+
+// Control byte of an empty slot. A full slot holds 7 bits of its key's hash,
+// so empty is the only negative control byte.
+constexpr std::int8_t empty_ctrl = -128;
+
+// Slots examined per probe step.
+constexpr std::size_t group_size = 16;
+
+// Sixteen consecutive control bytes, compared against a tag at once.
+class Ctrl_group {
+   public:
+#if defined(__SSE2__) || defined(_M_X64)
+    explicit Ctrl_group(const std::int8_t* ctrl)
+        : bytes_{_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl))}
+    {}
+
+    // Bit i set if byte i equals tag.
+    auto match(std::int8_t tag) const -> std::uint32_t
+    {
+        return static_cast<std::uint32_t>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(bytes_, _mm_set1_epi8(tag))));
+    }
+
+    // Bit i set if slot i is empty.
+    auto match_empty() const -> std::uint32_t
+    {
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(bytes_));
+    }
+
+   private:
+    __m128i bytes_;
+#else
+    explicit Ctrl_group(const std::int8_t* ctrl) : ctrl_{ctrl} {}
+
+    auto match(std::int8_t tag) const -> std::uint32_t
+    {
+        std::uint32_t bits = 0;
+        for (std::size_t i = 0; i < group_size; ++i)
+            bits |= std::uint32_t{ctrl_[i] == tag} << i;
+        return bits;
+    }
+
+    auto match_empty() const -> std::uint32_t
+    {
+        return this->match(empty_ctrl);
+    }
+
+   private:
+    const std::int8_t* ctrl_;
+#endif
+};
+
+// Spreads the entropy of weak hashes, such as std::hash<int>, across all
+// bits before they are split into a slot index and a tag.
+inline auto mix_hash(std::size_t h) -> std::uint64_t
+{
+    auto const x = static_cast<std::uint64_t>(h) * 0x9E3779B97F4A7C15ull;
+    return x ^ (x >> 32);
+}
+
+}  // namespace detail
+
+/// \brief Hash map storing its entries in a flat array of optional slots.
+///
+/// Collisions are resolved by linear probing. Each slot has a control byte,
+/// either empty or 7 bits of the key's hash, and a lookup compares sixteen
+/// control bytes at a time with SSE2 before comparing any keys. Erasing shifts
+/// the following entries of the probe run back, so there are no tombstones
+/// and lookups never slow down after deletions.
+///
+/// Inserting may rehash, which invalidates iterators and references. Erasing
+/// may move other entries, which invalidates references to them.
+template <typename K,
+          typename V,
+          typename Hash = opt::hash<K>,
+          typename Key_equal = std::equal_to<K>>
+class Optional_flat_map {
+    template <bool Const>
+    class Basic_iterator;
+
+   public:
+    using Key_type = K;
+    using Mapped_type = V;
+    using Value_type = std::pair<K, V>;
+    using Iterator = Basic_iterator<false>;
+    using Const_iterator = Basic_iterator<true>;
+
+    /// Constructs an empty map, no memory is allocated.
+    Optional_flat_map() = default;
+
+    /// Constructs an empty map with room for \p n entries.
+    explicit Optional_flat_map(std::size_t n) { this->reserve(n); }
+
+    Optional_flat_map(std::initializer_list<Value_type> init)
+    {
+        this->reserve(init.size());
+        for (auto const& kv : init)
+            this->insert(kv.first, kv.second);
+    }
+
+    auto size() const noexcept -> std::size_t { return size_; }
+
+    auto empty() const noexcept -> bool { return size_ == 0; }
+
+    /// \returns The number of slots.
+    auto capacity() const noexcept -> std::size_t { return slots_.size(); }
+
+    /// \returns A reference to the value mapped to \p key, or empty.
+    auto find(const K& key) -> Optional<V&>
+    {
+        auto const i = this->index_of(key);
+        if (i == npos)
+            return opt::none;
+        return slots_[i]->second;
+    }
+
+    /// \returns A reference to the value mapped to \p key, or empty.
+    auto find(const K& key) const -> Optional<const V&>
+    {
+        auto const i = this->index_of(key);
+        if (i == npos)
+            return opt::none;
+        return slots_[i]->second;
+    }
+
+    auto contains(const K& key) const -> bool
+    {
+        return this->index_of(key) != npos;
+    }
+
+    /// \brief Inserts \p key mapped to \p value, unless \p key is present.
+    /// \returns True if the entry was inserted.
+    auto insert(K key, V value) -> bool
+    {
+        if (this->index_of(key) != npos)
+            return false;
+        this->insert_new(std::move(key), std::move(value));
+        return true;
+    }
+
+    /// \brief Maps \p key to \p value, replacing any existing value.
+    /// \returns True if the key was not present.
+    auto insert_or_assign(K key, V value) -> bool
+    {
+        auto const i = this->index_of(key);
+        if (i != npos) {
+            slots_[i]->second = std::move(value);
+            return false;
+        }
+        this->insert_new(std::move(key), std::move(value));
+        return true;
+    }
+
+    /// \returns The value mapped to \p key, inserting a value initialized V
+    /// first if \p key is not present.
+    auto operator[](const K& key) -> V&
+    {
+        auto const i = this->index_of(key);
+        if (i != npos)
+            return slots_[i]->second;
+        return slots_[this->insert_new(key, V{})]->second;
+    }
+
+    /// \brief Removes \p key, shifting later entries of its probe run back.
+    /// \returns True if \p key was present.
+    auto erase(const K& key) -> bool
+    {
+        auto i = this->index_of(key);
+        if (i == npos)
+            return false;
+        slots_[i] = opt::none;
+        this->set_ctrl(i, detail::empty_ctrl);
+        for (auto j = (i + 1) & mask_; ctrl_[j] != detail::empty_ctrl;
+             j = (j + 1) & mask_) {
+            auto const home = this->home_of(slots_[j]->first);
+            // Move the entry back if the gap is between its home and j.
+            if (((j - home) & mask_) >= ((j - i) & mask_)) {
+                slots_[i] = std::move(slots_[j]);
+                slots_[j] = opt::none;
+                this->set_ctrl(i, ctrl_[j]);
+                this->set_ctrl(j, detail::empty_ctrl);
+                i = j;
+            }
+        }
+        --size_;
+        return true;
+    }
+
+    /// Removes all entries, keeping the capacity.
+    auto clear() -> void
+    {
+        for (auto& slot : slots_)
+            slot = opt::none;
+        std::fill(ctrl_.begin(), ctrl_.end(), detail::empty_ctrl);
+        size_ = 0;
+    }
+
+    /// Makes room for \p n entries without rehashing.
+    auto reserve(std::size_t n) -> void
+    {
+        std::size_t capacity = detail::group_size;
+        while (capacity - capacity / 8 < n)
+            capacity *= 2;
+        if (capacity > slots_.size())
+            this->rehash(capacity);
+    }
+
+    auto begin() -> Iterator { return {this, this->first_full(0)}; }
+    auto end() -> Iterator { return {this, slots_.size()}; }
+    auto begin() const -> Const_iterator { return {this, this->first_full(0)}; }
+    auto end() const -> Const_iterator { return {this, slots_.size()}; }
+
+   private:
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    std::vector<Optional<Value_type>> slots_;
+    // One byte per slot, then the first group_size - 1 bytes again, so a
+    // group can be loaded from any slot without wrapping.
+    std::vector<std::int8_t> ctrl_;
+    std::size_t size_{0};
+    std::size_t mask_{0};
+    Hash hash_;
+    Key_equal equal_;
+
+    static auto tag_of(std::uint64_t h) -> std::int8_t
+    {
+        return static_cast<std::int8_t>(h & 0x7F);
+    }
+
+    auto home_of(const K& key) const -> std::size_t
+    {
+        return static_cast<std::size_t>(detail::mix_hash(hash_(key)) >> 7) &
+               mask_;
+    }
+
+    auto set_ctrl(std::size_t i, std::int8_t c) -> void
+    {
+        ctrl_[i] = c;
+        if (i < detail::group_size - 1)
+            ctrl_[slots_.size() + i] = c;
+    }
+
+    auto index_of(const K& key) const -> std::size_t
+    {
+        if (slots_.empty())
+            return npos;
+        auto const h = detail::mix_hash(hash_(key));
+        auto const tag = tag_of(h);
+        auto pos = static_cast<std::size_t>(h >> 7) & mask_;
+        for (;;) {
+            detail::Ctrl_group const group{ctrl_.data() + pos};
+            for (auto m = group.match(tag); m != 0; m &= m - 1) {
+                auto const i = (pos + detail::countr_zero(m)) & mask_;
+                if (equal_(slots_[i]->first, key))
+                    return i;
+            }
+            if (group.match_empty() != 0)
+                return npos;
+            pos = (pos + detail::group_size) & mask_;
+        }
+    }
+
+    // Inserts a key known to be absent, growing first if needed.
+    auto insert_new(K key, V value) -> std::size_t
+    {
+        if (size_ + 1 > slots_.size() - slots_.size() / 8)
+            this->rehash(slots_.empty() ? detail::group_size
+                                        : slots_.size() * 2);
+        auto const h = detail::mix_hash(hash_(key));
+        auto pos = static_cast<std::size_t>(h >> 7) & mask_;
+        for (;;) {
+            auto const empty =
+                detail::Ctrl_group{ctrl_.data() + pos}.match_empty();
+            if (empty != 0) {
+                auto const i = (pos + detail::countr_zero(empty)) & mask_;
+                slots_[i].emplace(std::move(key), std::move(value));
+                this->set_ctrl(i, tag_of(h));
+                ++size_;
+                return i;
+            }
+            pos = (pos + detail::group_size) & mask_;
+        }
+    }
+
+    auto rehash(std::size_t capacity) -> void
+    {
+        auto old = std::move(slots_);
+        slots_ = std::vector<Optional<Value_type>>(capacity);
+        ctrl_.assign(capacity + detail::group_size - 1, detail::empty_ctrl);
+        mask_ = capacity - 1;
+        size_ = 0;
+        for (auto& slot : old) {
+            if (slot)
+                this->insert_new(std::move(slot->first),
+                                 std::move(slot->second));
+        }
+    }
+
+    auto first_full(std::size_t i) const -> std::size_t
+    {
+        while (i < slots_.size() && ctrl_[i] == detail::empty_ctrl)
+            ++i;
+        return i;
+    }
+
+    /// Forward iterator over the entries, yielding pairs of references.
+    template <bool Const>
+    class Basic_iterator {
+        using Map = std::conditional_t<Const,
+                                       const Optional_flat_map,
+                                       Optional_flat_map>;
+        using Mapped_ref = std::conditional_t<Const, const V&, V&>;
+
+       public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::pair<K, V>;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::pair<const K&, Mapped_ref>;
+        using pointer = void;
+
+        Basic_iterator() = default;
+
+        Basic_iterator(Map* map, std::size_t i) : map_{map}, i_{i} {}
+
+        auto operator*() const -> reference
+        {
+            auto& kv = *map_->slots_[i_];
+            return {kv.first, kv.second};
+        }
+
+        auto operator++() -> Basic_iterator&
+        {
+            i_ = map_->first_full(i_ + 1);
+            return *this;
+        }
+
+        auto operator++(int) -> Basic_iterator
+        {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        friend auto operator==(const Basic_iterator& x,
+                               const Basic_iterator& y) -> bool
+        {
+            return x.i_ == y.i_;
+        }
+
+        friend auto operator!=(const Basic_iterator& x,
+                               const Basic_iterator& y) -> bool
+        {
+            return x.i_ != y.i_;
+        }
+
+       private:
+        Map* map_{nullptr};
+        std::size_t i_{0};
+    };
+};
+
+}  // namespace opt
+#endif  // OPTIONAL_OPTIONAL_FLAT_MAP_HPP
@@ -1,19 +1,71 @@
 #ifndef OPTIONAL_FREE_FUNCTIONS_HPP
 #define OPTIONAL_FREE_FUNCTIONS_HPP
+#include <type_traits>
+
 #include <optional/optional_value.hpp>
 
 namespace opt {
+namespace detail {
+
+// Arithmetic and enum payloads are cheap to compare unconditionally, so the
+// comparisons below combine the flags arithmetically instead of branching.
+template <typename T>
+using Is_flag_comparable =
+    std::integral_constant<bool,
+                           std::is_arithmetic<T>::value ||
+                               std::is_enum<T>::value>;
+
+// The payload of x, or a value initialized T if x is empty. Written as a
+// select so the optimiser can if-convert it, GCC does at -O3 but may keep the
+// branch at -O2. compare_n in algorithm.hpp does not rely on this.
+template <typename T>
+T payload_or_zero(const Optional<T>& x) {
+    return x ? *x : T{};
+}
+
+template <typename T>
+bool equal(const Optional<T>& x, const Optional<T>& y, std::true_type) {
+    const bool xe = bool(x);
+    const bool ye = bool(y);
+    const bool values_equal = payload_or_zero(x) == payload_or_zero(y);
+    return (xe == ye) & (!xe | values_equal);
+}
+
+template <typename T>
+bool equal(const Optional<T>& x, const Optional<T>& y, std::false_type) {
+    if (x && y) {
+        return *x == *y;
+    }
+    return !x && !y;
+}
+
+template <typename T>
+bool less(const Optional<T>& x, const Optional<T>& y, std::true_type) {
+    const bool values_less = payload_or_zero(x) < payload_or_zero(y);
+    return bool(y) & (!x | values_less);
+}
+
+template <typename T>
+bool less(const Optional<T>& x, const Optional<T>& y, std::false_type) {
+    if (!y) {
+        return false;
+    }
+    if (!x) {
+        return true;
+    }
+    return *x < *y;
+}
+
+}  // namespace detail
 
 /// T must have operator== defined.
 /// \returns If both x and y are initialized, (*x == *y).
 /// \returns If only x _or_ y is initialized, false.
 /// \returns If both are uninitialized, true.
+/// Arithmetic and enum payloads are compared without branches.
 template <typename T>
 bool operator==(const Optional<T>& x, const Optional<T>& y) {
-    if (x && y) {
-        return *x == *y;
-    }
-    return !x && !y;
+    return detail::equal(x, y, detail::Is_flag_comparable<T>{});
 }
 
 /// \returns !(x == y).
@@ -26,15 +78,10 @@ bool operator!=(const Optional<T>& x, const Optional<T>& y) {
 /// \returns If both are initialized, *x < *y.
 /// \returns If y is empty, false.
 /// \returns If x and y are both empty, true.
+/// Arithmetic and enum payloads are compared without branches.
 template <typename T>
 bool operator<(const Optional<T>& x, const Optional<T>& y) {
-    if (!y) {
-        return false;
-    }
-    if (!x) {
-        return true;
-    }
-    return *x < *y;
+    return detail::less(x, y, detail::Is_flag_comparable<T>{});
 }
 
 /// \returns y < x
@@ -9,7 +9,10 @@
 
 namespace opt {
 
-/// Reference Specialization
+/// \brief Reference Specialization
+///
+/// Holds a single pointer, null when empty, so it has the layout of T* and
+/// of Rust's Option<&T>.
 template <typename T>
 class Optional<T&> {
    private:
@@ -49,9 +52,7 @@ class Optional<T&> {
     }
 
     Optional& operator=(opt::None_t) noexcept {
-        if (initialized_) {
-            this->destroy();
-        }
+        this->destroy();
         return *this;
     }
 
@@ -120,26 +121,19 @@ class Optional<T&> {
 
     T* get_ptr() const noexcept { return ref_; }
 
-    explicit operator bool() const noexcept { return initialized_; }
+    explicit operator bool() const noexcept { return ref_ != nullptr; }
 
-    bool operator!() const noexcept { return !initialized_; }
+    bool operator!() const noexcept { return ref_ == nullptr; }
 
    private:
-    bool initialized_{false};
     T* ref_{nullptr};
 
     template <typename R>
     void construct(R&& value) noexcept {
         ref_ = &value;
-        initialized_ = true;
     }
 
-    void destroy() noexcept {
-        if (initialized_) {
-            ref_ = nullptr;
-            initialized_ = false;
-        }
-    }
+    void destroy() noexcept { ref_ = nullptr; }
 };
 
 }  // namespace opt
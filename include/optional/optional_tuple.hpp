@@ -0,0 +1,313 @@
+/// \file
+/// \brief Contains Optional_tuple, a fixed set of optional fields sharing a
+/// single presence bitmask.
+#ifndef OPTIONAL_OPTIONAL_TUPLE_HPP
+#define OPTIONAL_OPTIONAL_TUPLE_HPP
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <optional/detail/bit_ops.hpp>
+#include <optional/detail/conjunction.hpp>
+#include <optional/none.hpp>
+#include <optional/optional_reference.hpp>
+#include <optional/optional_value.hpp>
+
+namespace opt {
+namespace detail {
+
+// Smallest unsigned type with a bit per field.
+template <std::size_t N>
+using Presence_mask_t = std::conditional_t<
+    N <= 8,
+    std::uint8_t,
+    std::conditional_t<N <= 16,
+                       std::uint16_t,
+                       std::conditional_t<N <= 32, std::uint32_t, std::uint64_t>>>;
+
+template <std::size_t N>
+struct Tuple_layout {
+    std::size_t offset[N];
+    std::size_t size;
+    std::size_t align;
+};
+
+// Places the fields in decreasing order of alignment. Sizes are multiples of
+// alignments, which are powers of two, so no padding is needed between them.
+template <typename... Ts>
+constexpr auto tuple_layout() -> Tuple_layout<sizeof...(Ts)>
+{
+    constexpr std::size_t n = sizeof...(Ts);
+    constexpr std::size_t sizes[] = {sizeof(Ts)...};
+    constexpr std::size_t aligns[] = {alignof(Ts)...};
+    Tuple_layout<n> layout{};
+    for (std::size_t i = 0; i < n; ++i) {
+        if (aligns[i] > layout.align)
+            layout.align = aligns[i];
+    }
+    for (auto align = layout.align; align != 0; align /= 2) {
+        for (std::size_t i = 0; i < n; ++i) {
+            if (aligns[i] == align) {
+                layout.offset[i] = layout.size;
+                layout.size += sizes[i];
+            }
+        }
+    }
+    return layout;
+}
+
+// Raw field storage and presence bits, trivially copyable. Copying and
+// destroying the fields is left to Tuple_base.
+template <typename... Ts>
+class Tuple_storage {
+   public:
+    using Mask = Presence_mask_t<sizeof...(Ts)>;
+
+    template <std::size_t I>
+    using Element_t = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+    auto has(std::size_t i) const noexcept -> bool
+    {
+        return (mask_ >> i) & 1u;
+    }
+
+    template <std::size_t I>
+    auto ptr() noexcept -> Element_t<I>*
+    {
+        constexpr auto offset = tuple_layout<Ts...>().offset[I];
+        return reinterpret_cast<Element_t<I>*>(data_ + offset);
+    }
+
+    template <std::size_t I>
+    auto ptr() const noexcept -> const Element_t<I>*
+    {
+        constexpr auto offset = tuple_layout<Ts...>().offset[I];
+        return reinterpret_cast<const Element_t<I>*>(data_ + offset);
+    }
+
+    // Field I must not be present.
+    template <std::size_t I, typename... Args>
+    auto construct(Args&&... args) -> void
+    {
+        ::new (static_cast<void*>(this->template ptr<I>()))
+            Element_t<I>(std::forward<Args>(args)...);
+        mask_ = static_cast<Mask>(mask_ | Mask{1} << I);
+    }
+
+    // Field I must be present.
+    template <std::size_t I>
+    auto destroy() noexcept -> void
+    {
+        this->template ptr<I>()->~Element_t<I>();
+        mask_ = static_cast<Mask>(mask_ & ~(Mask{1} << I));
+    }
+
+    template <std::size_t I>
+    auto reset_field() noexcept -> void
+    {
+        if (this->has(I))
+            this->template destroy<I>();
+    }
+
+    template <std::size_t I, typename U>
+    auto assign_field(U&& value) -> void
+    {
+        if (this->has(I))
+            *this->template ptr<I>() = std::forward<U>(value);
+        else
+            this->template construct<I>(std::forward<U>(value));
+    }
+
+    template <std::size_t... Is>
+    auto reset_all(std::index_sequence<Is...>) noexcept -> void
+    {
+        using Expand = int[];
+        (void)Expand{0, (this->template reset_field<Is>(), 0)...};
+    }
+
+    template <std::size_t... Is>
+    auto copy_from(const Tuple_storage& rhs, std::index_sequence<Is...>)
+        -> void
+    {
+        using Expand = int[];
+        (void)Expand{0, (rhs.has(Is) ? this->template assign_field<Is>(
+                                           *rhs.template ptr<Is>())
+                                     : this->template reset_field<Is>(),
+                         0)...};
+    }
+
+    template <std::size_t... Is>
+    auto move_from(Tuple_storage& rhs, std::index_sequence<Is...>) -> void
+    {
+        using Expand = int[];
+        (void)Expand{0, (rhs.has(Is) ? this->template assign_field<Is>(
+                                           std::move(*rhs.template ptr<Is>()))
+                                     : this->template reset_field<Is>(),
+                         0)...};
+    }
+
+    // The fields come first, so the mask only adds tail padding.
+    alignas(tuple_layout<Ts...>().align) unsigned char
+        data_[tuple_layout<Ts...>().size];
+    Mask mask_{0};
+};
+
+template <bool Trivial, typename... Ts>
+class Tuple_base : public Tuple_storage<Ts...> {};
+
+template <typename... Ts>
+class Tuple_base<false, Ts...> : public Tuple_storage<Ts...> {
+    using Indices = std::index_sequence_for<Ts...>;
+
+   public:
+    Tuple_base() = default;
+
+    Tuple_base(const Tuple_base& rhs) { this->copy_from(rhs, Indices{}); }
+
+    Tuple_base(Tuple_base&& rhs) noexcept(
+        Conjunction<std::is_nothrow_move_constructible<Ts>...>::value)
+    {
+        this->move_from(rhs, Indices{});
+    }
+
+    auto operator=(const Tuple_base& rhs) -> Tuple_base&
+    {
+        if (this != &rhs)
+            this->copy_from(rhs, Indices{});
+        return *this;
+    }
+
+    auto operator=(Tuple_base&& rhs) -> Tuple_base&
+    {
+        if (this != &rhs)
+            this->move_from(rhs, Indices{});
+        return *this;
+    }
+
+    ~Tuple_base() { this->reset_all(Indices{}); }
+};
+
+}  // namespace detail
+
+/// \brief A fixed set of optional fields of types Ts, with one presence bit
+/// per field.
+///
+/// A struct of Optional<T> members spends a flag and its alignment padding on
+/// every field. Optional_tuple keeps all the flags in one bitmask and packs
+/// the fields without padding, ordered by decreasing alignment. Field indices
+/// are the positions in Ts regardless of the storage order.
+///
+/// Optional_tuple is trivially copyable when every T is.
+///
+/// \code
+/// opt::Optional_tuple<std::int8_t, double, std::int32_t> t;
+/// t.emplace<1>(2.5);
+/// if (auto d = t.get<1>())
+///     *d += 1;
+/// \endcode
+template <typename... Ts>
+class Optional_tuple
+    : private detail::Tuple_base<
+          detail::Conjunction<std::is_trivially_copyable<Ts>...>::value,
+          Ts...> {
+    static_assert(sizeof...(Ts) >= 1 && sizeof...(Ts) <= 64,
+                  "Optional_tuple holds between 1 and 64 fields.");
+    static_assert(detail::Conjunction<std::is_object<Ts>...>::value,
+                  "Optional_tuple fields must be object types.");
+
+    using Storage = detail::Tuple_storage<Ts...>;
+
+   public:
+    /// Unsigned integer with bit I set if field I is present.
+    using Mask = typename Storage::Mask;
+
+    template <std::size_t I>
+    using Element_t = typename Storage::template Element_t<I>;
+
+    /// Constructs a tuple with every field empty.
+    Optional_tuple() = default;
+
+    /// \returns The number of fields.
+    static constexpr auto size() noexcept -> std::size_t
+    {
+        return sizeof...(Ts);
+    }
+
+    /// \returns True if field \p I holds a value.
+    template <std::size_t I>
+    auto has() const noexcept -> bool
+    {
+        return this->Storage::has(I);
+    }
+
+    /// \returns A reference to field \p I, or empty if it holds no value.
+    template <std::size_t I>
+    auto get() -> Optional<Element_t<I>&>
+    {
+        if (!this->Storage::has(I))
+            return opt::none;
+        return *this->Storage::template ptr<I>();
+    }
+
+    /// \returns A reference to field \p I, or empty if it holds no value.
+    template <std::size_t I>
+    auto get() const -> Optional<const Element_t<I>&>
+    {
+        if (!this->Storage::has(I))
+            return opt::none;
+        return *this->Storage::template ptr<I>();
+    }
+
+    /// \brief Constructs field \p I from \p args, destroying its previous
+    /// value first.
+    template <std::size_t I, typename... Args>
+    auto emplace(Args&&... args) -> void
+    {
+        this->Storage::template reset_field<I>();
+        this->Storage::template construct<I>(std::forward<Args>(args)...);
+    }
+
+    /// Destroys the value of field \p I, if any.
+    template <std::size_t I>
+    auto reset() noexcept -> void
+    {
+        this->Storage::template reset_field<I>();
+    }
+
+    /// Destroys the values of all fields.
+    auto reset() noexcept -> void
+    {
+        this->Storage::reset_all(std::index_sequence_for<Ts...>{});
+    }
+
+    /// \returns The number of fields holding a value.
+    auto present_count() const noexcept -> std::size_t
+    {
+        return static_cast<std::size_t>(detail::popcount(this->mask_));
+    }
+
+    /// \returns The presence bitmask, bit I is set if field I holds a value.
+    auto presence() const noexcept -> Mask { return this->mask_; }
+};
+
+/// \returns t.get<I>()
+template <std::size_t I, typename... Ts>
+auto get(Optional_tuple<Ts...>& t)
+    -> Optional<typename Optional_tuple<Ts...>::template Element_t<I>&>
+{
+    return t.template get<I>();
+}
+
+/// \returns t.get<I>()
+template <std::size_t I, typename... Ts>
+auto get(const Optional_tuple<Ts...>& t)
+    -> Optional<const typename Optional_tuple<Ts...>::template Element_t<I>&>
+{
+    return t.template get<I>();
+}
+
+}  // namespace opt
+#endif  // OPTIONAL_OPTIONAL_TUPLE_HPP
@@ -1,15 +1,22 @@
 #ifndef OPTIONAL_VALUE_HPP
 #define OPTIONAL_VALUE_HPP
 #include <new>
-#include <type_traits>
 #include <utility>
 
 #include <optional/bad_optional_access.hpp>
 #include <optional/detail/aligned_storage.hpp>
-#include <optional/detail/conjunction.hpp>
+#include <optional/detail/result_sink.hpp>
+#include <optional/detail/traits.hpp>
 #include <optional/none.hpp>
 
 namespace opt {
+namespace detail {
+
+// Exposes the member offsets of Optional<T>, see c_abi.hpp.
+template <typename T>
+struct Optional_layout;
+
+}  // namespace detail
 
 /// \brief Wraps a type to provide an optional 'null', or empty state.
 ///
@@ -30,60 +37,58 @@ class Optional {
     template <typename X>
     static constexpr auto is_nt_d_cc_ca() -> bool
     {
-        return detail::Conjunction<std::is_nothrow_destructible<X>,
-                                   std::is_nothrow_copy_constructible<X>,
-                                   std::is_nothrow_copy_assignable<X>>::value;
+        return detail::nothrow_destructible<X> &&
+               detail::nothrow_constructible<X, const X&> &&
+               detail::nothrow_assignable<X&, const X&>;
     }
 
     template <typename X>
     static constexpr auto is_nt_d_mc_ma() -> bool
     {
-        return detail::Conjunction<std::is_nothrow_destructible<X>,
-                                   std::is_nothrow_move_constructible<X>,
-                                   std::is_nothrow_move_assignable<X>>::value;
+        return detail::nothrow_destructible<X> &&
+               detail::nothrow_constructible<X, X&&> &&
+               detail::nothrow_assignable<X&, X&&>;
     }
 
     template <typename X, typename Y>
     static constexpr auto is_nt_d_cc_a() -> bool
     {
-        return detail::Conjunction<
-            std::is_nothrow_destructible<X>,
-            std::is_nothrow_copy_constructible<X>,
-            std::is_nothrow_assignable<X, const Y&>>::value;
+        return detail::nothrow_destructible<X> &&
+               detail::nothrow_constructible<X, const X&> &&
+               detail::nothrow_assignable<X, const Y&>;
     }
 
     template <typename X, typename Y>
     static constexpr auto is_nt_d_mc_a() -> bool
     {
-        return detail::Conjunction<std::is_nothrow_destructible<X>,
-                                   std::is_nothrow_move_constructible<X>,
-                                   std::is_nothrow_assignable<X, Y&&>>::value;
+        return detail::nothrow_destructible<X> &&
+               detail::nothrow_constructible<X, X&&> &&
+               detail::nothrow_assignable<X, Y&&>;
     }
 
     template <typename X, typename... Args>
     static constexpr auto is_nt_d_c() -> bool
     {
-        return detail::Conjunction<
-            std::is_nothrow_destructible<X>,
-            std::is_nothrow_constructible<X, Args...>>::value;
+        return detail::nothrow_destructible<X> &&
+               detail::nothrow_constructible<X, Args...>;
     }
 
     template <typename X>
     static constexpr auto is_nt_cc() -> bool
     {
-        return std::is_nothrow_copy_constructible<X>::value;
+        return detail::nothrow_constructible<X, const X&>;
     }
 
     template <typename X>
     static constexpr auto is_nt_mc() -> bool
     {
-        return std::is_nothrow_move_constructible<X>::value;
+        return detail::nothrow_constructible<X, X&&>;
     }
 
     template <typename X>
     static constexpr auto is_nt_d() -> bool
     {
-        return std::is_nothrow_destructible<X>::value;
+        return detail::nothrow_destructible<X>;
     }
 
    public:
@@ -175,9 +180,9 @@ class Optional {
     /// \param rhs  Object to be copied into *this.
     template <typename U>
     explicit Optional(const Optional<U>& rhs) noexcept(
-        std::is_nothrow_constructible<T, const U&>::value)
+        detail::nothrow_constructible<T, const U&>)
     {
-        if (rhs.initialized_)
+        if (rhs.is_initialized())
             this->construct(rhs.get());
     }
 
@@ -189,11 +194,11 @@ class Optional {
     /// \param rhs  Object to be moved into *this.
     template <typename U>
     explicit Optional(Optional<U>&& rhs) noexcept(
-        std::is_nothrow_constructible<T, U&&>::value)
+        detail::nothrow_constructible<T, U&&>)
     {
-        if (rhs.initialized_) {
+        if (rhs.is_initialized()) {
             this->construct(std::move(rhs.get()));
-            rhs.initialized_ = false;
+            rhs.destroy();
         }
     }
 
@@ -265,7 +270,7 @@ class Optional {
             this->construct(std::move(rhs.get()));
         else if (!rhs.is_initialized())
             this->destroy();
-        rhs.initialized_ = false;
+        rhs.destroy();
         return *this;
     }
 
@@ -487,9 +492,26 @@ class Optional {
     template <typename U>
     friend class Optional;
 
+    template <typename U>
+    friend struct detail::Optional_layout;
+
+    template <typename U>
+    friend class detail::Optional_return_object;
+
    private:
-    bool initialized_{false};
+    // Constructs an empty Optional and calls sink.bind(*this), so \p sink can
+    // later assign the result into it. Only the coroutine return object in
+    // coroutine.hpp uses this.
+    template <typename Sink>
+    Optional(detail::Result_sink_tag, Sink& sink) noexcept : initialized_{false}
+    {
+        sink.bind(*this);
+    }
+
+    // The payload comes first, so it sits at the address of the Optional.
+    // Aligned_optional relies on this to align the payload itself.
     opt::detail::Aligned_storage<T> storage_;
+    bool initialized_{false};
 
     auto is_initialized() const -> bool { return initialized_; }
 
@@ -522,4 +544,7 @@ class Optional {
 };
 
 }  // namespace opt
+
+// Optional<bool> must be visible wherever Optional<T> is.
+#include <optional/optional_bool.hpp>
 #endif  // OPTIONAL_VALUE_HPP
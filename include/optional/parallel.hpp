@@ -0,0 +1,458 @@
+/// \file
+/// \brief Parallel reductions and transforms over sequences of optionals.
+///
+/// Work is split into chunks of about 64KiB of elements, each chunk produces
+/// its own partial result, and chunks are scheduled on a small work stealing
+/// Thread_pool. Partial results are combined in chunk order, so results do not
+/// depend on scheduling.
+///
+/// \code
+/// std::vector<Optional<double>> v = ...;
+/// auto sum = opt::par::reduce_engaged(v.begin(), v.end(), 0.0, std::plus<>{});
+/// auto n = opt::par::count_engaged(v.begin(), v.end());
+/// auto mean = n == 0 ? 0.0 : sum / n;
+/// \endcode
+#ifndef OPTIONAL_PARALLEL_HPP
+#define OPTIONAL_PARALLEL_HPP
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <optional/none.hpp>
+#include <optional/optional_value.hpp>
+
+namespace opt {
+namespace par {
+
+/// \brief Fixed size pool of worker threads for fork-join loops.
+///
+/// run(n, f) calls f(i) for every i in [0, n). Task indices are dealt out in
+/// contiguous blocks, one per participant, and participants that run out of
+/// work steal half of the remaining block of another. The calling thread
+/// participates, so a pool with zero workers runs everything inline, as does
+/// a run() called from inside a task of the same pool.
+class Thread_pool {
+   public:
+    /// Creates \p workers threads in addition to the calling thread.
+    explicit Thread_pool(std::size_t workers = default_workers())
+    {
+        for (std::size_t i = 0; i <= workers; ++i)
+            queues_.push_back(std::make_unique<Queue>());
+        for (std::size_t i = 0; i < workers; ++i)
+            threads_.emplace_back([this, i] { this->worker_loop(i + 1); });
+    }
+
+    Thread_pool(const Thread_pool&) = delete;
+    auto operator=(const Thread_pool&) -> Thread_pool& = delete;
+
+    ~Thread_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock{wake_mtx_};
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (auto& t : threads_)
+            t.join();
+    }
+
+    /// \returns The number of threads taking part in run(), including the
+    /// calling thread.
+    auto concurrency() const noexcept -> std::size_t { return queues_.size(); }
+
+    /// \brief Calls f(i) for each i in [0, n), blocking until all are done.
+    ///
+    /// Concurrent calls to run() are serialised. A nested call, made by a
+    /// task of this pool, runs its tasks inline on the calling thread. If any
+    /// f(i) throws, the remaining tasks are skipped and the first exception is
+    /// rethrown.
+    template <typename F>
+    auto run(std::size_t n, F&& f) -> void
+    {
+        if (n == 0)
+            return;
+        if (n == 1 || threads_.empty() || active() == this) {
+            for (std::size_t i = 0; i < n; ++i)
+                f(i);
+            return;
+        }
+        std::lock_guard<std::mutex> job_lock{job_mtx_};
+        Active_scope const scope{this};
+        auto const participants = queues_.size();
+        for (std::size_t p = 0; p < participants; ++p) {
+            std::lock_guard<std::mutex> lock{queues_[p]->mtx};
+            queues_[p]->begin = n * p / participants;
+            queues_[p]->end = n * (p + 1) / participants;
+        }
+        remaining_.store(n);
+        error_ = nullptr;
+        failed_.store(false);
+        {
+            std::lock_guard<std::mutex> lock{wake_mtx_};
+            job_ = &call<std::remove_reference_t<F>>;
+            job_context_ = std::addressof(f);
+            open_ = true;
+            ++generation_;
+        }
+        wake_.notify_all();
+
+        this->work(0);
+        while (remaining_.load() != 0)
+            std::this_thread::yield();
+        {
+            std::lock_guard<std::mutex> lock{wake_mtx_};
+            open_ = false;
+        }
+        while (busy_.load() != 0)
+            std::this_thread::yield();
+        if (error_)
+            std::rethrow_exception(error_);
+    }
+
+    /// \returns One less than the hardware concurrency, at least zero.
+    static auto default_workers() -> std::size_t
+    {
+        auto const n = std::thread::hardware_concurrency();
+        return n > 1 ? n - 1 : 0;
+    }
+
+   private:
+    struct Queue {
+        std::mutex mtx;
+        std::size_t begin{0};
+        std::size_t end{0};
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> threads_;
+    std::mutex job_mtx_;
+
+    std::mutex wake_mtx_;
+    std::condition_variable wake_;
+    bool stop_{false};
+    bool open_{false};
+    std::size_t generation_{0};
+    void (*job_)(const void*, std::size_t){nullptr};
+    const void* job_context_{nullptr};
+
+    std::atomic<std::size_t> remaining_{0};
+    std::atomic<std::size_t> busy_{0};
+    std::atomic<bool> failed_{false};
+    std::mutex error_mtx_;
+    std::exception_ptr error_;
+
+    // F carries the constness of the functor passed to run(), so the cast
+    // only restores the type it had there.
+    template <typename F>
+    static auto call(const void* f, std::size_t i) -> void
+    {
+        (*static_cast<F*>(const_cast<void*>(f)))(i);
+    }
+
+    // The pool whose tasks the calling thread is running, if any.
+    static auto active() noexcept -> const Thread_pool*&
+    {
+        thread_local const Thread_pool* pool = nullptr;
+        return pool;
+    }
+
+    class Active_scope {
+       public:
+        explicit Active_scope(const Thread_pool* pool) noexcept
+            : previous_{active()}
+        {
+            active() = pool;
+        }
+
+        Active_scope(const Active_scope&) = delete;
+        auto operator=(const Active_scope&) -> Active_scope& = delete;
+
+        ~Active_scope() { active() = previous_; }
+
+       private:
+        const Thread_pool* previous_;
+    };
+
+    auto worker_loop(std::size_t index) -> void
+    {
+        Active_scope const scope{this};
+        std::size_t seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock{wake_mtx_};
+                wake_.wait(lock, [&] {
+                    return stop_ || (open_ && generation_ != seen);
+                });
+                if (stop_)
+                    return;
+                seen = generation_;
+                ++busy_;
+            }
+            this->work(index);
+            --busy_;
+        }
+    }
+
+    // Runs tasks from the participant's own queue, then steals until no
+    // queue has work left. At most one queue lock is held at a time.
+    auto work(std::size_t index) -> void
+    {
+        auto& own = *queues_[index];
+        for (;;) {
+            std::size_t task;
+            bool has_task;
+            {
+                std::lock_guard<std::mutex> lock{own.mtx};
+                task = own.begin;
+                has_task = own.begin != own.end;
+                if (has_task)
+                    ++own.begin;
+            }
+            if (!has_task) {
+                std::size_t end;
+                if (!this->steal(index, task, end))
+                    return;
+                std::lock_guard<std::mutex> lock{own.mtx};
+                own.begin = task + 1;
+                own.end = end;
+            }
+            this->execute(task);
+        }
+    }
+
+    // Takes the back half of another participant's block as [begin, end).
+    // \returns False if every queue is empty.
+    auto steal(std::size_t index, std::size_t& begin, std::size_t& end) -> bool
+    {
+        auto const n = queues_.size();
+        for (std::size_t k = 1; k < n; ++k) {
+            auto& victim = *queues_[(index + k) % n];
+            std::lock_guard<std::mutex> lock{victim.mtx};
+            auto const available = victim.end - victim.begin;
+            if (available == 0)
+                continue;
+            begin = victim.end - (available + 1) / 2;
+            end = victim.end;
+            victim.end = begin;
+            return true;
+        }
+        return false;
+    }
+
+    auto execute(std::size_t task) -> void
+    {
+        if (!failed_.load(std::memory_order_relaxed)) {
+            try {
+                job_(job_context_, task);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock{error_mtx_};
+                if (!failed_.exchange(true))
+                    error_ = std::current_exception();
+            }
+        }
+        --remaining_;
+    }
+};
+
+/// \returns The process wide pool used when no pool is given.
+inline auto default_pool() -> Thread_pool&
+{
+    static Thread_pool pool;
+    return pool;
+}
+
+namespace detail {
+
+// Chunks cover about 64KiB of elements so that each fits in L2 cache.
+constexpr std::size_t chunk_bytes = 64 * 1024;
+
+template <typename Iterator>
+constexpr auto chunk_size() -> std::size_t
+{
+    using Element = typename std::iterator_traits<Iterator>::value_type;
+    return chunk_bytes / sizeof(Element) == 0 ? 1
+                                              : chunk_bytes / sizeof(Element);
+}
+
+// Calls f(begin, end) for each chunk of [0, n), in parallel.
+template <typename Iterator, typename F>
+auto for_each_chunk(Thread_pool& pool, std::size_t n, F f) -> void
+{
+    auto const chunk = chunk_size<Iterator>();
+    auto const chunks = (n + chunk - 1) / chunk;
+    pool.run(chunks, [&](std::size_t c) {
+        f(c * chunk, std::min(n, (c + 1) * chunk));
+    });
+}
+
+template <typename Iterator>
+using Payload_t = std::decay_t<decltype(**std::declval<Iterator&>())>;
+
+}  // namespace detail
+
+/// \brief Reduces the engaged elements of [first, last) with \p op.
+///
+/// \p op must be associative, it is applied to the engaged values of each
+/// chunk in order and then to the chunk results, starting from \p init.
+/// \returns \p init if no element is engaged.
+template <typename Iterator, typename T, typename Op>
+auto reduce_engaged(Thread_pool& pool,
+                    Iterator first,
+                    Iterator last,
+                    T init,
+                    Op op) -> T
+{
+    auto const n = static_cast<std::size_t>(std::distance(first, last));
+    auto const chunk = detail::chunk_size<Iterator>();
+    std::vector<Optional<T>> partials((n + chunk - 1) / chunk);
+    detail::for_each_chunk<Iterator>(
+        pool, n, [&](std::size_t begin, std::size_t end) {
+            auto it = first + begin;
+            auto const stop = first + end;
+            for (; it != stop && !*it; ++it) {}
+            if (it == stop)
+                return;
+            T acc = **it;
+            for (++it; it != stop; ++it) {
+                if (*it)
+                    acc = op(acc, **it);
+            }
+            partials[begin / chunk] = std::move(acc);
+        });
+    for (auto& p : partials) {
+        if (p)
+            init = op(std::move(init), std::move(*p));
+    }
+    return init;
+}
+
+template <typename Iterator, typename T, typename Op>
+auto reduce_engaged(Iterator first, Iterator last, T init, Op op) -> T
+{
+    return par::reduce_engaged(default_pool(), first, last, std::move(init),
+                               std::move(op));
+}
+
+/// \returns The number of engaged elements in [first, last).
+template <typename Iterator>
+auto count_engaged(Thread_pool& pool, Iterator first, Iterator last)
+    -> std::size_t
+{
+    auto const n = static_cast<std::size_t>(std::distance(first, last));
+    std::atomic<std::size_t> total{0};
+    detail::for_each_chunk<Iterator>(
+        pool, n, [&](std::size_t begin, std::size_t end) {
+            std::size_t count = 0;
+            for (auto it = first + begin; it != first + end; ++it)
+                count += bool(*it) ? 1 : 0;
+            total.fetch_add(count, std::memory_order_relaxed);
+        });
+    return total.load();
+}
+
+template <typename Iterator>
+auto count_engaged(Iterator first, Iterator last) -> std::size_t
+{
+    return par::count_engaged(default_pool(), first, last);
+}
+
+/// \brief Writes Optional(f(*x)) for each engaged x in [first, last), and
+/// opt::none for each empty x, to the range beginning at \p d_first.
+/// \returns The end of the output range.
+template <typename Iterator, typename Output_iterator, typename F>
+auto transform_engaged(Thread_pool& pool,
+                       Iterator first,
+                       Iterator last,
+                       Output_iterator d_first,
+                       F f) -> Output_iterator
+{
+    auto const n = static_cast<std::size_t>(std::distance(first, last));
+    detail::for_each_chunk<Iterator>(
+        pool, n, [&](std::size_t begin, std::size_t end) {
+            auto out = d_first + begin;
+            for (auto it = first + begin; it != first + end; ++it, ++out) {
+                if (*it)
+                    *out = f(**it);
+                else
+                    *out = opt::none;
+            }
+        });
+    return d_first + n;
+}
+
+template <typename Iterator, typename Output_iterator, typename F>
+auto transform_engaged(Iterator first,
+                       Iterator last,
+                       Output_iterator d_first,
+                       F f) -> Output_iterator
+{
+    return par::transform_engaged(default_pool(), first, last, d_first,
+                                  std::move(f));
+}
+
+/// \brief Moves the engaged elements of [first, last) to the front, keeping
+/// their relative order, and leaves the remaining elements empty.
+///
+/// Uses a temporary buffer holding the engaged values.
+/// \returns An iterator to the first empty element.
+template <typename Iterator>
+auto partition_engaged(Thread_pool& pool, Iterator first, Iterator last)
+    -> Iterator
+{
+    using Value = detail::Payload_t<Iterator>;
+    auto const n = static_cast<std::size_t>(std::distance(first, last));
+    auto const chunk = detail::chunk_size<Iterator>();
+    auto const chunks = (n + chunk - 1) / chunk;
+
+    std::vector<std::size_t> offsets(chunks + 1, 0);
+    detail::for_each_chunk<Iterator>(
+        pool, n, [&](std::size_t begin, std::size_t end) {
+            std::size_t count = 0;
+            for (auto it = first + begin; it != first + end; ++it)
+                count += bool(*it) ? 1 : 0;
+            offsets[begin / chunk + 1] = count;
+        });
+    for (std::size_t c = 0; c < chunks; ++c)
+        offsets[c + 1] += offsets[c];
+    auto const engaged = offsets[chunks];
+
+    std::vector<Optional<Value>> buffer(engaged);
+    detail::for_each_chunk<Iterator>(
+        pool, n, [&](std::size_t begin, std::size_t end) {
+            auto out = offsets[begin / chunk];
+            for (auto it = first + begin; it != first + end; ++it) {
+                if (*it)
+                    buffer[out++].emplace(std::move(**it));
+            }
+        });
+    detail::for_each_chunk<Iterator>(
+        pool, n, [&](std::size_t begin, std::size_t end) {
+            for (auto i = begin; i < end; ++i) {
+                if (i < engaged)
+                    first[i] = std::move(*buffer[i]);
+                else
+                    first[i] = opt::none;
+            }
+        });
+    return first + engaged;
+}
+
+template <typename Iterator>
+auto partition_engaged(Iterator first, Iterator last) -> Iterator
+{
+    return par::partition_engaged(default_pool(), first, last);
+}
+
+}  // namespace par
+}  // namespace opt
+#endif  // OPTIONAL_PARALLEL_HPP
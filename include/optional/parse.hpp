@@ -0,0 +1,401 @@
+/// \file
+/// \brief Parsing text into Optional values without exceptions.
+///
+/// opt::parse<T> accepts the whole of its input or nothing: leading or
+/// trailing characters, including whitespace, give an empty result, as do
+/// values out of range for T.
+///
+/// \code
+/// opt::Optional<int> i = opt::parse<int>("-42");
+/// opt::Optional<double> d = opt::parse<double>(field);
+/// opt::Optional_column<int> c = opt::parse_column<int>("1,,3", ',');
+/// \endcode
+///
+/// Enums are parsed by name once registered by specializing Enum_names:
+/// \code
+/// template <>
+/// struct opt::Enum_names<Color> {
+///     static auto values() -> std::array<opt::Enum_name<Color>, 2>
+///     {
+///         return {{{"red", Color::red}, {"green", Color::green}}};
+///     }
+/// };
+/// \endcode
+#ifndef OPTIONAL_PARSE_HPP
+#define OPTIONAL_PARSE_HPP
+#include <cerrno>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <type_traits>
+
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#if __has_include(<string_view>)
+#include <string_view>
+#endif
+#endif
+
+#include <optional/checked.hpp>
+#include <optional/none.hpp>
+#include <optional/optional_column.hpp>
+#include <optional/optional_value.hpp>
+
+namespace opt {
+
+/// A name and enumerator pair registered through Enum_names.
+template <typename E>
+struct Enum_name {
+    const char* name;
+    E value;
+};
+
+/// \brief Specialize with a static values() function returning a range of
+/// Enum_name<E> to make E parsable by name.
+template <typename E>
+struct Enum_names;
+
+namespace detail {
+
+template <typename T>
+auto parse_integer(const char* first, const char* last, std::true_type)
+    -> Optional<T>
+{
+    bool const negative = first != last && *first == '-';
+    if (first != last && (*first == '-' || *first == '+'))
+        ++first;
+    if (first == last)
+        return opt::none;
+    T r = 0;
+    for (; first != last; ++first) {
+        auto const digit = static_cast<unsigned>(*first - '0');
+        if (digit > 9)
+            return opt::none;
+        // Accumulating negative values reaches the minimum of T.
+        auto const d = static_cast<T>(digit);
+        if (mul_overflow(r, T{10}, r) ||
+            (negative ? sub_overflow(r, d, r) : add_overflow(r, d, r)))
+            return opt::none;
+    }
+    return r;
+}
+
+template <typename T>
+auto parse_integer(const char* first, const char* last, std::false_type)
+    -> Optional<T>
+{
+    if (first != last && *first == '+')
+        ++first;
+    if (first == last)
+        return opt::none;
+    T r = 0;
+    for (; first != last; ++first) {
+        auto const digit = static_cast<unsigned>(*first - '0');
+        if (digit > 9)
+            return opt::none;
+        if (mul_overflow(r, T{10}, r) ||
+            add_overflow(r, static_cast<T>(digit), r))
+            return opt::none;
+    }
+    return r;
+}
+
+#if defined(__cpp_lib_to_chars)
+
+template <typename T>
+auto parse_floating(const char* first, const char* last) -> Optional<T>
+{
+    // from_chars takes no '+', but does take a '-' after the one skipped.
+    if (first != last && *first == '+') {
+        ++first;
+        if (first != last && (*first == '-' || *first == '+'))
+            return opt::none;
+    }
+    T r;
+    auto const result = std::from_chars(first, last, r);
+    return {result.ec == std::errc{} && result.ptr == last, r};
+}
+
+#else
+
+template <typename T>
+auto strto(const char* s, char** end) -> T;
+
+template <>
+inline auto strto<float>(const char* s, char** end) -> float
+{
+    return std::strtof(s, end);
+}
+
+template <>
+inline auto strto<double>(const char* s, char** end) -> double
+{
+    return std::strtod(s, end);
+}
+
+template <>
+inline auto strto<long double>(const char* s, char** end) -> long double
+{
+    return std::strtold(s, end);
+}
+
+// Exact powers of ten, used while the result is exactly representable.
+inline auto exact_power_of_ten(int e) -> double
+{
+    static constexpr double powers[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    return powers[e];
+}
+
+// Decimal strings whose digits and power of ten are both exact in T are
+// computed with a single correctly rounded multiplication or division.
+// Everything else, including inf and nan, goes through strtod, which honours
+// the C locale's decimal point.
+template <typename T>
+auto parse_floating(const char* first, const char* last) -> Optional<T>
+{
+    auto const begin = first;
+    bool const negative = first != last && *first == '-';
+    if (first != last && (*first == '-' || *first == '+'))
+        ++first;
+    std::uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool seen_digit = false;
+    bool exact = true;
+    for (bool point = false; first != last; ++first) {
+        if (*first == '.' && !point) {
+            point = true;
+            continue;
+        }
+        auto const digit = static_cast<unsigned>(*first - '0');
+        if (digit > 9)
+            break;
+        seen_digit = true;
+        if (mantissa == 0 && digit == 0) {
+            exponent -= point;
+            continue;
+        }
+        if (++digits > 19)
+            exact = false;
+        else
+            mantissa = mantissa * 10 + digit;
+        exponent += (digits > 19) - point;
+    }
+    if (seen_digit && first != last && (*first == 'e' || *first == 'E')) {
+        auto const e = parse_integer<int>(first + 1, last, std::true_type{});
+        if (!e || *e > 10000 || *e < -10000)
+            exact = false;
+        else
+            exponent += *e;
+        first = last;
+    }
+    constexpr int bits = std::numeric_limits<T>::digits;
+    constexpr auto max_exact = bits < 64 ? std::uint64_t{1} << (bits % 64)
+                                         : ~std::uint64_t{0};
+    constexpr int max_power = std::numeric_limits<T>::digits > 24 ? 22 : 10;
+    if (seen_digit && first == last && exact && mantissa <= max_exact &&
+        exponent <= max_power && exponent >= -max_power) {
+        auto const m = static_cast<T>(mantissa);
+        auto const p = static_cast<T>(exact_power_of_ten(std::abs(exponent)));
+        auto const r = exponent < 0 ? m / p : m * p;
+        return negative ? -r : r;
+    }
+    if (first != last && seen_digit)
+        return opt::none;
+
+    auto const n = static_cast<std::size_t>(last - begin);
+    char local[64];
+    std::string heap;
+    const char* s = local;
+    if (n < sizeof(local)) {
+        std::memcpy(local, begin, n);
+        local[n] = '\0';
+    }
+    else {
+        heap.assign(begin, n);
+        s = heap.c_str();
+    }
+    // strtod also accepts leading whitespace and hexadecimal floats.
+    for (std::size_t i = 0; i < n; ++i) {
+        if (s[i] == 'x' || s[i] == 'X' || s[i] == ' ' ||
+            (s[i] >= '\t' && s[i] <= '\r'))
+            return opt::none;
+    }
+    char* end = nullptr;
+    errno = 0;
+    T const r = strto<T>(s, &end);
+    return {n != 0 && end == s + n && errno != ERANGE, r};
+}
+
+#endif
+
+template <typename T>
+auto parse(const char* first, const char* last, std::true_type) -> Optional<T>
+{
+    return parse_integer<T>(first, last, std::is_signed<T>{});
+}
+
+template <typename T>
+auto parse(const char* first, const char* last, std::false_type)
+    -> Optional<T>
+{
+    return parse_floating<T>(first, last);
+}
+
+inline auto equal(const char* first, const char* last, const char* name)
+    -> bool
+{
+    auto const n = static_cast<std::size_t>(last - first);
+    return std::strlen(name) == n && std::memcmp(first, name, n) == 0;
+}
+
+template <typename T>
+struct Parse_kind
+    : std::integral_constant<int,
+                             std::is_same<T, bool>::value   ? 0
+                             : std::is_arithmetic<T>::value ? 1
+                             : std::is_enum<T>::value       ? 2
+                                                            : 3> {};
+
+template <typename T>
+auto parse(const char* first,
+           const char* last,
+           std::integral_constant<int, 0>) -> Optional<bool>
+{
+    if (equal(first, last, "true") || equal(first, last, "1"))
+        return true;
+    if (equal(first, last, "false") || equal(first, last, "0"))
+        return false;
+    return opt::none;
+}
+
+template <typename T>
+auto parse(const char* first,
+           const char* last,
+           std::integral_constant<int, 1>) -> Optional<T>
+{
+    return parse<T>(first, last, std::is_integral<T>{});
+}
+
+template <typename T>
+auto parse(const char* first,
+           const char* last,
+           std::integral_constant<int, 2>) -> Optional<T>
+{
+    for (auto const& entry : Enum_names<T>::values()) {
+        if (equal(first, last, entry.name))
+            return entry.value;
+    }
+    return opt::none;
+}
+
+}  // namespace detail
+
+/// \brief Parses [first, last) as a T.
+///
+/// Integers are decimal with an optional sign. Floating point values use the
+/// std::from_chars general format, with an optional leading '+'. bool accepts
+/// "true", "false", "1" and "0". Enums must be registered with Enum_names.
+/// \returns The parsed value, or empty if the text is not a valid T.
+template <typename T>
+auto parse(const char* first, const char* last) -> Optional<T>
+{
+    static_assert(detail::Parse_kind<T>::value != 3,
+                  "parse supports arithmetic types and registered enums.");
+    return detail::parse<T>(first, last, detail::Parse_kind<T>{});
+}
+
+/// \brief Parses a null terminated string as a T.
+/// \sa parse(const char*, const char*)
+template <typename T>
+auto parse(const char* s) -> Optional<T>
+{
+    return opt::parse<T>(s, s + std::strlen(s));
+}
+
+/// \brief Parses a std::string as a T.
+/// \sa parse(const char*, const char*)
+template <typename T>
+auto parse(const std::string& s) -> Optional<T>
+{
+    return opt::parse<T>(s.data(), s.data() + s.size());
+}
+
+#if defined(__cpp_lib_string_view)
+/// \brief Parses a std::string_view as a T.
+/// \sa parse(const char*, const char*)
+template <typename T>
+auto parse(std::string_view s) -> Optional<T>
+{
+    return opt::parse<T>(s.data(), s.data() + s.size());
+}
+#endif
+
+/// \brief Parses each \p delimiter separated field of [first, last).
+///
+/// Fields that are empty or fail to parse become empty elements. A trailing
+/// delimiter ends with an empty field, an empty buffer has no fields.
+template <typename T>
+auto parse_column(const char* first, const char* last, char delimiter)
+    -> Optional_column<T>
+{
+    Optional_column<T> column;
+    if (first == last)
+        return column;
+    auto const n = static_cast<std::size_t>(last - first);
+    std::size_t fields = 1;
+    for (auto p = first; (p = static_cast<const char*>(std::memchr(
+                              p, delimiter, static_cast<std::size_t>(
+                                                last - p)))) != nullptr;
+         ++p) {
+        ++fields;
+    }
+    column.reserve(fields);
+    for (std::size_t i = 0; i <= n;) {
+        auto const field = first + i;
+        auto end = static_cast<const char*>(std::memchr(field, delimiter, n - i));
+        if (end == nullptr)
+            end = last;
+        column.push_back(opt::parse<T>(field, end));
+        i = static_cast<std::size_t>(end - first) + 1;
+    }
+    return column;
+}
+
+/// \brief Parses each \p delimiter separated field of the null terminated
+/// string \p s.
+/// \sa parse_column(const char*, const char*, char)
+template <typename T>
+auto parse_column(const char* s, char delimiter) -> Optional_column<T>
+{
+    return opt::parse_column<T>(s, s + std::strlen(s), delimiter);
+}
+
+/// \brief Parses each \p delimiter separated field of \p s.
+/// \sa parse_column(const char*, const char*, char)
+template <typename T>
+auto parse_column(const std::string& s, char delimiter) -> Optional_column<T>
+{
+    return opt::parse_column<T>(s.data(), s.data() + s.size(), delimiter);
+}
+
+#if defined(__cpp_lib_string_view)
+/// \brief Parses each \p delimiter separated field of \p s.
+/// \sa parse_column(const char*, const char*, char)
+template <typename T>
+auto parse_column(std::string_view s, char delimiter) -> Optional_column<T>
+{
+    return opt::parse_column<T>(s.data(), s.data() + s.size(), delimiter);
+}
+#endif
+
+}  // namespace opt
+#endif  // OPTIONAL_PARSE_HPP
@@ -0,0 +1,399 @@
+/// \file
+/// \brief Lazy pull pipelines built from Optional<T&> returning sources.
+///
+/// A source is any object with a `Value_type` member alias and a `next()`
+/// member function returning Optional<Value_type&>, empty at the end of the
+/// stream. Stages wrap a source and are themselves sources, so they compose
+/// with operator|. No stage materialises the whole stream.
+///
+/// \code
+/// std::vector<int> v{1, 2, 3, 4, 5, 6};
+/// auto squares = opt::pull::from(v)
+///                | opt::pull::filter([](int x) { return x % 2 == 0; })
+///                | opt::pull::map([](int x) { return x * x; })
+///                | opt::pull::take(2);
+/// while (auto x = squares.next()) {
+///     foo(*x);  // 4, 16
+/// }
+/// \endcode
+#ifndef OPTIONAL_PULL_HPP
+#define OPTIONAL_PULL_HPP
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <optional/detail/cache_line.hpp>
+#include <optional/none.hpp>
+#include <optional/optional_reference.hpp>
+#include <optional/optional_value.hpp>
+
+namespace opt {
+namespace pull {
+
+/// Source reading from an iterator range.
+template <typename Iterator>
+class Range_source {
+   public:
+    using Value_type =
+        std::remove_reference_t<decltype(*std::declval<Iterator&>())>;
+
+    Range_source(Iterator first, Iterator last)
+        : first_{std::move(first)}, last_{std::move(last)}
+    {}
+
+    auto next() -> Optional<Value_type&>
+    {
+        if (first_ == last_)
+            return opt::none;
+        return *first_++;
+    }
+
+   private:
+    Iterator first_;
+    Iterator last_;
+};
+
+/// \returns A source reading [first, last).
+template <typename Iterator>
+auto from(Iterator first, Iterator last) -> Range_source<Iterator>
+{
+    return Range_source<Iterator>{std::move(first), std::move(last)};
+}
+
+/// \returns A source reading each element of \p range, which must outlive it.
+template <typename Range>
+auto from(Range& range) -> Range_source<decltype(std::begin(range))>
+{
+    return pull::from(std::begin(range), std::end(range));
+}
+
+/// Applies a function to each element, yielding references to the result.
+template <typename Source, typename F>
+class Map_stage {
+   public:
+    using Value_type = std::decay_t<decltype(std::declval<F&>()(
+        std::declval<typename Source::Value_type&>()))>;
+
+    Map_stage(Source source, F f) : source_{std::move(source)}, f_{std::move(f)}
+    {}
+
+    auto next() -> Optional<Value_type&>
+    {
+        auto x = source_.next();
+        if (!x)
+            return opt::none;
+        current_.emplace(f_(*x));
+        return *current_;
+    }
+
+   private:
+    Source source_;
+    F f_;
+    Optional<Value_type> current_;
+};
+
+/// Passes on only the elements satisfying a predicate.
+template <typename Source, typename Predicate>
+class Filter_stage {
+   public:
+    using Value_type = typename Source::Value_type;
+
+    Filter_stage(Source source, Predicate p)
+        : source_{std::move(source)}, predicate_{std::move(p)}
+    {}
+
+    auto next() -> Optional<Value_type&>
+    {
+        auto x = source_.next();
+        while (x && !predicate_(*x))
+            x = source_.next();
+        return x;
+    }
+
+   private:
+    Source source_;
+    Predicate predicate_;
+};
+
+/// Ends the stream after at most n elements.
+template <typename Source>
+class Take_stage {
+   public:
+    using Value_type = typename Source::Value_type;
+
+    Take_stage(Source source, std::size_t n)
+        : source_{std::move(source)}, remaining_{n}
+    {}
+
+    auto next() -> Optional<Value_type&>
+    {
+        if (remaining_ == 0)
+            return opt::none;
+        --remaining_;
+        return source_.next();
+    }
+
+   private:
+    Source source_;
+    std::size_t remaining_;
+};
+
+/// \brief Groups consecutive elements into vectors of up to n copies.
+///
+/// The final chunk may be shorter. The same buffer is reused for each chunk,
+/// so a yielded reference is invalidated by the next call to next().
+template <typename Source>
+class Chunk_stage {
+   public:
+    using Value_type = std::vector<std::decay_t<typename Source::Value_type>>;
+
+    Chunk_stage(Source source, std::size_t n) : source_{std::move(source)}, n_{n}
+    {
+        chunk_.reserve(n_);
+    }
+
+    auto next() -> Optional<Value_type&>
+    {
+        chunk_.clear();
+        while (chunk_.size() < n_) {
+            auto x = source_.next();
+            if (!x)
+                break;
+            chunk_.push_back(*x);
+        }
+        return {!chunk_.empty(), chunk_};
+    }
+
+   private:
+    Source source_;
+    std::size_t n_;
+    Value_type chunk_;
+};
+
+/// \brief Bounded single producer/single consumer ring buffer.
+///
+/// The producer calls push() and finally close(), the consumer calls pop()
+/// until it returns empty. If the consumer goes away early it calls cancel(),
+/// after which push() returns false. The two sides only share a pair of
+/// atomic counters, kept on separate cache lines, and yield to the scheduler
+/// while the buffer is full or empty.
+template <typename T>
+class Handoff_queue {
+   public:
+    explicit Handoff_queue(std::size_t capacity)
+        : slots_(capacity == 0 ? 1 : capacity)
+    {}
+
+    /// Waits while the buffer is full.
+    /// \returns False if the consumer has cancelled, \p value is dropped.
+    auto push(T value) -> bool
+    {
+        auto const tail = tail_.load(std::memory_order_relaxed);
+        while (tail - head_.load(std::memory_order_acquire) == slots_.size()) {
+            if (state_.load(std::memory_order_acquire) == cancelled)
+                return false;
+            std::this_thread::yield();
+        }
+        if (state_.load(std::memory_order_acquire) == cancelled)
+            return false;
+        slots_[tail % slots_.size()].emplace(std::move(value));
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Waits while the buffer is empty and not closed.
+    /// \returns The oldest value, or empty once closed and drained.
+    auto pop() -> Optional<T>
+    {
+        auto const head = head_.load(std::memory_order_relaxed);
+        while (head == tail_.load(std::memory_order_acquire)) {
+            if (state_.load(std::memory_order_acquire) == closed) {
+                if (head != tail_.load(std::memory_order_acquire))
+                    break;
+                if (error_)
+                    std::rethrow_exception(error_);
+                return opt::none;
+            }
+            std::this_thread::yield();
+        }
+        auto& slot = slots_[head % slots_.size()];
+        Optional<T> result{std::move(*slot)};
+        slot = opt::none;
+        head_.store(head + 1, std::memory_order_release);
+        return result;
+    }
+
+    /// Marks the end of the stream, pending values are still delivered.
+    auto close() -> void { state_.store(closed, std::memory_order_release); }
+
+    /// Closes the stream with an exception to be rethrown by pop().
+    auto close(std::exception_ptr error) -> void
+    {
+        error_ = std::move(error);
+        this->close();
+    }
+
+    /// Makes further push() calls fail.
+    auto cancel() -> void { state_.store(cancelled, std::memory_order_release); }
+
+   private:
+    static constexpr int open = 0;
+    static constexpr int closed = 1;
+    static constexpr int cancelled = 2;
+
+    std::vector<Optional<T>> slots_;
+    std::exception_ptr error_;
+    std::atomic<int> state_{open};
+    char pad0_[cache_line_size];
+    std::atomic<std::size_t> head_{0};
+    char pad1_[cache_line_size];
+    std::atomic<std::size_t> tail_{0};
+};
+
+/// \brief Runs the upstream source on its own thread.
+///
+/// Copies of the upstream elements are passed through a Handoff_queue, so the
+/// upstream and downstream stages run concurrently. Exceptions thrown upstream
+/// are rethrown from next(). Destroying the stage stops the producer.
+template <typename Source>
+class Handoff_stage {
+   public:
+    using Value_type = std::decay_t<typename Source::Value_type>;
+
+    Handoff_stage(Source source, std::size_t capacity)
+        : queue_{std::make_unique<Handoff_queue<Value_type>>(capacity)}
+    {
+        producer_ = std::thread{[queue = queue_.get(),
+                                 source = std::move(source)]() mutable {
+            try {
+                while (auto x = source.next()) {
+                    if (!queue->push(*x))
+                        return;
+                }
+                queue->close();
+            }
+            catch (...) {
+                queue->close(std::current_exception());
+            }
+        }};
+    }
+
+    Handoff_stage(Handoff_stage&&) = default;
+
+    ~Handoff_stage()
+    {
+        if (queue_ != nullptr)
+            queue_->cancel();
+        if (producer_.joinable())
+            producer_.join();
+    }
+
+    auto next() -> Optional<Value_type&>
+    {
+        current_ = queue_->pop();
+        if (!current_)
+            return opt::none;
+        return *current_;
+    }
+
+   private:
+    std::unique_ptr<Handoff_queue<Value_type>> queue_;
+    std::thread producer_;
+    Optional<Value_type> current_;
+};
+
+namespace detail {
+
+template <typename F>
+struct Map_adaptor {
+    F f;
+};
+
+template <typename Predicate>
+struct Filter_adaptor {
+    Predicate p;
+};
+
+struct Take_adaptor {
+    std::size_t n;
+};
+
+struct Chunk_adaptor {
+    std::size_t n;
+};
+
+struct Handoff_adaptor {
+    std::size_t capacity;
+};
+
+// Pipe operators live alongside the adaptors so they are found through ADL.
+
+template <typename Source, typename F>
+auto operator|(Source source, detail::Map_adaptor<F> a) -> Map_stage<Source, F>
+{
+    return {std::move(source), std::move(a.f)};
+}
+
+template <typename Source, typename Predicate>
+auto operator|(Source source, detail::Filter_adaptor<Predicate> a)
+    -> Filter_stage<Source, Predicate>
+{
+    return {std::move(source), std::move(a.p)};
+}
+
+template <typename Source>
+auto operator|(Source source, detail::Take_adaptor a) -> Take_stage<Source>
+{
+    return {std::move(source), a.n};
+}
+
+template <typename Source>
+auto operator|(Source source, detail::Chunk_adaptor a) -> Chunk_stage<Source>
+{
+    return {std::move(source), a.n};
+}
+
+template <typename Source>
+auto operator|(Source source, detail::Handoff_adaptor a)
+    -> Handoff_stage<Source>
+{
+    return {std::move(source), a.capacity};
+}
+
+}  // namespace detail
+
+/// Pipe adaptor creating a Map_stage.
+template <typename F>
+auto map(F f) -> detail::Map_adaptor<F>
+{
+    return {std::move(f)};
+}
+
+/// Pipe adaptor creating a Filter_stage.
+template <typename Predicate>
+auto filter(Predicate p) -> detail::Filter_adaptor<Predicate>
+{
+    return {std::move(p)};
+}
+
+/// Pipe adaptor creating a Take_stage.
+inline auto take(std::size_t n) -> detail::Take_adaptor { return {n}; }
+
+/// Pipe adaptor creating a Chunk_stage.
+inline auto chunk(std::size_t n) -> detail::Chunk_adaptor { return {n}; }
+
+/// Pipe adaptor creating a Handoff_stage with a buffer of \p capacity.
+inline auto handoff(std::size_t capacity) -> detail::Handoff_adaptor
+{
+    return {capacity};
+}
+
+}  // namespace pull
+}  // namespace opt
+#endif  // OPTIONAL_PULL_HPP
@@ -0,0 +1,218 @@
+/// \file
+/// \brief Contains Rank_select_index, a succinct rank and select structure
+/// over the validity bitmap of an optional sequence.
+#ifndef OPTIONAL_RANK_SELECT_INDEX_HPP
+#define OPTIONAL_RANK_SELECT_INDEX_HPP
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <optional/detail/bit_ops.hpp>
+#include <optional/none.hpp>
+#include <optional/optional_value.hpp>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+namespace opt {
+namespace detail {
+
+// Position of the set bit of rank \p k in \p x, k < popcount(x).
+inline auto select_in_word(std::uint64_t x, unsigned k) -> unsigned
+{
+#if defined(__BMI2__)
+    return static_cast<unsigned>(
+        countr_zero(_pdep_u64(std::uint64_t{1} << k, x)));
+#else
+    unsigned shift = 0;
+    for (;;) {
+        auto const count = static_cast<unsigned>(popcount(x & 0xFF));
+        if (k < count)
+            break;
+        k -= count;
+        x >>= 8;
+        shift += 8;
+    }
+    for (; k != 0; --k)
+        x &= x - 1;
+    return shift + static_cast<unsigned>(countr_zero(x));
+#endif
+}
+
+}  // namespace detail
+
+/// \brief Answers rank and select queries over the engaged flags of a
+/// sequence, to map between positions in a sparse sequence and in its
+/// compacted, engaged only, storage.
+///
+/// The index keeps its own copy of the bitmap. The rank directory stores a
+/// 64 bit count every 65536 bits and a 16 bit count, relative to that, every
+/// 512 bits, about 3.1% of the bitmap. rank(i) adds the two counts to the
+/// popcount of at most eight words. Select samples the word holding every
+/// 16384th engaged element, at most 0.4% more, and binary searches the
+/// 512 bit blocks between two samples.
+class Rank_select_index {
+    static constexpr std::size_t block_words = 8;
+    static constexpr std::size_t superblock_words = 1024;
+    static constexpr std::size_t select_sample = 16384;
+
+   public:
+    /// Constructs an index over an empty sequence.
+    Rank_select_index() : Rank_select_index(nullptr, 0) {}
+
+    /// \brief Indexes the first \p n bits of \p words, laid out as the
+    /// validity bitmap of Optional_column.
+    Rank_select_index(const std::uint64_t* words, std::size_t n) : size_{n}
+    {
+        auto const full = n / detail::word_bits;
+        words_.reserve(full + 2);
+        for (std::size_t w = 0; w < full; ++w)
+            this->append_word(words[w]);
+        if (n % detail::word_bits != 0)
+            this->append_word(words[full] &
+                              detail::low_mask(n % detail::word_bits));
+        this->finish();
+    }
+
+    /// \brief Indexes the engaged flags of a sequence of Optional-like
+    /// objects, in a single pass.
+    template <typename InputIterator>
+    Rank_select_index(InputIterator first, InputIterator last) : size_{0}
+    {
+        std::uint64_t word = 0;
+        for (; first != last; ++first) {
+            if (*first)
+                word |= std::uint64_t{1} << (size_ % detail::word_bits);
+            if (++size_ % detail::word_bits == 0) {
+                this->append_word(word);
+                word = 0;
+            }
+        }
+        if (size_ % detail::word_bits != 0)
+            this->append_word(word);
+        this->finish();
+    }
+
+    /// \returns The number of elements, engaged or not.
+    auto size() const noexcept -> std::size_t { return size_; }
+
+    /// \returns The number of engaged elements.
+    auto count_engaged() const noexcept -> std::size_t { return engaged_; }
+
+    auto is_engaged(std::size_t i) const -> bool
+    {
+        return detail::test_bit(words_.data(), i);
+    }
+
+    /// \returns The number of engaged elements before position \p i,
+    /// i <= size().
+    auto rank(std::size_t i) const -> std::size_t
+    {
+        auto const w = i / detail::word_bits;
+        auto const block = w / block_words;
+        std::size_t count = base_[w / superblock_words] + offsets_[block];
+        for (auto b = block * block_words; b < w; ++b)
+            count += detail::popcount(words_[b]);
+        return count + detail::popcount(words_[w] &
+                                        detail::low_mask(i % detail::word_bits));
+    }
+
+    /// \returns The position of the engaged element of rank \p k, that is
+    /// the \p k th engaged element counting from zero, k < count_engaged().
+    auto select(std::size_t k) const -> std::size_t
+    {
+        auto const sample = k / select_sample;
+        auto lo = samples_[sample] / block_words;
+        auto hi = sample + 1 < samples_.size()
+                      ? samples_[sample + 1] / block_words
+                      : offsets_.size() - 1;
+        // Last block in [lo, hi] whose first rank is at most k.
+        while (lo < hi) {
+            auto const mid = lo + (hi - lo + 1) / 2;
+            if (this->block_rank(mid) <= k)
+                lo = mid;
+            else
+                hi = mid - 1;
+        }
+        auto remaining = k - this->block_rank(lo);
+        auto w = lo * block_words;
+        for (;; ++w) {
+            auto const count =
+                static_cast<std::size_t>(detail::popcount(words_[w]));
+            if (remaining < count)
+                break;
+            remaining -= count;
+        }
+        return w * detail::word_bits +
+               detail::select_in_word(words_[w],
+                                      static_cast<unsigned>(remaining));
+    }
+
+    /// \returns The position of element \p i in a compacted array of the
+    /// engaged elements, or empty if element \p i is not engaged.
+    auto dense_index_of(std::size_t i) const -> Optional<std::size_t>
+    {
+        if (!this->is_engaged(i))
+            return opt::none;
+        return this->rank(i);
+    }
+
+    /// \returns The validity bitmap words.
+    auto validity() const noexcept -> const std::uint64_t*
+    {
+        return words_.data();
+    }
+
+    /// \returns The number of bytes used by the rank and select directories,
+    /// not counting the bitmap.
+    auto directory_bytes() const noexcept -> std::size_t
+    {
+        return base_.size() * sizeof(std::uint64_t) +
+               offsets_.size() * sizeof(std::uint16_t) +
+               samples_.size() * sizeof(std::size_t);
+    }
+
+   private:
+    auto block_rank(std::size_t block) const -> std::size_t
+    {
+        return base_[block * block_words / superblock_words] + offsets_[block];
+    }
+
+    // Appends the next bitmap word, adding directory entries and select
+    // samples as their boundaries are reached.
+    auto append_word(std::uint64_t word) -> void
+    {
+        auto const w = words_.size();
+        if (w % superblock_words == 0)
+            base_.push_back(engaged_);
+        if (w % block_words == 0)
+            offsets_.push_back(
+                static_cast<std::uint16_t>(engaged_ - base_.back()));
+        auto const count = static_cast<std::size_t>(detail::popcount(word));
+        if ((engaged_ + count + select_sample - 1) / select_sample >
+            samples_.size())
+            samples_.push_back(w);
+        engaged_ += count;
+        words_.push_back(word);
+    }
+
+    // Adds a zero word so rank(size()) reads no further than the bitmap.
+    auto finish() -> void
+    {
+        this->append_word(0);
+        words_.shrink_to_fit();
+    }
+
+    std::vector<std::uint64_t> words_;
+    std::vector<std::uint64_t> base_;
+    std::vector<std::uint16_t> offsets_;
+    // Word holding each engaged element of rank a multiple of select_sample.
+    std::vector<std::size_t> samples_;
+    std::size_t size_;
+    std::size_t engaged_{0};
+};
+
+}  // namespace opt
+#endif  // OPTIONAL_RANK_SELECT_INDEX_HPP
@@ -0,0 +1,269 @@
+/// \file
+/// \brief Contains Rle_optional_column, a run length encoded sequence of
+/// optional values.
+#ifndef OPTIONAL_RLE_OPTIONAL_COLUMN_HPP
+#define OPTIONAL_RLE_OPTIONAL_COLUMN_HPP
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include <optional/detail/bit_ops.hpp>
+#include <optional/none.hpp>
+#include <optional/optional_column.hpp>
+#include <optional/optional_reference.hpp>
+#include <optional/optional_value.hpp>
+
+namespace opt {
+namespace detail {
+
+// Sets bits [first, first + n) of words.
+inline auto set_bit_range(std::uint64_t* words, std::size_t first, std::size_t n)
+    -> void
+{
+    while (n != 0) {
+        auto const offset = first % word_bits;
+        auto const count = std::min(n, word_bits - offset);
+        words[first / word_bits] |= low_mask(count) << offset;
+        first += count;
+        n -= count;
+    }
+}
+
+}  // namespace detail
+
+/// A run of equal elements of a Rle_optional_column.
+template <typename T>
+struct Rle_run {
+    /// Index of the first element of the run.
+    std::size_t first;
+    std::size_t length;
+    /// The value of every element of the run, or empty.
+    Optional<const T&> value;
+};
+
+/// \brief A sequence of optional T stored as runs of equal elements.
+///
+/// Each run is its end index and its value, empty or not, so long runs of
+/// empties or of a repeated value take the space of one element. Runs are
+/// built by appending: an element equal to the last one, or empty after an
+/// empty, extends the last run. Element access binary searches the run ends.
+/// T must be default constructible and equality comparable.
+template <typename T>
+class Rle_optional_column {
+   public:
+    class Iterator;
+
+    using Value_type = T;
+
+    /// Constructs an empty column.
+    Rle_optional_column() = default;
+
+    /// Constructs a column from a sequence of Optional-like objects.
+    template <typename InputIterator>
+    Rle_optional_column(InputIterator first, InputIterator last)
+    {
+        for (; first != last; ++first) {
+            auto&& x = *first;
+            if (x)
+                this->push_back(*x);
+            else
+                this->push_back(opt::none);
+        }
+    }
+
+    Rle_optional_column(std::initializer_list<Optional<T>> init)
+        : Rle_optional_column(init.begin(), init.end())
+    {}
+
+    /// \returns The number of elements, engaged or not.
+    auto size() const noexcept -> std::size_t
+    {
+        return ends_.empty() ? 0 : ends_.back();
+    }
+
+    auto empty() const noexcept -> bool { return ends_.empty(); }
+
+    /// \returns The number of engaged elements.
+    auto count_engaged() const noexcept -> std::size_t { return engaged_; }
+
+    /// \returns The number of runs.
+    auto run_count() const noexcept -> std::size_t { return ends_.size(); }
+
+    /// \returns Run \p r, r < run_count().
+    auto run(std::size_t r) const -> Rle_run<T>
+    {
+        auto const first = r == 0 ? 0 : ends_[r - 1];
+        return {first, ends_[r] - first, runs_[r]};
+    }
+
+    /// \returns The index of the run holding element \p i, i < size().
+    auto run_of(std::size_t i) const -> std::size_t
+    {
+        return static_cast<std::size_t>(
+            std::upper_bound(ends_.begin(), ends_.end(), i) - ends_.begin());
+    }
+
+    /// \returns A reference to element \p i, or empty if it is not engaged.
+    auto operator[](std::size_t i) const -> Optional<const T&>
+    {
+        return runs_[this->run_of(i)];
+    }
+
+    /// Appends \p n copies of \p value, engaged if \p value is.
+    auto append(const Optional<T>& value, std::size_t n) -> void
+    {
+        if (value)
+            this->append(*value, n);
+        else
+            this->append(opt::none, n);
+    }
+
+    /// Appends \p n copies of \p value.
+    auto append(const T& value, std::size_t n) -> void
+    {
+        if (n == 0)
+            return;
+        if (ends_.empty() || !runs_.is_engaged(runs_.size() - 1) ||
+            !(*runs_[runs_.size() - 1] == value)) {
+            runs_.push_back(value);
+            ends_.push_back(this->size());
+        }
+        ends_.back() += n;
+        engaged_ += n;
+    }
+
+    /// Appends \p n empty elements.
+    auto append(opt::None_t, std::size_t n) -> void
+    {
+        if (n == 0)
+            return;
+        if (ends_.empty() || runs_.is_engaged(runs_.size() - 1)) {
+            runs_.push_back(opt::none);
+            ends_.push_back(this->size());
+        }
+        ends_.back() += n;
+    }
+
+    /// Appends an element, engaged if \p value is.
+    auto push_back(const Optional<T>& value) -> void { this->append(value, 1); }
+
+    auto push_back(const T& value) -> void { this->append(value, 1); }
+
+    auto push_back(opt::None_t) -> void { this->append(opt::none, 1); }
+
+    auto clear() -> void
+    {
+        ends_.clear();
+        runs_.clear();
+        engaged_ = 0;
+    }
+
+    /// \brief Decodes into the bitmap layout of Optional_column.
+    ///
+    /// Runs are written whole, a bitmap word at a time.
+    auto to_column() const -> Optional_column<T>
+    {
+        Optional_column<T> column(this->size());
+        for (std::size_t r = 0; r < ends_.size(); ++r) {
+            auto const run = this->run(r);
+            if (!run.value)
+                continue;
+            std::fill_n(column.data() + run.first, run.length, *run.value);
+            detail::set_bit_range(column.validity(), run.first, run.length);
+        }
+        return column;
+    }
+
+    /// \returns The number of bytes allocated by the column, counting
+    /// reserved capacity.
+    auto memory_usage() const noexcept -> std::size_t
+    {
+        return ends_.capacity() * sizeof(std::size_t) + runs_.memory_usage();
+    }
+
+    auto begin() const -> Iterator { return {this, 0, 0}; }
+    auto end() const -> Iterator { return {this, this->size(), ends_.size()}; }
+
+   private:
+    // End index, exclusive, of each run.
+    std::vector<std::size_t> ends_;
+    // The value of each run.
+    Optional_column<T> runs_;
+    std::size_t engaged_{0};
+};
+
+/// \brief Visits each element of a Rle_optional_column as Optional<const T&>,
+/// stepping through the runs without searching.
+template <typename T>
+class Rle_optional_column<T>::Iterator {
+   public:
+    using value_type = Optional<const T&>;
+    using reference = Optional<const T&>;
+    using pointer = void;
+    using difference_type = std::ptrdiff_t;
+    using iterator_category = std::input_iterator_tag;
+
+    Iterator() = default;
+
+    Iterator(const Rle_optional_column* column, std::size_t i, std::size_t r)
+        : column_{column}, i_{i}, r_{r}
+    {}
+
+    auto operator*() const -> reference { return column_->runs_[r_]; }
+
+    auto operator++() -> Iterator&
+    {
+        if (++i_ == column_->ends_[r_])
+            ++r_;
+        return *this;
+    }
+
+    auto operator++(int) -> Iterator
+    {
+        auto copy = *this;
+        ++*this;
+        return copy;
+    }
+
+    auto operator==(const Iterator& x) const -> bool { return i_ == x.i_; }
+
+    auto operator!=(const Iterator& x) const -> bool { return i_ != x.i_; }
+
+   private:
+    const Rle_optional_column* column_{nullptr};
+    std::size_t i_{0};
+    std::size_t r_{0};
+};
+
+/// \brief Folds the engaged runs of \p column into \p init.
+///
+/// Calls f(acc, value, length) once per engaged run, so the cost depends on
+/// the number of runs, not of elements.
+template <typename T, typename Acc, typename F>
+auto reduce_runs(const Rle_optional_column<T>& column, Acc init, F f) -> Acc
+{
+    for (std::size_t r = 0; r < column.run_count(); ++r) {
+        auto const run = column.run(r);
+        if (run.value)
+            init = f(std::move(init), *run.value, run.length);
+    }
+    return init;
+}
+
+/// \returns The sum of the engaged elements of \p column, each run added as
+/// value * length.
+template <typename T>
+auto sum(const Rle_optional_column<T>& column, T init = T{}) -> T
+{
+    return reduce_runs(column, init,
+                       [](T acc, const T& value, std::size_t length) {
+                           return acc + value * static_cast<T>(length);
+                       });
+}
+
+}  // namespace opt
+#endif  // OPTIONAL_RLE_OPTIONAL_COLUMN_HPP
@@ -0,0 +1,196 @@
+/// \file
+/// \brief Contains Slot_map, a densely stored container addressed by
+/// generational handles.
+#ifndef OPTIONAL_SLOT_MAP_HPP
+#define OPTIONAL_SLOT_MAP_HPP
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <optional/none.hpp>
+#include <optional/optional_reference.hpp>
+#include <optional/optional_value.hpp>
+
+namespace opt {
+
+/// \brief Refers to an element of a Slot_map.
+///
+/// A value initialized handle never refers to an element.
+struct Slot_handle {
+    std::uint32_t index;
+    std::uint32_t generation;
+};
+
+inline auto operator==(Slot_handle x, Slot_handle y) -> bool
+{
+    return x.index == y.index && x.generation == y.generation;
+}
+
+inline auto operator!=(Slot_handle x, Slot_handle y) -> bool
+{
+    return !(x == y);
+}
+
+/// \brief Container of T with O(1) insert, erase and lookup through handles
+/// that detect use after erase.
+///
+/// Elements are stored contiguously in the order given by begin() and end(),
+/// erasing moves the last element into the hole. Each handle names a slot
+/// and the slot's generation when the element was inserted. The generation
+/// changes when the element is erased, so get() on a stale handle returns
+/// empty, even after the slot has been reused. A slot whose generation
+/// counter is exhausted is retired rather than reused.
+///
+/// Inserting and erasing invalidate references and iterators, never handles.
+template <typename T>
+class Slot_map {
+   public:
+    using Value_type = T;
+    using Iterator = T*;
+    using Const_iterator = const T*;
+
+    Slot_map() = default;
+
+    auto size() const noexcept -> std::size_t { return values_.size(); }
+
+    auto empty() const noexcept -> bool { return values_.empty(); }
+
+    /// Makes room for \p n elements.
+    auto reserve(std::size_t n) -> void
+    {
+        values_.reserve(n);
+        dense_slot_.reserve(n);
+        slots_.reserve(n);
+    }
+
+    /// \brief Inserts \p value.
+    /// \returns A handle to the new element.
+    /// \throws std::length_error If the map already has 2^32 - 1 slots.
+    auto insert(T value) -> Slot_handle
+    {
+        return this->emplace(std::move(value));
+    }
+
+    /// \brief Inserts an element constructed from \p args.
+    /// \returns A handle to the new element.
+    /// \throws std::length_error If the map already has 2^32 - 1 slots.
+    template <typename... Args>
+    auto emplace(Args&&... args) -> Slot_handle
+    {
+        if (free_head_ == npos && slots_.size() >= npos)
+            throw std::length_error{"Slot_map: out of slots."};
+        auto const dense = static_cast<std::uint32_t>(values_.size());
+        values_.emplace_back(std::forward<Args>(args)...);
+        std::uint32_t index;
+        if (free_head_ != npos) {
+            index = free_head_;
+            free_head_ = slots_[index].link;
+            slots_[index].link = dense;
+            ++slots_[index].generation;
+        }
+        else {
+            index = static_cast<std::uint32_t>(slots_.size());
+            slots_.push_back({dense, 1});
+        }
+        dense_slot_.push_back(index);
+        return {index, slots_[index].generation};
+    }
+
+    /// \brief Removes the element referred to by \p h.
+    /// \returns True if \p h referred to an element.
+    auto erase(Slot_handle h) -> bool
+    {
+        if (!this->contains(h))
+            return false;
+        auto& slot = slots_[h.index];
+        auto const dense = slot.link;
+        auto const last = static_cast<std::uint32_t>(values_.size() - 1);
+        if (dense != last) {
+            values_[dense] = std::move(values_[last]);
+            dense_slot_[dense] = dense_slot_[last];
+            slots_[dense_slot_[dense]].link = dense;
+        }
+        values_.pop_back();
+        dense_slot_.pop_back();
+        // Live generations are odd, so the next insert makes this one even.
+        if (++slot.generation != std::numeric_limits<std::uint32_t>::max() - 1) {
+            slot.link = free_head_;
+            free_head_ = h.index;
+        }
+        return true;
+    }
+
+    /// \returns True if \p h refers to an element.
+    auto contains(Slot_handle h) const noexcept -> bool
+    {
+        return h.index < slots_.size() &&
+               slots_[h.index].generation == h.generation &&
+               (h.generation & 1u) != 0;
+    }
+
+    /// \returns A reference to the element \p h refers to, or empty if it has
+    /// been erased.
+    auto get(Slot_handle h) -> Optional<T&>
+    {
+        if (!this->contains(h))
+            return opt::none;
+        return values_[slots_[h.index].link];
+    }
+
+    /// \returns A reference to the element \p h refers to, or empty if it has
+    /// been erased.
+    auto get(Slot_handle h) const -> Optional<const T&>
+    {
+        if (!this->contains(h))
+            return opt::none;
+        return values_[slots_[h.index].link];
+    }
+
+    /// \returns The handle of the element at position \p i of the dense
+    /// storage, i < size().
+    auto handle_at(std::size_t i) const -> Slot_handle
+    {
+        auto const index = dense_slot_[i];
+        return {index, slots_[index].generation};
+    }
+
+    /// Erases all elements, every outstanding handle becomes stale.
+    auto clear() -> void
+    {
+        while (!values_.empty())
+            this->erase(this->handle_at(values_.size() - 1));
+    }
+
+    auto data() noexcept -> T* { return values_.data(); }
+    auto data() const noexcept -> const T* { return values_.data(); }
+
+    auto begin() noexcept -> Iterator { return values_.data(); }
+    auto end() noexcept -> Iterator { return values_.data() + values_.size(); }
+    auto begin() const noexcept -> Const_iterator { return values_.data(); }
+    auto end() const noexcept -> Const_iterator
+    {
+        return values_.data() + values_.size();
+    }
+
+   private:
+    static constexpr std::uint32_t npos =
+        std::numeric_limits<std::uint32_t>::max();
+
+    // While the slot is live, link is the element's position in values_,
+    // otherwise it is the next slot in the free list.
+    struct Slot {
+        std::uint32_t link;
+        std::uint32_t generation;
+    };
+
+    std::vector<T> values_;
+    std::vector<std::uint32_t> dense_slot_;
+    std::vector<Slot> slots_;
+    std::uint32_t free_head_{npos};
+};
+
+}  // namespace opt
+#endif  // OPTIONAL_SLOT_MAP_HPP
@@ -0,0 +1,466 @@
+/// \file
+/// \brief Contains Sparse_optional_array, an optional array over a huge index
+/// space of which only a small fraction is engaged.
+#ifndef OPTIONAL_SPARSE_OPTIONAL_ARRAY_HPP
+#define OPTIONAL_SPARSE_OPTIONAL_ARRAY_HPP
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include <optional/detail/bit_ops.hpp>
+#include <optional/none.hpp>
+#include <optional/optional_reference.hpp>
+#include <optional/optional_value.hpp>
+
+namespace opt {
+namespace detail {
+
+// Indices are split into a chunk key, the high bits, and a 16 bit position
+// within the chunk.
+constexpr std::size_t chunk_bits = 16;
+constexpr std::size_t chunk_slots = std::size_t{1} << chunk_bits;
+
+// A chunk switches to a bitmap above this many entries, and back to a
+// sorted array below half of it.
+constexpr std::size_t chunk_array_max = 4096;
+
+// The engaged entries of one chunk. Sparse chunks keep sorted positions with
+// their values in the same order. Dense chunks keep a bitmap and a value slot
+// for every position, empty slots holding value initialized T objects.
+template <typename T>
+struct Sparse_chunk {
+    explicit Sparse_chunk(std::size_t k) : key{k} {}
+
+    std::size_t key;
+    std::size_t count{0};
+    std::vector<std::uint16_t> lows;
+    std::vector<std::uint64_t> bits;
+    std::vector<T> values;
+
+    auto is_bitmap() const noexcept -> bool { return !bits.empty(); }
+
+    // Positions past the last entry, the common case when filling in index
+    // order, are found without a search.
+    auto array_position(std::uint16_t low) const -> std::size_t
+    {
+        if (lows.empty() || lows.back() < low)
+            return lows.size();
+        return static_cast<std::size_t>(
+            std::lower_bound(lows.begin(), lows.end(), low) - lows.begin());
+    }
+
+    auto contains(std::uint16_t low) const -> bool
+    {
+        if (this->is_bitmap())
+            return test_bit(bits.data(), low);
+        auto const p = this->array_position(low);
+        return p != lows.size() && lows[p] == low;
+    }
+
+    auto find(std::uint16_t low) -> T*
+    {
+        if (this->is_bitmap())
+            return test_bit(bits.data(), low) ? &values[low] : nullptr;
+        auto const p = this->array_position(low);
+        return p != lows.size() && lows[p] == low ? &values[p] : nullptr;
+    }
+
+    auto find(std::uint16_t low) const -> const T*
+    {
+        return const_cast<Sparse_chunk&>(*this).find(low);
+    }
+
+    // Returns true if low was not present.
+    template <typename U>
+    auto insert_or_assign(std::uint16_t low, U&& value) -> bool
+    {
+        if (this->is_bitmap()) {
+            values[low] = std::forward<U>(value);
+            if (test_bit(bits.data(), low))
+                return false;
+            set_bit(bits.data(), low);
+            ++count;
+            return true;
+        }
+        auto const p = this->array_position(low);
+        if (p != lows.size() && lows[p] == low) {
+            values[p] = std::forward<U>(value);
+            return false;
+        }
+        lows.insert(lows.begin() + p, low);
+        values.insert(values.begin() + p, std::forward<U>(value));
+        if (++count > chunk_array_max)
+            this->to_bitmap();
+        return true;
+    }
+
+    // Returns true if low was present.
+    auto erase(std::uint16_t low) -> bool
+    {
+        if (this->is_bitmap()) {
+            if (!test_bit(bits.data(), low))
+                return false;
+            clear_bit(bits.data(), low);
+            values[low] = T{};
+            if (--count < chunk_array_max / 2)
+                this->to_array();
+            return true;
+        }
+        auto const p = this->array_position(low);
+        if (p == lows.size() || lows[p] != low)
+            return false;
+        lows.erase(lows.begin() + p);
+        values.erase(values.begin() + p);
+        --count;
+        return true;
+    }
+
+    auto to_bitmap() -> void
+    {
+        bits.assign(chunk_slots / word_bits, 0);
+        std::vector<T> slots(chunk_slots);
+        for (std::size_t p = 0; p < lows.size(); ++p) {
+            set_bit(bits.data(), lows[p]);
+            slots[lows[p]] = std::move(values[p]);
+        }
+        values = std::move(slots);
+        lows = std::vector<std::uint16_t>{};
+    }
+
+    auto to_array() -> void
+    {
+        lows.reserve(count);
+        std::vector<T> packed;
+        packed.reserve(count);
+        for (auto p = this->first(); p != chunk_slots; p = this->next(p)) {
+            lows.push_back(static_cast<std::uint16_t>(p));
+            packed.push_back(std::move(values[p]));
+        }
+        values = std::move(packed);
+        bits = std::vector<std::uint64_t>{};
+    }
+
+    // Iteration positions are indices into lows for sparse chunks and chunk
+    // positions for dense ones, end_position() is past the last.
+
+    auto end_position() const noexcept -> std::size_t
+    {
+        return this->is_bitmap() ? chunk_slots : lows.size();
+    }
+
+    auto next(std::size_t p) const -> std::size_t
+    {
+        return this->is_bitmap() ? next_set_bit(bits.data(), p + 1, chunk_slots)
+                                 : p + 1;
+    }
+
+    auto first() const -> std::size_t
+    {
+        return this->is_bitmap() ? next_set_bit(bits.data(), 0, chunk_slots)
+                                 : 0;
+    }
+
+    auto low_at(std::size_t p) const -> std::size_t
+    {
+        return this->is_bitmap() ? p : lows[p];
+    }
+};
+
+}  // namespace detail
+
+/// \brief An unbounded sequence of optional T in which few elements are
+/// engaged.
+///
+/// The index space is split into chunks of 65536 indices, and only chunks
+/// with engaged elements are stored, as in a roaring bitmap. A chunk with at
+/// most 4096 engaged elements stores their sorted 16 bit positions and their
+/// values, packed. A denser chunk stores a bitmap and a value slot for each
+/// of its 65536 indices. Chunks are kept sorted by index, so iteration visits
+/// engaged elements in index order.
+///
+/// Lookups binary search the chunks and then the chunk. T must be default
+/// constructible.
+///
+/// set() and reset() are amortised O(1) only when indices arrive in
+/// increasing order, which appends to the last chunk. Otherwise they cost
+/// - a sorted insert or erase in a sparse chunk, moving up to 4096 entries,
+/// - moving the chunk list when a chunk is created or removed other than at
+///   the end, O(number of chunks),
+/// - allocating and filling 65536 value slots when a chunk turns dense, and
+///   repacking when it turns sparse again. The two thresholds are 2048
+///   entries apart, so each conversion follows at least 2048 calls on the
+///   chunk, at most 32 slots per call amortised.
+template <typename T>
+class Sparse_optional_array {
+    using Chunk = detail::Sparse_chunk<T>;
+
+    template <bool Const>
+    class Basic_iterator;
+
+    template <typename U>
+    friend class Sparse_optional_array;
+
+   public:
+    using Value_type = T;
+    using Iterator = Basic_iterator<false>;
+    using Const_iterator = Basic_iterator<true>;
+
+    /// Constructs an array with every element empty.
+    Sparse_optional_array() = default;
+
+    /// \returns The number of engaged elements.
+    auto count() const noexcept -> std::size_t { return count_; }
+
+    /// \returns True if no element is engaged.
+    auto empty() const noexcept -> bool { return count_ == 0; }
+
+    auto contains(std::size_t i) const -> bool
+    {
+        auto const c = this->chunk_position(i >> detail::chunk_bits);
+        return c != chunks_.size() && chunks_[c].key == i >> detail::chunk_bits &&
+               chunks_[c].contains(low_of(i));
+    }
+
+    /// \returns A reference to element \p i, or empty if it is not engaged.
+    auto operator[](std::size_t i) -> Optional<T&>
+    {
+        auto const c = this->chunk_position(i >> detail::chunk_bits);
+        if (c == chunks_.size() || chunks_[c].key != i >> detail::chunk_bits)
+            return opt::none;
+        auto const p = chunks_[c].find(low_of(i));
+        if (p == nullptr)
+            return opt::none;
+        return *p;
+    }
+
+    /// \returns A reference to element \p i, or empty if it is not engaged.
+    auto operator[](std::size_t i) const -> Optional<const T&>
+    {
+        auto const c = this->chunk_position(i >> detail::chunk_bits);
+        if (c == chunks_.size() || chunks_[c].key != i >> detail::chunk_bits)
+            return opt::none;
+        auto const p = chunks_[c].find(low_of(i));
+        if (p == nullptr)
+            return opt::none;
+        return *p;
+    }
+
+    /// Engages element \p i with \p value.
+    auto set(std::size_t i, T value) -> void
+    {
+        auto const key = i >> detail::chunk_bits;
+        auto const c = this->chunk_position(key);
+        if (c == chunks_.size() || chunks_[c].key != key)
+            chunks_.insert(chunks_.begin() + c, Chunk{key});
+        count_ += chunks_[c].insert_or_assign(low_of(i), std::move(value));
+    }
+
+    /// Empties element \p i.
+    auto reset(std::size_t i) -> void
+    {
+        auto const key = i >> detail::chunk_bits;
+        auto const c = this->chunk_position(key);
+        if (c == chunks_.size() || chunks_[c].key != key)
+            return;
+        count_ -= chunks_[c].erase(low_of(i));
+        if (chunks_[c].count == 0)
+            chunks_.erase(chunks_.begin() + c);
+    }
+
+    /// Empties every element.
+    auto clear() -> void
+    {
+        chunks_.clear();
+        count_ = 0;
+    }
+
+    /// \brief Engages every element that is engaged in \p other but not here,
+    /// copying its value from \p other.
+    auto merge(const Sparse_optional_array& other) -> void
+    {
+        if (&other == this)
+            return;
+        std::size_t c = 0;
+        for (auto const& theirs : other.chunks_) {
+            while (c != chunks_.size() && chunks_[c].key < theirs.key)
+                ++c;
+            if (c == chunks_.size() || chunks_[c].key != theirs.key) {
+                chunks_.insert(chunks_.begin() + c, theirs);
+                count_ += theirs.count;
+                continue;
+            }
+            auto& ours = chunks_[c];
+            for (auto p = theirs.first(); p != theirs.end_position();
+                 p = theirs.next(p)) {
+                auto const low = static_cast<std::uint16_t>(theirs.low_at(p));
+                if (!ours.contains(low)) {
+                    ours.insert_or_assign(low, theirs.values[p]);
+                    ++count_;
+                }
+            }
+        }
+    }
+
+    /// Empties every element that is not engaged in \p other.
+    template <typename U>
+    auto intersect(const Sparse_optional_array<U>& other) -> void
+    {
+        std::size_t o = 0;
+        std::vector<std::uint16_t> dropped;
+        for (auto& ours : chunks_) {
+            while (o != other.chunks_.size() && other.chunks_[o].key < ours.key)
+                ++o;
+            if (o == other.chunks_.size() || other.chunks_[o].key != ours.key) {
+                count_ -= ours.count;
+                ours.count = 0;
+                continue;
+            }
+            auto const& theirs = other.chunks_[o];
+            dropped.clear();
+            for (auto p = ours.first(); p != ours.end_position();
+                 p = ours.next(p)) {
+                auto const low = static_cast<std::uint16_t>(ours.low_at(p));
+                if (!theirs.contains(low))
+                    dropped.push_back(low);
+            }
+            for (auto low : dropped)
+                ours.erase(low);
+            count_ -= dropped.size();
+        }
+        chunks_.erase(std::remove_if(chunks_.begin(), chunks_.end(),
+                                     [](const Chunk& c) { return c.count == 0; }),
+                      chunks_.end());
+    }
+
+    /// \returns The approximate number of bytes allocated by the array.
+    auto memory_usage() const noexcept -> std::size_t
+    {
+        auto bytes = chunks_.capacity() * sizeof(Chunk);
+        for (auto const& c : chunks_) {
+            bytes += c.lows.capacity() * sizeof(std::uint16_t) +
+                     c.bits.capacity() * sizeof(std::uint64_t) +
+                     c.values.capacity() * sizeof(T);
+        }
+        return bytes;
+    }
+
+    /// \brief Iterators visit engaged elements in index order, yielding pairs
+    /// of index and value reference.
+    auto begin() -> Iterator { return {&chunks_, 0}; }
+    auto end() -> Iterator { return {&chunks_, chunks_.size()}; }
+    auto begin() const -> Const_iterator { return {&chunks_, 0}; }
+    auto end() const -> Const_iterator { return {&chunks_, chunks_.size()}; }
+
+   private:
+    std::vector<Chunk> chunks_;
+    std::size_t count_{0};
+
+    static auto low_of(std::size_t i) -> std::uint16_t
+    {
+        return static_cast<std::uint16_t>(i & (detail::chunk_slots - 1));
+    }
+
+    // Position of the first chunk with a key not less than key.
+    auto chunk_position(std::size_t key) const -> std::size_t
+    {
+        if (chunks_.empty() || chunks_.back().key < key)
+            return chunks_.size();
+        auto const it = std::lower_bound(
+            chunks_.begin(), chunks_.end(), key,
+            [](const Chunk& c, std::size_t k) { return c.key < k; });
+        return static_cast<std::size_t>(it - chunks_.begin());
+    }
+
+    /// Forward iterator over engaged elements.
+    template <bool Const>
+    class Basic_iterator {
+        using Chunks = std::conditional_t<Const,
+                                          const std::vector<Chunk>,
+                                          std::vector<Chunk>>;
+        using Value_ref = std::conditional_t<Const, const T&, T&>;
+
+       public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::pair<std::size_t, T>;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::pair<std::size_t, Value_ref>;
+        using pointer = void;
+
+        Basic_iterator() = default;
+
+        Basic_iterator(Chunks* chunks, std::size_t c)
+            : chunks_{chunks},
+              c_{c},
+              p_{c < chunks->size() ? (*chunks)[c].first() : 0}
+        {}
+
+        auto operator*() const -> reference
+        {
+            auto& chunk = (*chunks_)[c_];
+            return {(chunk.key << detail::chunk_bits) | chunk.low_at(p_),
+                    chunk.values[p_]};
+        }
+
+        auto operator++() -> Basic_iterator&
+        {
+            auto const& chunk = (*chunks_)[c_];
+            p_ = chunk.next(p_);
+            if (p_ == chunk.end_position()) {
+                ++c_;
+                p_ = c_ < chunks_->size() ? (*chunks_)[c_].first() : 0;
+            }
+            return *this;
+        }
+
+        auto operator++(int) -> Basic_iterator
+        {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        friend auto operator==(const Basic_iterator& x,
+                               const Basic_iterator& y) -> bool
+        {
+            return x.c_ == y.c_ && x.p_ == y.p_;
+        }
+
+        friend auto operator!=(const Basic_iterator& x,
+                               const Basic_iterator& y) -> bool
+        {
+            return !(x == y);
+        }
+
+       private:
+        Chunks* chunks_{nullptr};
+        std::size_t c_{0};
+        std::size_t p_{0};
+    };
+};
+
+/// \returns A copy of \p a, with the elements engaged only in \p b added.
+template <typename T>
+auto set_union(const Sparse_optional_array<T>& a,
+               const Sparse_optional_array<T>& b) -> Sparse_optional_array<T>
+{
+    auto result = a;
+    result.merge(b);
+    return result;
+}
+
+/// \returns A copy of \p a, keeping only the elements also engaged in \p b.
+template <typename T, typename U>
+auto set_intersection(const Sparse_optional_array<T>& a,
+                      const Sparse_optional_array<U>& b)
+    -> Sparse_optional_array<T>
+{
+    auto result = a;
+    result.intersect(b);
+    return result;
+}
+
+}  // namespace opt
+#endif  // OPTIONAL_SPARSE_OPTIONAL_ARRAY_HPP
@@ -0,0 +1,703 @@
+/// \file
+/// \brief Lazy, non-allocating views over sequences of optionals.
+///
+/// Each view accepts either a range of Optional-like elements (e.g.
+/// std::vector<Optional<T>>, a range of Optional<T&>) or a bitmap layout, any
+/// type with size(), data() and validity() members such as Optional_column.
+/// On bitmap layouts empty regions are skipped a bitmap word at a time.
+///
+/// Views are used with operator| or called directly:
+/// \code
+/// std::vector<Optional<int>> v{1, opt::none, 3};
+/// for (int& i : v | opt::views::engaged) { ... }           // 1, 3
+/// for (int i : opt::views::values_or(v, 0)) { ... }        // 1, 0, 3
+/// auto s = v | opt::views::transform_opt(to_string);       // "1", none, "3"
+/// for (std::string x : s | opt::views::flatten) { ... }    // "1", "3"
+/// \endcode
+///
+/// Containers are referenced, not copied, and must outlive the view. Views
+/// hold only iterators, so their iterators remain valid after the view itself
+/// is destroyed. With C++20 ranges, views model std::ranges::view.
+#ifndef OPTIONAL_VIEWS_HPP
+#define OPTIONAL_VIEWS_HPP
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include <optional/detail/bit_ops.hpp>
+#include <optional/none.hpp>
+#include <optional/optional_reference.hpp>
+#include <optional/optional_value.hpp>
+
+#if defined(__has_include)
+#if __has_include(<version>)
+#include <version>
+#endif
+#endif
+#if defined(__cpp_lib_ranges)
+#include <ranges>
+#endif
+
+namespace opt {
+namespace views {
+namespace detail {
+
+template <typename...>
+using Void_t = void;
+
+// True if L has the size(), data() and validity() members of a bitmap layout.
+template <typename L, typename = void>
+struct Is_bitmap_layout : std::false_type {};
+
+template <typename L>
+struct Is_bitmap_layout<L,
+                        Void_t<decltype(std::declval<L&>().size()),
+                               decltype(std::declval<L&>().data()),
+                               decltype(std::declval<L&>().validity())>>
+    : std::true_type {};
+
+#if defined(__cpp_lib_ranges)
+struct View_base : std::ranges::view_base {};
+#else
+struct View_base {};
+#endif
+
+// Holds a possibly non-assignable function object, rebuilding it on
+// assignment so iterators holding one stay copy assignable.
+template <typename F>
+class Function_box {
+   public:
+    Function_box() = default;
+    explicit Function_box(F f) : f_{std::move(f)} {}
+
+    Function_box(const Function_box&) = default;
+    Function_box(Function_box&&) = default;
+
+    auto operator=(const Function_box& other) -> Function_box&
+    {
+        if (this != &other) {
+            if (other.f_)
+                f_.emplace(*other.f_);
+            else
+                f_ = opt::none;
+        }
+        return *this;
+    }
+
+    auto operator=(Function_box&& other) -> Function_box&
+    {
+        if (this != &other) {
+            if (other.f_)
+                f_.emplace(std::move(*other.f_));
+            else
+                f_ = opt::none;
+        }
+        return *this;
+    }
+
+    auto get() const -> const F& { return *f_; }
+
+   private:
+    Optional<F> f_;
+};
+
+/// Presents a bitmap layout as a sequence of Optional<T&>.
+template <typename T>
+class Bitmap_iterator {
+   public:
+    using value_type = Optional<T&>;
+    using reference = Optional<T&>;
+    using pointer = void;
+    using difference_type = std::ptrdiff_t;
+    using iterator_category = std::input_iterator_tag;
+
+    Bitmap_iterator() = default;
+
+    Bitmap_iterator(const std::uint64_t* words, T* data, std::size_t i)
+        : words_{words}, data_{data}, i_{i}
+    {}
+
+    auto operator*() const -> reference
+    {
+        return {opt::detail::test_bit(words_, i_), data_[i_]};
+    }
+
+    auto operator++() -> Bitmap_iterator&
+    {
+        ++i_;
+        return *this;
+    }
+
+    auto operator++(int) -> Bitmap_iterator
+    {
+        auto copy = *this;
+        ++i_;
+        return copy;
+    }
+
+    auto operator==(const Bitmap_iterator& x) const -> bool
+    {
+        return i_ == x.i_;
+    }
+
+    auto operator!=(const Bitmap_iterator& x) const -> bool
+    {
+        return i_ != x.i_;
+    }
+
+   private:
+    const std::uint64_t* words_{nullptr};
+    T* data_{nullptr};
+    std::size_t i_{0};
+};
+
+/// Visits the engaged elements of a bitmap layout, skipping empty words.
+template <typename T>
+class Bitmap_engaged_iterator {
+   public:
+    using value_type = std::remove_const_t<T>;
+    using reference = T&;
+    using pointer = T*;
+    using difference_type = std::ptrdiff_t;
+    using iterator_category = std::forward_iterator_tag;
+
+    Bitmap_engaged_iterator() = default;
+
+    Bitmap_engaged_iterator(const std::uint64_t* words,
+                            T* data,
+                            std::size_t i,
+                            std::size_t size)
+        : words_{words},
+          data_{data},
+          i_{opt::detail::next_set_bit(words, i, size)},
+          size_{size}
+    {}
+
+    auto operator*() const -> reference { return data_[i_]; }
+
+    auto operator->() const -> pointer { return data_ + i_; }
+
+    auto operator++() -> Bitmap_engaged_iterator&
+    {
+        i_ = opt::detail::next_set_bit(words_, i_ + 1, size_);
+        return *this;
+    }
+
+    auto operator++(int) -> Bitmap_engaged_iterator
+    {
+        auto copy = *this;
+        ++*this;
+        return copy;
+    }
+
+    auto operator==(const Bitmap_engaged_iterator& x) const -> bool
+    {
+        return i_ == x.i_;
+    }
+
+    auto operator!=(const Bitmap_engaged_iterator& x) const -> bool
+    {
+        return i_ != x.i_;
+    }
+
+   private:
+    const std::uint64_t* words_{nullptr};
+    T* data_{nullptr};
+    std::size_t i_{0};
+    std::size_t size_{0};
+};
+
+/// Visits the engaged elements of a bitmap layout, yielding copies.
+template <typename T>
+class Bitmap_flatten_iterator {
+   public:
+    using value_type = std::remove_const_t<T>;
+    using reference = value_type;
+    using pointer = void;
+    using difference_type = std::ptrdiff_t;
+    using iterator_category = std::input_iterator_tag;
+
+    Bitmap_flatten_iterator() = default;
+
+    Bitmap_flatten_iterator(const std::uint64_t* words,
+                            T* data,
+                            std::size_t i,
+                            std::size_t size)
+        : it_{words, data, i, size}
+    {}
+
+    auto operator*() const -> reference { return *it_; }
+
+    auto operator++() -> Bitmap_flatten_iterator&
+    {
+        ++it_;
+        return *this;
+    }
+
+    auto operator++(int) -> Bitmap_flatten_iterator
+    {
+        auto copy = *this;
+        ++it_;
+        return copy;
+    }
+
+    auto operator==(const Bitmap_flatten_iterator& x) const -> bool
+    {
+        return it_ == x.it_;
+    }
+
+    auto operator!=(const Bitmap_flatten_iterator& x) const -> bool
+    {
+        return it_ != x.it_;
+    }
+
+   private:
+    Bitmap_engaged_iterator<T> it_;
+};
+
+/// Visits the engaged elements of a sequence of optionals by reference.
+template <typename Iterator>
+class Engaged_iterator {
+   public:
+    using reference = decltype(**std::declval<Iterator&>());
+    using value_type = std::decay_t<reference>;
+    using pointer = std::add_pointer_t<reference>;
+    using difference_type = std::ptrdiff_t;
+    using iterator_category = std::forward_iterator_tag;
+
+    static_assert(std::is_lvalue_reference<reference>::value,
+                  "views::engaged requires elements that refer to their value, "
+                  "use views::flatten for optionals produced by value.");
+
+    Engaged_iterator() = default;
+
+    Engaged_iterator(Iterator it, Iterator last)
+        : it_{std::move(it)}, last_{std::move(last)}
+    {
+        this->skip_empty();
+    }
+
+    auto operator*() const -> reference { return **it_; }
+
+    auto operator->() const -> pointer { return std::addressof(**it_); }
+
+    auto operator++() -> Engaged_iterator&
+    {
+        ++it_;
+        this->skip_empty();
+        return *this;
+    }
+
+    auto operator++(int) -> Engaged_iterator
+    {
+        auto copy = *this;
+        ++*this;
+        return copy;
+    }
+
+    auto operator==(const Engaged_iterator& x) const -> bool
+    {
+        return it_ == x.it_;
+    }
+
+    auto operator!=(const Engaged_iterator& x) const -> bool
+    {
+        return it_ != x.it_;
+    }
+
+   private:
+    Iterator it_;
+    Iterator last_;
+
+    auto skip_empty() -> void
+    {
+        while (it_ != last_ && !*it_)
+            ++it_;
+    }
+};
+
+/// Visits the engaged elements of a sequence of optionals by value, caching
+/// the current value so each element is dereferenced once.
+template <typename Iterator>
+class Flatten_iterator {
+    using Element = decltype(*std::declval<Iterator&>());
+
+   public:
+    using value_type = std::decay_t<decltype(*std::declval<Element&>())>;
+    using reference = const value_type&;
+    using pointer = const value_type*;
+    using difference_type = std::ptrdiff_t;
+    using iterator_category = std::input_iterator_tag;
+
+    Flatten_iterator() = default;
+
+    Flatten_iterator(Iterator it, Iterator last)
+        : it_{std::move(it)}, last_{std::move(last)}
+    {
+        this->satisfy();
+    }
+
+    auto operator*() const -> reference { return *current_; }
+
+    auto operator->() const -> pointer { return current_.get_ptr(); }
+
+    auto operator++() -> Flatten_iterator&
+    {
+        ++it_;
+        this->satisfy();
+        return *this;
+    }
+
+    auto operator++(int) -> Flatten_iterator
+    {
+        auto copy = *this;
+        ++*this;
+        return copy;
+    }
+
+    auto operator==(const Flatten_iterator& x) const -> bool
+    {
+        return it_ == x.it_;
+    }
+
+    auto operator!=(const Flatten_iterator& x) const -> bool
+    {
+        return it_ != x.it_;
+    }
+
+   private:
+    Iterator it_;
+    Iterator last_;
+    Optional<value_type> current_;
+
+    auto satisfy() -> void
+    {
+        for (; it_ != last_; ++it_) {
+            auto&& x = *it_;
+            if (x) {
+                current_.emplace(*std::forward<decltype(x)>(x));
+                return;
+            }
+        }
+        current_ = opt::none;
+    }
+};
+
+/// Applies \p Fn to each element of the underlying sequence.
+template <typename Iterator, typename Fn>
+class Map_iterator {
+   public:
+    using value_type = std::decay_t<decltype(
+        std::declval<const Fn&>()(*std::declval<Iterator&>()))>;
+    using reference = value_type;
+    using pointer = void;
+    using difference_type = std::ptrdiff_t;
+    using iterator_category = std::input_iterator_tag;
+
+    Map_iterator() = default;
+
+    Map_iterator(Iterator it, Fn fn) : it_{std::move(it)}, fn_{std::move(fn)} {}
+
+    auto operator*() const -> reference { return fn_.get()(*it_); }
+
+    auto operator++() -> Map_iterator&
+    {
+        ++it_;
+        return *this;
+    }
+
+    auto operator++(int) -> Map_iterator
+    {
+        auto copy = *this;
+        ++it_;
+        return copy;
+    }
+
+    auto operator==(const Map_iterator& x) const -> bool
+    {
+        return it_ == x.it_;
+    }
+
+    auto operator!=(const Map_iterator& x) const -> bool
+    {
+        return it_ != x.it_;
+    }
+
+   private:
+    Iterator it_;
+    Function_box<Fn> fn_;
+};
+
+template <typename V>
+struct Value_or_fn {
+    V fallback;
+
+    template <typename O>
+    auto operator()(O&& o) const -> V
+    {
+        return o ? V(*std::forward<O>(o)) : fallback;
+    }
+};
+
+template <typename F>
+struct Transform_fn {
+    F f;
+
+    template <typename O>
+    auto operator()(O&& o) const
+        -> Optional<std::decay_t<decltype(f(*std::forward<O>(o)))>>
+    {
+        if (!o)
+            return opt::none;
+        return f(*std::forward<O>(o));
+    }
+};
+
+template <typename Layout>
+using Layout_value_t =
+    std::remove_pointer_t<decltype(std::declval<Layout&>().data())>;
+
+template <typename Range>
+using Iterator_t = decltype(std::begin(std::declval<Range&>()));
+
+}  // namespace detail
+
+/// \brief A pair of iterators presented as a range.
+///
+/// The iterators do not refer back to the View, so a View may be destroyed
+/// while its iterators are in use.
+template <typename Iterator>
+class View : public detail::View_base {
+   public:
+    using iterator = Iterator;
+
+    View() = default;
+
+    View(Iterator first, Iterator last)
+        : first_{std::move(first)}, last_{std::move(last)}
+    {}
+
+    auto begin() const -> Iterator { return first_; }
+
+    auto end() const -> Iterator { return last_; }
+
+    auto empty() const -> bool { return first_ == last_; }
+
+   private:
+    Iterator first_;
+    Iterator last_;
+};
+
+namespace detail {
+
+template <typename T>
+struct Is_view : std::false_type {};
+
+template <typename I>
+struct Is_view<View<I>> : std::true_type {};
+
+template <typename Range>
+auto check_lifetime() -> void
+{
+    static_assert(std::is_lvalue_reference<Range>::value ||
+                      Is_view<std::decay_t<Range>>::value,
+                  "Views refer to their underlying range, which must be an "
+                  "lvalue or another view.");
+}
+
+// Presents any supported range as a sequence of optionals.
+template <typename Range>
+auto as_optionals(Range& r, std::false_type)
+    -> View<Iterator_t<Range>>
+{
+    return {std::begin(r), std::end(r)};
+}
+
+template <typename Layout>
+auto as_optionals(Layout& l, std::true_type)
+    -> View<Bitmap_iterator<Layout_value_t<Layout>>>
+{
+    using Iter = Bitmap_iterator<Layout_value_t<Layout>>;
+    return {Iter{l.validity(), l.data(), 0},
+            Iter{l.validity(), l.data(), l.size()}};
+}
+
+template <typename Range>
+auto as_optionals(Range& r)
+{
+    return as_optionals(r, Is_bitmap_layout<Range>{});
+}
+
+template <typename Range>
+auto engaged_impl(Range& r, std::false_type)
+    -> View<Engaged_iterator<Iterator_t<Range>>>
+{
+    using Iter = Engaged_iterator<Iterator_t<Range>>;
+    return {Iter{std::begin(r), std::end(r)}, Iter{std::end(r), std::end(r)}};
+}
+
+template <typename Layout>
+auto engaged_impl(Layout& l, std::true_type)
+    -> View<Bitmap_engaged_iterator<Layout_value_t<Layout>>>
+{
+    using Iter = Bitmap_engaged_iterator<Layout_value_t<Layout>>;
+    return {Iter{l.validity(), l.data(), 0, l.size()},
+            Iter{l.validity(), l.data(), l.size(), l.size()}};
+}
+
+template <typename Range>
+auto flatten_impl(Range& r, std::false_type)
+    -> View<Flatten_iterator<Iterator_t<Range>>>
+{
+    using Iter = Flatten_iterator<Iterator_t<Range>>;
+    return {Iter{std::begin(r), std::end(r)}, Iter{std::end(r), std::end(r)}};
+}
+
+template <typename Layout>
+auto flatten_impl(Layout& l, std::true_type)
+    -> View<Bitmap_flatten_iterator<Layout_value_t<Layout>>>
+{
+    using Iter = Bitmap_flatten_iterator<Layout_value_t<Layout>>;
+    return {Iter{l.validity(), l.data(), 0, l.size()},
+            Iter{l.validity(), l.data(), l.size(), l.size()}};
+}
+
+template <typename Range, typename Fn>
+auto map_impl(Range& r, Fn fn)
+{
+    auto base = as_optionals(r);
+    using Iter = Map_iterator<decltype(base.begin()), Fn>;
+    return View<Iter>{Iter{base.begin(), fn}, Iter{base.end(), fn}};
+}
+
+// Value type of the elements of any supported range.
+template <typename Range>
+using Element_payload_t = std::decay_t<decltype(
+    *std::declval<decltype(*as_optionals(std::declval<Range&>()).begin())>())>;
+
+struct Engaged_adaptor {
+    template <typename Range>
+    auto operator()(Range&& r) const
+    {
+        check_lifetime<Range>();
+        return engaged_impl(r, Is_bitmap_layout<std::decay_t<Range>>{});
+    }
+};
+
+struct Flatten_adaptor {
+    template <typename Range>
+    auto operator()(Range&& r) const
+    {
+        check_lifetime<Range>();
+        return flatten_impl(r, Is_bitmap_layout<std::decay_t<Range>>{});
+    }
+};
+
+template <typename V>
+struct Values_or_adaptor {
+    V fallback;
+};
+
+template <typename F>
+struct Transform_opt_adaptor {
+    F f;
+};
+
+struct Values_or_fn {
+    template <typename Range, typename V>
+    auto operator()(Range&& r, V&& fallback) const
+    {
+        check_lifetime<Range>();
+        using Value = Element_payload_t<std::remove_reference_t<Range>>;
+        return map_impl(
+            r, Value_or_fn<Value>{Value(std::forward<V>(fallback))});
+    }
+
+    template <typename V>
+    auto operator()(V&& fallback) const -> Values_or_adaptor<std::decay_t<V>>
+    {
+        return {std::forward<V>(fallback)};
+    }
+};
+
+struct Transform_opt_fn {
+    template <typename Range, typename F>
+    auto operator()(Range&& r, F f) const
+    {
+        check_lifetime<Range>();
+        return map_impl(r, Transform_fn<F>{std::move(f)});
+    }
+
+    template <typename F>
+    auto operator()(F f) const -> Transform_opt_adaptor<F>
+    {
+        return {std::move(f)};
+    }
+};
+
+template <typename Range>
+auto operator|(Range&& r, Engaged_adaptor a)
+{
+    return a(std::forward<Range>(r));
+}
+
+template <typename Range>
+auto operator|(Range&& r, Flatten_adaptor a)
+{
+    return a(std::forward<Range>(r));
+}
+
+template <typename Range, typename V>
+auto operator|(Range&& r, Values_or_adaptor<V> a)
+{
+    return Values_or_fn{}(std::forward<Range>(r), std::move(a.fallback));
+}
+
+template <typename Range, typename F>
+auto operator|(Range&& r, Transform_opt_adaptor<F> a)
+{
+    return Transform_opt_fn{}(std::forward<Range>(r), std::move(a.f));
+}
+
+}  // namespace detail
+
+/// \brief References to the values of the engaged elements.
+///
+/// The underlying elements must refer to their values, as Optional<T>
+/// lvalues and Optional<T&> do.
+constexpr detail::Engaged_adaptor engaged{};
+
+/// \brief The value of each element, or the fallback for empty elements.
+///
+/// Called as values_or(range, fallback) or range | values_or(fallback).
+constexpr detail::Values_or_fn values_or{};
+
+/// \brief Optional<f(x)> for each element x, empty where x is empty.
+///
+/// Called as transform_opt(range, f) or range | transform_opt(f).
+constexpr detail::Transform_opt_fn transform_opt{};
+
+/// \brief Copies of the values of the engaged elements.
+///
+/// Unlike engaged, also accepts optionals produced by value, such as the
+/// elements of a transform_opt view.
+constexpr detail::Flatten_adaptor flatten{};
+
+}  // namespace views
+}  // namespace opt
+
+#if defined(__cpp_lib_ranges)
+namespace std {
+namespace ranges {
+
+template <typename Iterator>
+inline constexpr bool enable_borrowed_range<opt::views::View<Iterator>> = true;
+
+}  // namespace ranges
+}  // namespace std
+#endif
+
+#endif  // OPTIONAL_VIEWS_HPP
@@ -0,0 +1,328 @@
+/// \file
+/// \brief Reading and writing optional fields of packed little endian
+/// messages in place.
+///
+/// A standalone optional field is a presence byte, 1 or 0, followed by
+/// sizeof(T) payload bytes, zero when empty. A Wire_message packs several
+/// fields as a presence bitmap followed by every payload, with no alignment
+/// padding, so each field has a fixed offset known at compile time.
+///
+/// \code
+/// using Quote = opt::Wire_message<std::uint32_t, double, double>;
+/// unsigned char buffer[Quote::size()];
+/// Quote::encode(buffer, id, bid, opt::none);
+/// if (auto bid = Quote::view<1>(buffer))
+///     use(*bid);
+/// \endcode
+///
+/// Payloads are read and written with memcpy, so buffers need no alignment.
+#ifndef OPTIONAL_WIRE_HPP
+#define OPTIONAL_WIRE_HPP
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <optional/bad_optional_access.hpp>
+#include <optional/none.hpp>
+#include <optional/optional_value.hpp>
+
+namespace opt {
+namespace detail {
+
+template <std::size_t N>
+struct Wire_uint;
+
+template <>
+struct Wire_uint<1> {
+    using type = std::uint8_t;
+};
+
+template <>
+struct Wire_uint<2> {
+    using type = std::uint16_t;
+};
+
+template <>
+struct Wire_uint<4> {
+    using type = std::uint32_t;
+};
+
+template <>
+struct Wire_uint<8> {
+    using type = std::uint64_t;
+};
+
+inline auto byte_swap(std::uint8_t x) -> std::uint8_t { return x; }
+
+inline auto byte_swap(std::uint16_t x) -> std::uint16_t
+{
+    return static_cast<std::uint16_t>((x << 8) | (x >> 8));
+}
+
+inline auto byte_swap(std::uint32_t x) -> std::uint32_t
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_bswap32(x);
+#else
+    return ((x & 0xFFu) << 24) | ((x & 0xFF00u) << 8) | ((x >> 8) & 0xFF00u) |
+           (x >> 24);
+#endif
+}
+
+inline auto byte_swap(std::uint64_t x) -> std::uint64_t
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_bswap64(x);
+#else
+    return (std::uint64_t{byte_swap(static_cast<std::uint32_t>(x))} << 32) |
+           byte_swap(static_cast<std::uint32_t>(x >> 32));
+#endif
+}
+
+// Converts between native and little endian byte order, in either direction.
+template <typename U>
+auto to_little_endian(U x) -> U
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    return byte_swap(x);
+#else
+    return x;
+#endif
+}
+
+template <typename T>
+using Enable_wire = std::enable_if_t<
+    (std::is_arithmetic<T>::value || std::is_enum<T>::value) &&
+    !std::is_same<T, bool>::value>;
+
+template <typename T>
+auto load_le(const unsigned char* p) -> T
+{
+    using U = typename Wire_uint<sizeof(T)>::type;
+    U bits;
+    std::memcpy(&bits, p, sizeof(U));
+    bits = to_little_endian(bits);
+    T x;
+    std::memcpy(&x, &bits, sizeof(T));
+    return x;
+}
+
+template <typename T>
+auto store_le(unsigned char* p, T x) -> void
+{
+    using U = typename Wire_uint<sizeof(T)>::type;
+    U bits;
+    std::memcpy(&bits, &x, sizeof(T));
+    bits = to_little_endian(bits);
+    std::memcpy(p, &bits, sizeof(U));
+}
+
+template <typename... Ts>
+struct Wire_layout {
+    static constexpr std::size_t presence_bytes = (sizeof...(Ts) + 7) / 8;
+
+    // Payload offset of field i, or the message size for i == sizeof...(Ts).
+    static constexpr auto offset(std::size_t i) -> std::size_t
+    {
+        constexpr std::size_t sizes[] = {sizeof(Ts)..., 0};
+        std::size_t offset = presence_bytes;
+        for (std::size_t j = 0; j < i; ++j)
+            offset += sizes[j];
+        return offset;
+    }
+};
+
+}  // namespace detail
+
+/// \brief An optional T read directly from an encoded buffer.
+///
+/// The view holds pointers into the buffer, which must outlive it. Values
+/// are decoded on access and returned by value.
+template <typename T, typename = detail::Enable_wire<T>>
+class Wire_optional_view {
+   public:
+    /// \brief Views a standalone field, a presence byte then the payload.
+    explicit Wire_optional_view(const unsigned char* field)
+        : presence_{field}, payload_{field + 1}, bit_{0}
+    {}
+
+    /// \brief Views a field whose presence is bit \p bit of \p presence.
+    Wire_optional_view(const unsigned char* presence,
+                       unsigned bit,
+                       const unsigned char* payload)
+        : presence_{presence + bit / 8}, payload_{payload}, bit_{bit % 8}
+    {}
+
+#if defined(__cpp_lib_byte)
+    explicit Wire_optional_view(const std::byte* field)
+        : Wire_optional_view{reinterpret_cast<const unsigned char*>(field)}
+    {}
+#endif
+
+    explicit operator bool() const noexcept
+    {
+        return ((*presence_ >> bit_) & 1u) != 0;
+    }
+
+    auto operator!() const noexcept -> bool { return !bool(*this); }
+
+    /// \brief Decodes the payload, which must be present.
+    auto operator*() const -> T { return detail::load_le<T>(payload_); }
+
+    /// \brief Decodes the payload.
+    /// \throws Bad_optional_access If the field is empty.
+    auto value() const -> T
+    {
+        if (!*this)
+            throw Bad_optional_access();
+        return **this;
+    }
+
+    /// \returns The decoded payload, or \p val if the field is empty.
+    auto value_or(T val) const -> T { return *this ? **this : val; }
+
+    /// \returns A decoded copy of the field.
+    auto to_optional() const -> Optional<T>
+    {
+        if (!*this)
+            return opt::none;
+        return **this;
+    }
+
+   private:
+    const unsigned char* presence_;
+    const unsigned char* payload_;
+    unsigned bit_;
+};
+
+/// \returns The encoded size of a standalone Optional<T> field.
+template <typename T, typename = detail::Enable_wire<T>>
+constexpr auto wire_size() -> std::size_t
+{
+    return 1 + sizeof(T);
+}
+
+/// \brief Encodes \p x as a standalone field at \p out, which must have room
+/// for wire_size<T>() bytes.
+/// \returns The end of the encoded field.
+template <typename T, typename = detail::Enable_wire<T>>
+auto encode(const Optional<T>& x, unsigned char* out) -> unsigned char*
+{
+    out[0] = static_cast<unsigned char>(bool(x));
+    detail::store_le(out + 1, x ? *x : T{});
+    return out + wire_size<T>();
+}
+
+#if defined(__cpp_lib_byte)
+template <typename T, typename = detail::Enable_wire<T>>
+auto encode(const Optional<T>& x, std::byte* out) -> std::byte*
+{
+    return reinterpret_cast<std::byte*>(
+        opt::encode(x, reinterpret_cast<unsigned char*>(out)));
+}
+#endif
+
+/// \brief Compile time layout of a message of optional fields of types Ts.
+///
+/// The message starts with a presence bitmap, bit I of byte I / 8 set if
+/// field I is present, followed by the little endian payload of each field
+/// in order. Empty fields keep their space and are written as zeros.
+template <typename... Ts>
+class Wire_message {
+    static_assert(sizeof...(Ts) >= 1, "A message has at least one field.");
+
+    using Layout = detail::Wire_layout<Ts...>;
+
+   public:
+    template <std::size_t I>
+    using Field_t = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+    /// \returns The number of fields.
+    static constexpr auto field_count() -> std::size_t
+    {
+        return sizeof...(Ts);
+    }
+
+    /// \returns The encoded size of a message.
+    static constexpr auto size() -> std::size_t
+    {
+        return Layout::offset(sizeof...(Ts));
+    }
+
+    /// \returns The offset of the payload of field \p I.
+    template <std::size_t I>
+    static constexpr auto offset() -> std::size_t
+    {
+        static_assert(I < sizeof...(Ts), "Field index out of range.");
+        return Layout::offset(I);
+    }
+
+    /// \returns A view of field \p I of the message at \p message.
+    template <std::size_t I>
+    static auto view(const unsigned char* message)
+        -> Wire_optional_view<Field_t<I>>
+    {
+        return {message, I, message + offset<I>()};
+    }
+
+    /// \brief Overwrites field \p I of the message at \p message.
+    template <std::size_t I>
+    static auto write(unsigned char* message, const Optional<Field_t<I>>& x)
+        -> void
+    {
+        auto const bit = static_cast<unsigned char>(1u << (I % 8));
+        auto& presence = message[I / 8];
+        presence = static_cast<unsigned char>(x ? presence | bit
+                                                : presence & ~bit);
+        detail::store_le(message + offset<I>(), x ? *x : Field_t<I>{});
+    }
+
+    /// \brief Encodes a whole message at \p out, which must have room for
+    /// size() bytes.
+    /// \returns The end of the message.
+    static auto encode(unsigned char* out, const Optional<Ts>&... fields)
+        -> unsigned char*
+    {
+        std::memset(out, 0, Layout::presence_bytes);
+        encode_fields(out, std::index_sequence_for<Ts...>{}, fields...);
+        return out + size();
+    }
+
+#if defined(__cpp_lib_byte)
+    template <std::size_t I>
+    static auto view(const std::byte* message) -> Wire_optional_view<Field_t<I>>
+    {
+        return view<I>(reinterpret_cast<const unsigned char*>(message));
+    }
+
+    template <std::size_t I>
+    static auto write(std::byte* message, const Optional<Field_t<I>>& x)
+        -> void
+    {
+        write<I>(reinterpret_cast<unsigned char*>(message), x);
+    }
+
+    static auto encode(std::byte* out, const Optional<Ts>&... fields)
+        -> std::byte*
+    {
+        return reinterpret_cast<std::byte*>(
+            encode(reinterpret_cast<unsigned char*>(out), fields...));
+    }
+#endif
+
+   private:
+    template <std::size_t... Is>
+    static auto encode_fields(unsigned char* out,
+                              std::index_sequence<Is...>,
+                              const Optional<Ts>&... fields) -> void
+    {
+        using Expand = int[];
+        (void)Expand{0, (write<Is>(out, fields), 0)...};
+    }
+};
+
+}  // namespace opt
+#endif  // OPTIONAL_WIRE_HPP
@@ -0,0 +1,236 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <optional/algorithm.hpp>
+#include <optional/none.hpp>
+#include <optional/optional_free_functions.hpp>
+#include <optional/optional_reference.hpp>
+#include <optional/optional_value.hpp>
+
+using opt::Optional;
+
+namespace {
+
+template <typename T, typename Generator>
+auto random_optionals(std::size_t n, Generator gen)
+    -> std::vector<Optional<T>>
+{
+    std::mt19937 rng{42};
+    std::vector<Optional<T>> v;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (rng() % 4 == 0)
+            v.push_back(opt::none);
+        else
+            v.push_back(gen(rng));
+    }
+    return v;
+}
+
+template <typename T>
+auto check_sorted(std::vector<Optional<T>> v) -> void
+{
+    auto expected = v;
+    std::sort(expected.begin(), expected.end());
+    opt::sort(v.begin(), v.end());
+    ASSERT_EQ(expected.size(), v.size());
+    for (std::size_t i = 0; i < v.size(); ++i) {
+        ASSERT_EQ(bool(expected[i]), bool(v[i])) << i;
+        if (v[i]) {
+            ASSERT_EQ(*expected[i], *v[i]) << i;
+        }
+    }
+}
+
+}  // namespace
+
+TEST(AlgorithmTest, PartitionEmpties) {
+    std::vector<Optional<int>> v{1, opt::none, 2, opt::none, 3};
+    auto const mid = opt::partition_empties(v.begin(), v.end());
+    EXPECT_EQ(2, mid - v.begin());
+    EXPECT_FALSE(v[0]);
+    EXPECT_FALSE(v[1]);
+    for (auto it = mid; it != v.end(); ++it)
+        EXPECT_TRUE(*it);
+}
+
+TEST(AlgorithmTest, SortSmall) {
+    std::vector<Optional<int>> v{3, opt::none, -1, 2, opt::none};
+    opt::sort(v.begin(), v.end());
+    EXPECT_FALSE(v[0]);
+    EXPECT_FALSE(v[1]);
+    EXPECT_EQ(-1, *v[2]);
+    EXPECT_EQ(2, *v[3]);
+    EXPECT_EQ(3, *v[4]);
+}
+
+TEST(AlgorithmTest, SortIntegralRadix) {
+    check_sorted(random_optionals<std::int32_t>(
+        5000, [](std::mt19937& r) { return static_cast<std::int32_t>(r()); }));
+    check_sorted(random_optionals<std::uint64_t>(5000, [](std::mt19937& r) {
+        return (std::uint64_t{r()} << 32) | r();
+    }));
+    check_sorted(random_optionals<std::int16_t>(
+        5000, [](std::mt19937& r) { return static_cast<std::int16_t>(r()); }));
+    check_sorted(random_optionals<std::int64_t>(
+        5000, [](std::mt19937& r) { return std::int64_t(r() % 100) - 50; }));
+    check_sorted(random_optionals<std::uint8_t>(
+        5000, [](std::mt19937& r) { return static_cast<std::uint8_t>(r()); }));
+}
+
+TEST(AlgorithmTest, SortFloatingRadix) {
+    check_sorted(random_optionals<double>(5000, [](std::mt19937& r) {
+        return std::uniform_real_distribution<double>{-1e6, 1e6}(r);
+    }));
+    check_sorted(random_optionals<float>(5000, [](std::mt19937& r) {
+        auto const x = std::uniform_real_distribution<float>{-10, 10}(r);
+        return r() % 10 == 0 ? std::numeric_limits<float>::infinity() * x : x;
+    }));
+}
+
+TEST(AlgorithmTest, SortNonArithmetic) {
+    check_sorted(random_optionals<std::string>(
+        1000, [](std::mt19937& r) { return std::to_string(r() % 500); }));
+}
+
+TEST(AlgorithmTest, SortWithComparator) {
+    std::vector<Optional<int>> v{1, opt::none, 3, 2};
+    opt::sort(v.begin(), v.end(), [](int a, int b) { return a > b; });
+    EXPECT_FALSE(v[0]);
+    EXPECT_EQ(3, *v[1]);
+    EXPECT_EQ(2, *v[2]);
+    EXPECT_EQ(1, *v[3]);
+}
+
+TEST(AlgorithmTest, SortReferencesRebinds) {
+    int a = 3;
+    int b = 1;
+    int c = 2;
+    std::vector<Optional<int&>> v{a, opt::none, b, c};
+    opt::sort(v.begin(), v.end(), std::less<int>{});
+    EXPECT_FALSE(v[0]);
+    EXPECT_EQ(&b, &*v[1]);
+    EXPECT_EQ(&c, &*v[2]);
+    EXPECT_EQ(&a, &*v[3]);
+    EXPECT_EQ(3, a);
+}
+
+TEST(AlgorithmTest, SortManyReferencesRebinds) {
+    // Past the size at which owned arithmetic payloads are radix sorted.
+    std::vector<int> store(300);
+    for (std::size_t i = 0; i < store.size(); ++i)
+        store[i] = static_cast<int>(store.size() - i);
+    auto const original = store;
+    std::vector<Optional<int&>> v;
+    std::vector<Optional<const int&>> cv;
+    for (auto& x : store) {
+        v.emplace_back(x);
+        cv.emplace_back(x);
+    }
+    v.emplace_back(opt::none);
+    opt::sort(v.begin(), v.end());
+    opt::sort(cv.begin(), cv.end());
+    EXPECT_EQ(original, store);
+    EXPECT_FALSE(v[0]);
+    for (std::size_t i = 0; i < store.size(); ++i) {
+        EXPECT_EQ(&store[store.size() - 1 - i], &*v[i + 1]);
+        EXPECT_EQ(&store[store.size() - 1 - i], &*cv[i]);
+    }
+}
+
+TEST(AlgorithmTest, SortAllEmptyAndEmpty) {
+    std::vector<Optional<int>> v(300);
+    opt::sort(v.begin(), v.end());
+    for (auto const& x : v)
+        EXPECT_FALSE(x);
+    v.clear();
+    opt::sort(v.begin(), v.end());
+}
+
+TEST(AlgorithmTest, Search) {
+    std::vector<Optional<int>> v{opt::none, opt::none, 1, 3, 3, 3, 7};
+    auto const b = v.begin();
+    EXPECT_EQ(2, opt::first_engaged(b, v.end()) - b);
+
+    EXPECT_EQ(0, opt::lower_bound(b, v.end(), Optional<int>{}) - b);
+    EXPECT_EQ(2, opt::upper_bound(b, v.end(), Optional<int>{}) - b);
+    EXPECT_EQ(3, opt::lower_bound(b, v.end(), Optional<int>{3}) - b);
+    EXPECT_EQ(6, opt::upper_bound(b, v.end(), Optional<int>{3}) - b);
+    EXPECT_EQ(2, opt::lower_bound(b, v.end(), Optional<int>{-5}) - b);
+    EXPECT_EQ(7, opt::lower_bound(b, v.end(), Optional<int>{8}) - b);
+
+    auto const r = opt::equal_range(b, v.end(), Optional<int>{3});
+    EXPECT_EQ(3, r.first - b);
+    EXPECT_EQ(6, r.second - b);
+    auto const e = opt::equal_range(b, v.end(), Optional<int>{});
+    EXPECT_EQ(0, e.first - b);
+    EXPECT_EQ(2, e.second - b);
+    auto const m = opt::equal_range(b, v.end(), Optional<int>{5});
+    EXPECT_EQ(m.first, m.second);
+
+    for (int x = -1; x < 9; ++x) {
+        EXPECT_EQ(std::lower_bound(b, v.end(), Optional<int>{x}),
+                  opt::lower_bound(b, v.end(), Optional<int>{x}));
+    }
+}
+
+TEST(AlgorithmTest, CompareN) {
+    auto const a = random_optionals<int>(150, [](auto& rng) {
+        return static_cast<int>(rng() % 3);
+    });
+    auto b = a;
+    std::reverse(b.begin(), b.end());
+    std::vector<std::uint64_t> mask(3, ~std::uint64_t{0});
+
+    auto const count = opt::compare_n(a.begin(), b.begin(), a.size(),
+                                      mask.data());
+    std::size_t expected_count = 0;
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        bool const bit = (mask[i / 64] >> (i % 64)) & 1u;
+        EXPECT_EQ(a[i] == b[i], bit) << i;
+        expected_count += bit;
+    }
+    EXPECT_EQ(expected_count, count);
+    EXPECT_EQ(0u, mask[2] >> (150 % 64));
+
+    auto const less = opt::compare_n(a.data(), b.data(), a.size(), mask.data(),
+                                     std::less<>{});
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        EXPECT_EQ(a[i] < b[i], bool((mask[i / 64] >> (i % 64)) & 1u)) << i;
+    }
+    EXPECT_EQ(less, static_cast<std::size_t>(
+                        std::count_if(a.begin(), a.end(), [&](const auto& x) {
+                            return x < b[&x - a.data()];
+                        })));
+
+    EXPECT_EQ(0u, opt::compare_n(a.begin(), b.begin(), 0, mask.data()));
+
+    opt::compare_n(a.begin(), b.begin(), a.size(), mask.data(),
+                   std::greater<>{});
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        EXPECT_EQ(a[i] > b[i], bool((mask[i / 64] >> (i % 64)) & 1u)) << i;
+    }
+}
+
+TEST(AlgorithmTest, CompareNFloating) {
+    auto const nan = std::numeric_limits<double>::quiet_NaN();
+    std::vector<Optional<double>> a{nan, 1.0, opt::none, 0.0, opt::none, -0.0};
+    std::vector<Optional<double>> b{nan, 2.0, opt::none, opt::none, 0.0, 0.0};
+    std::uint64_t equal = 0;
+    std::uint64_t less = 0;
+    opt::compare_n(a.begin(), b.begin(), a.size(), &equal);
+    opt::compare_n(a.begin(), b.begin(), a.size(), &less, std::less<>{});
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        EXPECT_EQ(a[i] == b[i], bool((equal >> i) & 1u)) << i;
+        EXPECT_EQ(a[i] < b[i], bool((less >> i) & 1u)) << i;
+    }
+    EXPECT_EQ(0b100100u, equal);
+}
@@ -0,0 +1,116 @@
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <optional/aligned_optional.hpp>
+#include <optional/optional_free_functions.hpp>
+
+using opt::Aligned_optional;
+using opt::Optional;
+using opt::Padded_optional;
+using opt::Per_thread;
+
+namespace {
+
+struct alignas(32) Vec4 {
+    double lanes[4];
+};
+
+auto is_aligned(const void* p, std::size_t align) -> bool
+{
+    return reinterpret_cast<std::uintptr_t>(p) % align == 0;
+}
+
+}  // namespace
+
+TEST(AlignedOptionalTest, PayloadAlignment) {
+    static_assert(alignof(Aligned_optional<Vec4, 64>) == 64, "");
+    static_assert(sizeof(Aligned_optional<Vec4, 64>) % 64 == 0, "");
+    static_assert(alignof(Aligned_optional<char, 16>) == 16, "");
+
+    Aligned_optional<Vec4, 64> x{Vec4{{1, 2, 3, 4}}};
+    ASSERT_TRUE(x);
+    EXPECT_TRUE(is_aligned(&*x, 64));
+    EXPECT_EQ(3, x->lanes[2]);
+
+    Aligned_optional<Vec4, 64> y[3];
+    for (auto& e : y) {
+        e.emplace();
+        EXPECT_TRUE(is_aligned(&*e, 64));
+    }
+}
+
+TEST(AlignedOptionalTest, HeapAlignment) {
+    for (int i = 0; i < 16; ++i) {
+        std::unique_ptr<Aligned_optional<int, 256>> x{
+            new Aligned_optional<int, 256>{i}};
+        EXPECT_TRUE(is_aligned(&**x, 256));
+        EXPECT_EQ(i, **x);
+    }
+    std::unique_ptr<Aligned_optional<Vec4, 128>[]> xs{
+        new Aligned_optional<Vec4, 128>[5]};
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_FALSE(xs[i]);
+        EXPECT_TRUE(is_aligned(&xs[i], 128));
+    }
+}
+
+TEST(AlignedOptionalTest, OptionalInterface) {
+    Aligned_optional<std::string, 64> x = opt::none;
+    EXPECT_FALSE(x);
+    x = std::string{"abc"};
+    EXPECT_EQ("abc", x.value());
+    Optional<std::string> const copy = x;
+    EXPECT_EQ(copy, x);
+    Aligned_optional<std::string, 64> const from{Optional<std::string>{"d"}};
+    EXPECT_EQ("d", *from);
+    x = opt::none;
+    EXPECT_EQ("z", x.value_or("z"));
+}
+
+TEST(AlignedOptionalTest, PaddedOptional) {
+    static_assert(sizeof(Padded_optional<int>) == opt::cache_line_size, "");
+    static_assert(alignof(Padded_optional<int>) == opt::cache_line_size, "");
+    Padded_optional<int> xs[2] = {1, opt::none};
+    auto const distance = reinterpret_cast<std::uintptr_t>(&xs[1]) -
+                          reinterpret_cast<std::uintptr_t>(&xs[0]);
+    EXPECT_EQ(opt::cache_line_size, distance);
+    EXPECT_EQ(1, *xs[0]);
+    EXPECT_FALSE(xs[1]);
+}
+
+TEST(PerThreadTest, SlotsOnSeparateLines) {
+    Per_thread<Optional<long>> results(4);
+    ASSERT_EQ(4u, results.size());
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        EXPECT_FALSE(results[i]);
+        EXPECT_TRUE(is_aligned(&results[i], opt::cache_line_size));
+    }
+    EXPECT_GE(reinterpret_cast<std::uintptr_t>(&results[1]) -
+                  reinterpret_cast<std::uintptr_t>(&results[0]),
+              opt::cache_line_size);
+
+    std::vector<std::thread> workers;
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        workers.emplace_back([&results, i] {
+            if (i % 2 == 0)
+                results[i] = static_cast<long>(i * 10);
+        });
+    }
+    for (auto& w : workers)
+        w.join();
+
+    long sum = 0;
+    std::size_t engaged = 0;
+    results.for_each([&](const Optional<long>& x) {
+        engaged += bool(x);
+        sum += x.value_or(0);
+    });
+    EXPECT_EQ(2u, engaged);
+    EXPECT_EQ(20, sum);
+}
@@ -0,0 +1,76 @@
+#include <memory>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include <optional/apply.hpp>
+#include <optional/optional_free_functions.hpp>
+
+using opt::Optional;
+
+TEST(ApplyTest, CallsWhenAllEngaged) {
+    Optional<int> a{1};
+    Optional<int> b{2};
+    Optional<int> c{3};
+    Optional<int> none;
+    auto const sum = [](int x, int y, int z) { return x + y + z; };
+
+    Optional<int> r = opt::apply(sum, a, b, c);
+    EXPECT_EQ(Optional<int>{6}, r);
+    EXPECT_FALSE(opt::apply(sum, a, none, c));
+    EXPECT_EQ(Optional<int>{7}, opt::apply([] { return 7; }));
+}
+
+TEST(ApplyTest, ReferencesAndVoid) {
+    int x = 1;
+    std::string s = "s";
+    Optional<int&> rx{x};
+    Optional<std::string&> rs{s};
+
+    bool const called = opt::apply(
+        [](int& i, std::string& t) {
+            ++i;
+            t += "!";
+        },
+        rx, rs);
+    EXPECT_TRUE(called);
+    EXPECT_EQ(2, x);
+    EXPECT_EQ("s!", s);
+    EXPECT_FALSE(opt::apply([](int&) {}, Optional<int&>{}));
+
+    auto ref = opt::apply([](int& i) -> int& { return i; }, rx);
+    static_assert(std::is_same<decltype(ref), Optional<int&>>::value, "");
+    EXPECT_EQ(&x, &*ref);
+}
+
+TEST(ApplyTest, RvaluesAreMoved) {
+    Optional<std::unique_ptr<int>> p{std::make_unique<int>(5)};
+    auto const r = opt::apply(
+        [](std::unique_ptr<int> q) { return *q; }, std::move(p));
+    EXPECT_EQ(Optional<int>{5}, r);
+}
+
+TEST(ZipTest, TupleOfReferences) {
+    Optional<int> a{1};
+    const Optional<std::string> b{"b"};
+    double d = 2.5;
+    Optional<double&> c{d};
+
+    auto t = opt::zip(a, b, c);
+    static_assert(
+        std::is_same<decltype(t), Optional<std::tuple<int&, const std::string&,
+                                                      double&>>>::value,
+        "");
+    ASSERT_TRUE(t);
+    std::get<0>(*t) = 10;
+    std::get<2>(*t) = 0.5;
+    EXPECT_EQ(10, *a);
+    EXPECT_EQ(0.5, d);
+    EXPECT_EQ("b", std::get<1>(*t));
+
+    Optional<int> none;
+    EXPECT_FALSE(opt::zip(a, none, c));
+}
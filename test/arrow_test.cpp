@@ -0,0 +1,122 @@
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <optional/arrow.hpp>
+#include <optional/none.hpp>
+#include <optional/optional_column.hpp>
+
+using opt::Optional;
+using opt::Optional_column;
+
+namespace {
+
+template <typename T>
+auto make_column(int n) -> Optional_column<T>
+{
+    Optional_column<T> c;
+    for (int i = 0; i < n; ++i)
+        c.push_back(Optional<T>{i % 4 != 1, static_cast<T>(i * 3)});
+    return c;
+}
+
+template <typename T>
+auto expect_equal(const Optional_column<T>& c, const opt::arrow::Array_view<T>& v)
+    -> void
+{
+    ASSERT_EQ(c.size(), v.size());
+    std::size_t i = 0;
+    for (Optional<const T&> x : v) {
+        ASSERT_EQ(bool(c[i]), bool(x)) << i;
+        if (x) {
+            EXPECT_EQ(*c[i], *x);
+        }
+        ++i;
+    }
+    EXPECT_EQ(c.size(), i);
+}
+
+}  // namespace
+
+TEST(ArrowTest, FormatStrings) {
+    EXPECT_STREQ("c", opt::arrow::format_of<std::int8_t>());
+    EXPECT_STREQ("S", opt::arrow::format_of<std::uint16_t>());
+    EXPECT_STREQ("i", opt::arrow::format_of<std::int32_t>());
+    EXPECT_STREQ("L", opt::arrow::format_of<std::uint64_t>());
+    EXPECT_STREQ("f", opt::arrow::format_of<float>());
+    EXPECT_STREQ("g", opt::arrow::format_of<double>());
+    EXPECT_EQ(nullptr, opt::arrow::format_of<bool>());
+}
+
+TEST(ArrowTest, BorrowingRoundTrip) {
+    auto const column = make_column<std::int32_t>(100);
+    ArrowArray array;
+    ArrowSchema schema;
+    opt::arrow::export_column(column, &array, &schema);
+
+    EXPECT_EQ(100, array.length);
+    EXPECT_EQ(25, array.null_count);
+    EXPECT_STREQ("i", schema.format);
+    EXPECT_EQ(ARROW_FLAG_NULLABLE, schema.flags);
+    EXPECT_EQ(column.validity(), array.buffers[0]);
+    EXPECT_EQ(column.data(), array.buffers[1]);
+
+    auto view = opt::arrow::import_array<std::int32_t>(array, schema);
+    ASSERT_TRUE(view);
+    EXPECT_EQ(column.data(), view->values());
+    EXPECT_EQ(75u, view->count_engaged());
+    expect_equal(column, *view);
+    EXPECT_FALSE(opt::arrow::import_array<std::uint32_t>(array, schema));
+
+    array.release(&array);
+    schema.release(&schema);
+    EXPECT_EQ(nullptr, array.release);
+    EXPECT_EQ(nullptr, schema.release);
+    EXPECT_FALSE(opt::arrow::import_array<std::int32_t>(array, schema));
+}
+
+TEST(ArrowTest, OwningExport) {
+    auto column = make_column<double>(70);
+    auto const expected = column;
+    auto const values = column.data();
+    ArrowArray array;
+    ArrowSchema schema;
+    opt::arrow::export_column(std::move(column), &array, &schema);
+    EXPECT_EQ(values, array.buffers[1]);
+
+    auto view = opt::arrow::import_array<double>(array, schema);
+    ASSERT_TRUE(view);
+    expect_equal(expected, *view);
+    array.release(&array);
+    schema.release(&schema);
+}
+
+TEST(ArrowTest, ImportWithOffsetAndNoBitmap) {
+    std::vector<std::int16_t> values{0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    std::uint8_t const bitmap[2] = {0xF0, 0x01};
+    const void* buffers[2] = {bitmap, values.data()};
+    ArrowArray array{};
+    array.length = 6;
+    array.offset = 3;
+    array.n_buffers = 2;
+    array.buffers = buffers;
+    array.release = [](ArrowArray* a) { a->release = nullptr; };
+    ArrowSchema schema{};
+    schema.format = "s";
+    schema.release = [](ArrowSchema* s) { s->release = nullptr; };
+
+    auto view = opt::arrow::import_array<std::int16_t>(array, schema);
+    ASSERT_TRUE(view);
+    EXPECT_FALSE((*view)[0]);
+    EXPECT_EQ(4, *(*view)[1]);
+    EXPECT_EQ(8, *(*view)[5]);
+    EXPECT_EQ(5u, view->count_engaged());
+
+    buffers[0] = nullptr;
+    auto all = opt::arrow::import_array<std::int16_t>(array, schema);
+    ASSERT_TRUE(all);
+    EXPECT_EQ(6u, all->count_engaged());
+    EXPECT_EQ(3, *(*all)[0]);
+}
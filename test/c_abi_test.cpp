@@ -0,0 +1,101 @@
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <optional/c_abi.hpp>
+#include <optional/none.hpp>
+#include <optional/optional_free_functions.hpp>
+
+using opt::Optional;
+
+namespace {
+
+struct Point {
+    float x;
+    float y;
+    std::int32_t id;
+};
+
+}  // namespace
+
+OPT_C_DEFINE_OPTIONAL(opt_optional_point, Point)
+OPTIONAL_C_ABI_MAP(opt_optional_point, Point)
+
+TEST(CAbiTest, ArithmeticArraysInPlace) {
+    std::vector<Optional<std::int64_t>> xs{1, opt::none, 3, opt::none, 5};
+    auto const c = opt::c_abi::as_c(xs.data());
+    EXPECT_TRUE(opt_optional_int64_has_value(&c[0]));
+    EXPECT_FALSE(opt_optional_int64_has_value(&c[1]));
+    EXPECT_EQ(3, opt_optional_int64_value_or(&c[2], -1));
+    EXPECT_EQ(-1, opt_optional_int64_value_or(&c[3], -1));
+    EXPECT_EQ(3u, opt_optional_int64_count(c, xs.size()));
+
+    std::int64_t values[5];
+    opt_optional_int64_values_or(c, xs.size(), 0, values);
+    EXPECT_EQ(5, values[4]);
+    EXPECT_EQ(0, values[1]);
+    EXPECT_EQ(3u, opt_optional_int64_compact(c, xs.size(), values));
+    EXPECT_EQ(3, values[1]);
+
+    std::uint64_t words[1];
+    opt_optional_int64_validity(c, xs.size(), words);
+    EXPECT_EQ(0x15u, words[0]);
+}
+
+TEST(CAbiTest, StructsFromC) {
+    opt_optional_double c[3] = {opt_optional_double_some(2.5),
+                                opt_optional_double_none(),
+                                opt_optional_double_some(-1.0)};
+    auto const xs = opt::c_abi::from_c(c);
+    EXPECT_EQ(Optional<double>{2.5}, xs[0]);
+    EXPECT_FALSE(xs[1]);
+    EXPECT_EQ(Optional<double>{-1.0}, xs[2]);
+
+    auto const ys = opt::c_abi::from_c(static_cast<opt_optional_double*>(c));
+    ys[1] = 4.0;
+    EXPECT_TRUE(opt_optional_double_has_value(&c[1]));
+    EXPECT_EQ(4.0, c[1].value);
+    ys[0] = opt::none;
+    EXPECT_FALSE(c[0].engaged);
+}
+
+TEST(CAbiTest, UserDefinedPod) {
+    std::vector<Optional<Point>> xs(4);
+    xs[2] = Point{1.f, 2.f, 7};
+    auto const c = opt::c_abi::as_c(xs.data());
+    EXPECT_EQ(1u, opt_optional_point_count(c, xs.size()));
+    EXPECT_EQ(7, c[2].value.id);
+}
+
+TEST(CAbiTest, ReferencesAreNullablePointers) {
+    static_assert(sizeof(Optional<const double&>) == sizeof(const double*),
+                  "");
+    double a = 1.5;
+    double b = 2.5;
+    std::vector<Optional<double&>> xs{a, opt::none, b};
+    auto const ps = opt::c_abi::as_c(xs.data());
+    EXPECT_EQ(&a, ps[0]);
+    EXPECT_EQ(nullptr, ps[1]);
+    EXPECT_EQ(&b, ps[2]);
+
+    const double* raw[2] = {nullptr, &b};
+    auto const ys = opt::c_abi::from_c(raw);
+    EXPECT_FALSE(ys[0]);
+    EXPECT_EQ(&b, &*ys[1]);
+}
+
+TEST(CAbiTest, Bool) {
+    Optional<bool> const xs[3] = {true, opt::none, false};
+    auto const c = opt::c_abi::as_c(xs);
+    EXPECT_EQ(1u, c[0].state);
+    EXPECT_EQ(OPT_C_BOOL_EMPTY, c[1].state);
+    EXPECT_EQ(0u, c[2].state);
+    EXPECT_TRUE(opt_optional_bool_value_or(&c[1], true));
+
+    opt_optional_bool const from[2] = {opt_optional_bool_none(),
+                                       opt_optional_bool_some(true)};
+    auto const ys = opt::c_abi::from_c(from);
+    EXPECT_FALSE(ys[0]);
+    EXPECT_EQ(Optional<bool>{true}, ys[1]);
+}
@@ -0,0 +1,132 @@
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <optional/checked.hpp>
+#include <optional/optional_free_functions.hpp>
+#include <optional/optional_value.hpp>
+
+using opt::Optional;
+
+TEST(CheckedTest, Add) {
+    int const max = std::numeric_limits<int>::max();
+    int const min = std::numeric_limits<int>::min();
+    EXPECT_EQ(Optional<int>{5}, opt::checked_add(2, 3));
+    EXPECT_EQ(Optional<int>{max}, opt::checked_add(max - 1, 1));
+    EXPECT_FALSE(opt::checked_add(max, 1));
+    EXPECT_FALSE(opt::checked_add(min, -1));
+    EXPECT_FALSE(opt::checked_add<std::uint8_t>(200, 56));
+    EXPECT_EQ(Optional<std::uint8_t>{255},
+              opt::checked_add<std::uint8_t>(200, 55));
+}
+
+TEST(CheckedTest, SubMul) {
+    int const max = std::numeric_limits<int>::max();
+    int const min = std::numeric_limits<int>::min();
+    EXPECT_EQ(Optional<int>{-1}, opt::checked_sub(2, 3));
+    EXPECT_FALSE(opt::checked_sub(min, 1));
+    EXPECT_FALSE(opt::checked_sub(0u, 1u));
+
+    EXPECT_EQ(Optional<int>{-6}, opt::checked_mul(2, -3));
+    EXPECT_FALSE(opt::checked_mul(max / 2 + 1, 2));
+    EXPECT_FALSE(opt::checked_mul(min, -1));
+    EXPECT_EQ(Optional<std::int64_t>{std::int64_t{1} << 62},
+              opt::checked_mul(std::int64_t{1} << 31, std::int64_t{1} << 31));
+    EXPECT_FALSE(opt::checked_mul(std::uint64_t{1} << 32,
+                                  std::uint64_t{1} << 32));
+}
+
+TEST(CheckedTest, DivNeg) {
+    int const min = std::numeric_limits<int>::min();
+    EXPECT_EQ(Optional<int>{-3}, opt::checked_div(7, -2));
+    EXPECT_FALSE(opt::checked_div(7, 0));
+    EXPECT_FALSE(opt::checked_div(min, -1));
+    EXPECT_EQ(Optional<unsigned>{3u}, opt::checked_div(7u, 2u));
+
+    EXPECT_EQ(Optional<int>{-4}, opt::checked_neg(4));
+    EXPECT_FALSE(opt::checked_neg(min));
+    EXPECT_EQ(Optional<unsigned>{0u}, opt::checked_neg(0u));
+    EXPECT_FALSE(opt::checked_neg(1u));
+}
+
+TEST(CheckedTest, Shl) {
+    EXPECT_EQ(Optional<int>{8}, opt::checked_shl(1, 3));
+    EXPECT_EQ(Optional<int>{1 << 30}, opt::checked_shl(1, 30));
+    EXPECT_FALSE(opt::checked_shl(1, 31));
+    EXPECT_FALSE(opt::checked_shl(-1, 1));
+    EXPECT_FALSE(opt::checked_shl(1, -1));
+    EXPECT_FALSE(opt::checked_shl(1, 32));
+    EXPECT_EQ(Optional<unsigned>{1u << 31}, opt::checked_shl(1u, 31));
+    EXPECT_FALSE(opt::checked_shl(3u, 31));
+    EXPECT_EQ(Optional<std::uint8_t>{128},
+              opt::checked_shl(std::uint8_t{1}, 7));
+    EXPECT_FALSE(opt::checked_shl(std::uint8_t{1}, 8));
+}
+
+TEST(CheckedTest, NarrowIntegral) {
+    EXPECT_EQ(Optional<std::uint8_t>{255}, opt::narrow<std::uint8_t>(255));
+    EXPECT_FALSE(opt::narrow<std::uint8_t>(256));
+    EXPECT_FALSE(opt::narrow<std::uint8_t>(-1));
+    EXPECT_FALSE(opt::narrow<unsigned>(-1));
+    EXPECT_FALSE(opt::narrow<int>(std::numeric_limits<unsigned>::max()));
+    EXPECT_EQ(Optional<std::int8_t>{-128}, opt::narrow<std::int8_t>(-128L));
+    EXPECT_EQ(Optional<std::int64_t>{-5}, opt::narrow<std::int64_t>(-5));
+}
+
+TEST(CheckedTest, NarrowFloating) {
+    EXPECT_EQ(Optional<int>{3}, opt::narrow<int>(3.0));
+    EXPECT_FALSE(opt::narrow<int>(3.5));
+    EXPECT_FALSE(opt::narrow<int>(std::nan("")));
+    EXPECT_FALSE(opt::narrow<int>(2147483648.0));
+    EXPECT_EQ(Optional<int>{std::numeric_limits<int>::min()},
+              opt::narrow<int>(-2147483648.0));
+    EXPECT_FALSE(opt::narrow<unsigned>(-1.0));
+    EXPECT_FALSE(opt::narrow<std::int64_t>(9.3e18));
+
+    EXPECT_EQ(Optional<float>{16777216.0f}, opt::narrow<float>(16777216));
+    EXPECT_FALSE(opt::narrow<float>(16777217));
+    EXPECT_FALSE(opt::narrow<float>(std::numeric_limits<std::int64_t>::max()));
+
+    EXPECT_EQ(Optional<float>{0.5f}, opt::narrow<float>(0.5));
+    EXPECT_FALSE(opt::narrow<float>(0.1));
+    EXPECT_FALSE(opt::narrow<float>(1e300));
+    EXPECT_TRUE(std::isinf(*opt::narrow<float>(
+        std::numeric_limits<double>::infinity())));
+    EXPECT_TRUE(std::isnan(*opt::narrow<float>(std::nan(""))));
+    EXPECT_EQ(Optional<double>{0.1f}, opt::narrow<double>(0.1f));
+}
+
+TEST(CheckedTest, Spans) {
+    int const max = std::numeric_limits<int>::max();
+    std::vector<int> x(100, 1);
+    std::vector<int> y(100, 2);
+    x[3] = max;
+    x[70] = max - 1;
+    x[99] = std::numeric_limits<int>::min();
+    std::vector<int> out(100);
+    std::vector<std::uint64_t> validity(2, ~std::uint64_t{0});
+
+    EXPECT_EQ(98u, opt::checked_add(x.data(), y.data(), x.size(), out.data(),
+                                    validity.data()));
+    EXPECT_EQ(3, out[0]);
+    EXPECT_EQ(0, out[3]);
+    EXPECT_EQ(0, out[70]);
+    EXPECT_EQ(~(std::uint64_t{1} << 3), validity[0]);
+    EXPECT_EQ((std::uint64_t{1} << 36) - 1 - (std::uint64_t{1} << 6),
+              validity[1]);
+
+    EXPECT_EQ(99u, opt::checked_sub(x.data(), y.data(), x.size(), out.data(),
+                                    validity.data()));
+    EXPECT_EQ(max - 2, out[3]);
+    EXPECT_EQ(0, out[99]);
+
+    EXPECT_EQ(97u, opt::checked_mul(x.data(), y.data(), x.size(), out.data(),
+                                    validity.data()));
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        EXPECT_EQ(opt::checked_mul(x[i], y[i]).value_or(0), out[i]) << i;
+    }
+}
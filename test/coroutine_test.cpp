@@ -0,0 +1,151 @@
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include <optional/coroutine.hpp>
+#include <optional/none.hpp>
+#include <optional/optional_reference.hpp>
+#include <optional/optional_value.hpp>
+
+#if defined(OPTIONAL_HAS_COROUTINES)
+using opt::Optional;
+
+namespace {
+
+int evaluated = 0;
+
+Optional<int> half(int x)
+{
+    if (x % 2 != 0)
+        return opt::none;
+    return x / 2;
+}
+
+Optional<int> add(Optional<int> a, Optional<int> b)
+{
+    co_return co_await a + co_await b;
+}
+
+Optional<int> quarter(int x)
+{
+    auto const h = co_await half(x);
+    ++evaluated;
+    co_return co_await half(h);
+}
+
+Optional<int> count_down(int n)
+{
+    if (n == 0)
+        co_return 0;
+    co_return 1 + co_await count_down(n - 1);
+}
+
+Optional<std::string> concat(const Optional<std::string>& a,
+                             Optional<std::string> b)
+{
+    const std::string& first = co_await a;
+    std::string second = co_await std::move(b);
+    co_return first + second;
+}
+
+Optional<int> through_reference(Optional<int&> ref)
+{
+    int& r = co_await ref;
+    r *= 2;
+    co_return r;
+}
+
+Optional<int> explicit_none(bool give_none)
+{
+    if (give_none)
+        co_return opt::none;
+    co_return 5;
+}
+
+Optional<int> throws(Optional<int> x)
+{
+    auto const v = co_await x;
+    if (v > 0)
+        throw std::runtime_error{"positive"};
+    co_return v;
+}
+
+}  // namespace
+
+TEST(CoroutineTest, EngagedValuesPropagate) {
+    auto const result = add(2, 3);
+    ASSERT_TRUE(result);
+    EXPECT_EQ(5, *result);
+}
+
+TEST(CoroutineTest, EmptyShortCircuits) {
+    EXPECT_FALSE(add(opt::none, 3));
+    EXPECT_FALSE(add(2, opt::none));
+
+    evaluated = 0;
+    EXPECT_FALSE(quarter(3));
+    EXPECT_EQ(0, evaluated);
+    EXPECT_FALSE(quarter(6));
+    EXPECT_EQ(1, evaluated);
+    auto const q = quarter(12);
+    ASSERT_TRUE(q);
+    EXPECT_EQ(3, *q);
+}
+
+TEST(CoroutineTest, Recursion) {
+    auto const result = count_down(200);
+    ASSERT_TRUE(result);
+    EXPECT_EQ(200, *result);
+}
+
+TEST(CoroutineTest, LValueAndRValueAwait) {
+    Optional<std::string> a{"foo"};
+    auto const result = concat(a, std::string{"bar"});
+    ASSERT_TRUE(result);
+    EXPECT_EQ("foobar", *result);
+    EXPECT_FALSE(concat(opt::none, std::string{"bar"}));
+}
+
+TEST(CoroutineTest, ReferencePayload) {
+    int i = 4;
+    auto const result = through_reference(Optional<int&>{i});
+    ASSERT_TRUE(result);
+    EXPECT_EQ(8, *result);
+    EXPECT_EQ(8, i);
+    EXPECT_FALSE(through_reference(opt::none));
+}
+
+TEST(CoroutineTest, ReturnNone) {
+    EXPECT_FALSE(explicit_none(true));
+    EXPECT_TRUE(explicit_none(false));
+}
+
+TEST(CoroutineTest, ExceptionsPropagate) {
+    EXPECT_THROW(throws(1), std::runtime_error);
+    EXPECT_TRUE(throws(0));
+    EXPECT_FALSE(throws(opt::none));
+}
+
+TEST(CoroutineTest, FramesReturnedToArena) {
+    auto& arena = opt::detail::Coroutine_frame_arena::local();
+    auto const before = arena.used();
+    add(1, 2);
+    add(opt::none, 2);
+    count_down(10);
+    EXPECT_EQ(before, arena.used());
+}
+
+TEST(CoroutineTest, ArenaFallsBackWhenFull) {
+    auto& arena = opt::detail::Coroutine_frame_arena::local();
+    auto const size = opt::detail::Coroutine_frame_arena::capacity;
+    void* big = arena.allocate(size + 1);
+    EXPECT_FALSE(arena.owns(big));
+    void* small = arena.allocate(24);
+    EXPECT_TRUE(arena.owns(small));
+    arena.deallocate(small, 24);
+    arena.deallocate(big, size + 1);
+    EXPECT_EQ(0u, arena.used());
+}
+#endif  // defined(OPTIONAL_HAS_COROUTINES)
@@ -0,0 +1,38 @@
+#define OPTIONAL_INSTANTIATE_EXTERN_TEMPLATES
+#include <optional/extern_templates.hpp>
+
+#include <gtest/gtest.h>
+
+using opt::Optional;
+
+// This translation unit provides the explicit instantiations that other
+// users of extern_templates.hpp link against.
+
+TEST(ExternTemplatesTest, InstantiatedPayloads) {
+    Optional<int> i{3};
+    Optional<int> const j = opt::none;
+    i = j;
+    EXPECT_FALSE(i);
+    i.emplace(7);
+    EXPECT_EQ(7, i.value());
+
+    Optional<double> d{2.5};
+    EXPECT_EQ(2.5, *d);
+    EXPECT_EQ(1.0, Optional<double>{}.value_or(1.0));
+    EXPECT_THROW(Optional<unsigned long>{}.value(), opt::Bad_optional_access);
+}
+
+TEST(ExternTemplatesTest, NoexceptTraits) {
+    static_assert(noexcept(Optional<long>{std::declval<const Optional<long>&>()}),
+                  "");
+    struct Throwing_copy {
+        Throwing_copy() = default;
+        Throwing_copy(const Throwing_copy&) noexcept(false) {}
+    };
+    static_assert(!noexcept(Optional<Throwing_copy>{
+                      std::declval<const Optional<Throwing_copy>&>()}),
+                  "");
+    static_assert(noexcept(std::declval<Optional<float>&>() =
+                               std::declval<Optional<float>&&>()),
+                  "");
+}
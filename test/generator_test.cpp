@@ -0,0 +1,79 @@
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <optional/generator.hpp>
+#include <optional/pull.hpp>
+
+#if defined(OPTIONAL_HAS_COROUTINES)
+namespace {
+
+opt::Generator<const int> iota(int n)
+{
+    for (int i = 0; i < n; ++i)
+        co_yield i;
+}
+
+opt::Generator<std::string> words(std::vector<std::string>& v)
+{
+    for (auto& s : v)
+        co_yield s;
+}
+
+opt::Generator<const int> failing()
+{
+    co_yield 1;
+    throw std::runtime_error{"failed"};
+}
+
+}  // namespace
+
+TEST(GeneratorTest, YieldsThenEnds) {
+    auto g = iota(3);
+    for (int i = 0; i < 3; ++i) {
+        auto x = g.next();
+        ASSERT_TRUE(x);
+        EXPECT_EQ(i, *x);
+    }
+    EXPECT_FALSE(g.next());
+    EXPECT_FALSE(g.next());
+}
+
+TEST(GeneratorTest, YieldsReferences) {
+    std::vector<std::string> v{"a", "b"};
+    auto g = words(v);
+    auto x = g.next();
+    ASSERT_TRUE(x);
+    EXPECT_EQ(&v[0], &*x);
+    *x = std::string{"z"};
+    EXPECT_EQ("z", v[0]);
+}
+
+TEST(GeneratorTest, DefaultAndMoved) {
+    opt::Generator<const int> empty;
+    EXPECT_FALSE(empty.next());
+    auto g = iota(2);
+    auto h = std::move(g);
+    EXPECT_FALSE(g.next());
+    EXPECT_TRUE(h.next());
+}
+
+TEST(GeneratorTest, Exceptions) {
+    auto g = failing();
+    EXPECT_TRUE(g.next());
+    EXPECT_THROW(g.next(), std::runtime_error);
+    EXPECT_FALSE(g.next());
+}
+
+TEST(GeneratorTest, ComposesWithPullStages) {
+    auto p = iota(100) | opt::pull::filter([](int x) { return x % 10 == 0; }) |
+             opt::pull::map([](int x) { return x / 10; }) |
+             opt::pull::take(4);
+    std::vector<int> result;
+    while (auto x = p.next())
+        result.push_back(*x);
+    EXPECT_EQ((std::vector<int>{0, 1, 2, 3}), result);
+}
+#endif  // defined(OPTIONAL_HAS_COROUTINES)
@@ -0,0 +1,41 @@
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <unordered_set>
+
+#include <gtest/gtest.h>
+
+#include <optional/hash.hpp>
+#include <optional/none.hpp>
+#include <optional/optional_free_functions.hpp>
+#include <optional/optional_reference.hpp>
+#include <optional/optional_value.hpp>
+
+using opt::Optional;
+
+TEST(HashTest, EngagedHashesAsValue) {
+    EXPECT_EQ(std::hash<int>{}(5), opt::hash<Optional<int>>{}(5));
+    EXPECT_EQ(std::hash<std::string>{}("a"),
+              std::hash<Optional<std::string>>{}(std::string{"a"}));
+    int x = 7;
+    EXPECT_EQ(std::hash<int>{}(7), opt::hash<Optional<int&>>{}(x));
+    EXPECT_EQ(std::hash<int>{}(7), opt::hash<Optional<const int&>>{}(x));
+}
+
+TEST(HashTest, EmptyHashesConsistently) {
+    EXPECT_EQ(opt::empty_hash, opt::hash<Optional<int>>{}(opt::none));
+    EXPECT_EQ(opt::empty_hash, std::hash<Optional<std::string>>{}(opt::none));
+    EXPECT_EQ(opt::empty_hash, opt::hash<Optional<double&>>{}(opt::none));
+    EXPECT_EQ(opt::empty_hash, opt::hash<>{}(Optional<char>{}));
+}
+
+TEST(HashTest, NestedAndTransparent) {
+    Optional<Optional<int>> inner_empty{Optional<int>{}};
+    EXPECT_EQ(opt::empty_hash, opt::hash<>{}(inner_empty));
+    EXPECT_EQ(std::hash<int>{}(3), opt::hash<>{}(3));
+
+    std::unordered_set<Optional<int>> set{1, 2, opt::none};
+    EXPECT_EQ(1u, set.count(opt::none));
+    EXPECT_EQ(1u, set.count(2));
+    EXPECT_EQ(0u, set.count(3));
+}
@@ -0,0 +1,123 @@
+#include <array>
+#include <deque>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <queue>
+#include <set>
+#include <stack>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <optional/lookup.hpp>
+#include <optional/optional_free_functions.hpp>
+#include <optional/optional_reference.hpp>
+#include <optional/optional_value.hpp>
+
+using opt::Optional;
+
+TEST(LookupTest, FindMap) {
+    std::map<std::string, int, std::less<>> m{{"a", 1}, {"b", 2}};
+    auto a = opt::find(m, "a");
+    static_assert(std::is_same<decltype(a), Optional<int&>>::value, "");
+    ASSERT_TRUE(a);
+    *a = 10;
+    EXPECT_EQ(10, m["a"]);
+    EXPECT_FALSE(opt::find(m, "c"));
+    int fallback = 0;
+    EXPECT_EQ(&fallback, &opt::find(m, std::string{"z"}).value_or(fallback));
+
+    const auto& cm = m;
+    auto b = opt::find(cm, "b");
+    static_assert(std::is_same<decltype(b), Optional<const int&>>::value, "");
+    EXPECT_EQ(2, *b);
+
+    std::unordered_map<int, std::string> u{{1, "one"}};
+    EXPECT_EQ("one", *opt::find(u, 1));
+    EXPECT_FALSE(opt::find(u, 2));
+}
+
+TEST(LookupTest, FindSet) {
+    std::set<std::string, std::less<>> s{"x", "y"};
+    auto x = opt::find(s, "x");
+    static_assert(
+        std::is_same<decltype(x), Optional<const std::string&>>::value, "");
+    ASSERT_TRUE(x);
+    EXPECT_EQ(&*s.begin(), x.get_ptr());
+    EXPECT_FALSE(opt::find(s, "q"));
+}
+
+TEST(LookupTest, At) {
+    std::vector<int> v{1, 2, 3};
+    ASSERT_TRUE(opt::at(v, 2));
+    *opt::at(v, 2) = 30;
+    EXPECT_EQ(30, v[2]);
+    EXPECT_FALSE(opt::at(v, 3));
+
+    const std::deque<int> d{4};
+    EXPECT_EQ(4, *opt::at(d, 0));
+    EXPECT_FALSE(opt::at(d, 1));
+
+    int a[2] = {5, 6};
+    EXPECT_EQ(&a[1], opt::at(a, 1).get_ptr());
+    EXPECT_FALSE(opt::at(a, 2));
+
+    std::array<int, 1> arr{{7}};
+    EXPECT_EQ(7, *opt::at(arr, 0));
+}
+
+TEST(LookupTest, FrontBack) {
+    std::list<int> l;
+    EXPECT_FALSE(opt::front(l));
+    EXPECT_FALSE(opt::back(l));
+    l = {1, 2, 3};
+    EXPECT_EQ(1, *opt::front(l));
+    EXPECT_EQ(3, *opt::back(l));
+    *opt::back(l) = 4;
+    EXPECT_EQ(4, l.back());
+
+    const std::string s{"hi"};
+    EXPECT_EQ('h', *opt::front(s));
+}
+
+TEST(LookupTest, FindIf) {
+    std::vector<int> v{1, 4, 6};
+    auto even = opt::find_if(v, [](int x) { return x % 2 == 0; });
+    ASSERT_TRUE(even);
+    EXPECT_EQ(&v[1], even.get_ptr());
+    EXPECT_FALSE(opt::find_if(v, [](int x) { return x > 10; }));
+
+    int const a[] = {3, 5};
+    EXPECT_EQ(5, *opt::find_if(a, [](int x) { return x > 4; }));
+}
+
+TEST(LookupTest, Pop) {
+    std::queue<std::unique_ptr<int>> q;
+    EXPECT_FALSE(opt::pop(q));
+    q.push(std::make_unique<int>(1));
+    q.push(std::make_unique<int>(2));
+    auto first = opt::pop(q);
+    ASSERT_TRUE(first);
+    EXPECT_EQ(1, **first);
+    EXPECT_EQ(1u, q.size());
+
+    std::stack<int> s;
+    s.push(1);
+    s.push(2);
+    EXPECT_EQ(Optional<int>{2}, opt::pop(s));
+    EXPECT_EQ(Optional<int>{1}, opt::pop(s));
+    EXPECT_FALSE(opt::pop(s));
+
+    std::priority_queue<int> p;
+    p.push(3);
+    p.push(9);
+    p.push(5);
+    EXPECT_EQ(9, *opt::pop(p));
+    EXPECT_EQ(5, *opt::pop(p));
+    EXPECT_EQ(1u, p.size());
+}
@@ -0,0 +1,118 @@
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <optional/mapped_optional_column.hpp>
+#include <optional/none.hpp>
+#include <optional/optional_column.hpp>
+#include <optional/views.hpp>
+
+using opt::Mapped_column_writer;
+using opt::Mapped_optional_column;
+using opt::Optional;
+using opt::Optional_column;
+
+namespace {
+
+auto temp_path(const std::string& name) -> std::string
+{
+    return testing::TempDir() + "mapped_optional_column_" + name;
+}
+
+auto overwrite_byte(const std::string& path, long offset, char c) -> void
+{
+    std::fstream f{path, std::ios::in | std::ios::out | std::ios::binary};
+    f.seekp(offset);
+    f.put(c);
+}
+
+}  // namespace
+
+TEST(MappedOptionalColumnTest, RoundTrip) {
+    auto const path = temp_path("round_trip");
+    Optional_column<std::int64_t> expected;
+    {
+        Mapped_column_writer<std::int64_t> w{path, 7};
+        for (int i = 0; i < 100; ++i) {
+            auto const x = Optional<std::int64_t>{i % 3 != 0, i};
+            w.push_back(x);
+            expected.push_back(x);
+        }
+        // Starts mid word, so the bitmap is shifted on append.
+        Optional_column<std::int64_t> chunk;
+        for (int i = 0; i < 150; ++i)
+            chunk.push_back(Optional<std::int64_t>{i % 5 == 0, -i});
+        w.append(chunk.data(), chunk.validity(), chunk.size());
+        for (int i = 0; i < 150; ++i)
+            expected.push_back(Optional<std::int64_t>{i % 5 == 0, -i});
+        w.push_back(opt::none);
+        expected.push_back(opt::none);
+        EXPECT_EQ(251u, w.size());
+    }
+
+    auto column = Mapped_optional_column<std::int64_t>::open(path);
+    ASSERT_TRUE(column);
+    ASSERT_EQ(expected.size(), column->size());
+    EXPECT_EQ(expected.count_engaged(), column->count_engaged());
+    EXPECT_EQ(0u, column->header().values_offset % 64);
+    EXPECT_EQ(0u, column->header().validity_offset % 64);
+    EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(column->data()) % 64);
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_EQ(bool(expected[i]), bool((*column)[i])) << i;
+        if (expected[i]) {
+            EXPECT_EQ(*expected[i], *(*column)[i]);
+        }
+    }
+    EXPECT_TRUE(column->verify());
+
+    std::int64_t sum = 0;
+    for (std::int64_t x : *column | opt::views::engaged)
+        sum += x;
+    std::int64_t expected_sum = 0;
+    for (std::int64_t x : expected | opt::views::engaged)
+        expected_sum += x;
+    EXPECT_EQ(expected_sum, sum);
+    std::remove(path.c_str());
+}
+
+TEST(MappedOptionalColumnTest, EmptyColumn) {
+    auto const path = temp_path("empty");
+    Mapped_column_writer<double>{path};
+    auto column = Mapped_optional_column<double>::open(path);
+    ASSERT_TRUE(column);
+    EXPECT_TRUE(column->empty());
+    EXPECT_TRUE(column->verify());
+    std::remove(path.c_str());
+}
+
+TEST(MappedOptionalColumnTest, RejectsBadFiles) {
+    EXPECT_FALSE(Mapped_optional_column<int>::open(temp_path("missing")));
+
+    auto const path = temp_path("bad");
+    {
+        Mapped_column_writer<int> w{path};
+        for (int i = 0; i < 10; ++i)
+            w.push_back(i);
+    }
+    EXPECT_TRUE(Mapped_optional_column<int>::open(path));
+    EXPECT_FALSE(Mapped_optional_column<double>::open(path));
+
+    overwrite_byte(path, 64, 'x');
+    auto column = Mapped_optional_column<int>::open(path);
+    ASSERT_TRUE(column);
+    EXPECT_FALSE(column->verify());
+
+    overwrite_byte(path, 0, 'X');
+    EXPECT_FALSE(Mapped_optional_column<int>::open(path));
+
+    {
+        std::ofstream truncated{path, std::ios::binary | std::ios::trunc};
+        truncated << "OPTCOL";
+    }
+    EXPECT_FALSE(Mapped_optional_column<int>::open(path));
+    std::remove(path.c_str());
+}
@@ -0,0 +1,151 @@
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <optional/none.hpp>
+#include <optional/nullable.hpp>
+#include <optional/optional_bool_vector.hpp>
+#include <optional/optional_column.hpp>
+#include <optional/optional_free_functions.hpp>
+#include <optional/optional_value.hpp>
+
+using opt::Optional;
+using opt::Optional_column;
+
+namespace {
+
+template <typename T>
+auto random_column(std::size_t n, unsigned seed, int low, int high)
+    -> Optional_column<T>
+{
+    std::mt19937 rng{seed};
+    std::uniform_int_distribution<int> dist{low, high};
+    Optional_column<T> c;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (rng() % 4 == 0)
+            c.push_back(opt::none);
+        else
+            c.push_back(static_cast<T>(dist(rng)));
+    }
+    return c;
+}
+
+}  // namespace
+
+TEST(NullableTest, FusedArithmetic) {
+    using namespace opt::nullable;
+    for (std::size_t n : {0u, 5u, 64u, 130u}) {
+        auto const a = random_column<double>(n, 1, -50, 50);
+        auto const b = random_column<double>(n, 2, -50, 50);
+        auto const c = random_column<double>(n, 3, -50, 50);
+
+        Optional_column<double> const r = evaluate(a * b + c);
+        ASSERT_EQ(n, r.size());
+        for (std::size_t i = 0; i < n; ++i) {
+            if (a[i] && b[i] && c[i]) {
+                ASSERT_TRUE(r[i]);
+                EXPECT_EQ(*a[i] * *b[i] + *c[i], *r[i]);
+            }
+            else {
+                EXPECT_FALSE(r[i]) << i;
+                EXPECT_EQ(0.0, r.data()[i]);
+            }
+        }
+        if (n % 64 != 0) {
+            EXPECT_EQ(0u, r.validity()[n / 64] >> (n % 64));
+        }
+    }
+}
+
+TEST(NullableTest, ScalarsAndFunctions) {
+    using namespace opt::nullable;
+    Optional_column<int> const a{1, opt::none, -3, 4};
+    Optional_column<int> const b{2, 5, opt::none, 1};
+
+    auto const r = evaluate(2 * ref(a) - 1);
+    EXPECT_EQ(1, *r[0]);
+    EXPECT_FALSE(r[1]);
+    EXPECT_EQ(-7, *r[2]);
+
+    auto const lo = evaluate(min(a, b));
+    auto const hi = evaluate(max(a, b));
+    EXPECT_EQ(1, *lo[0]);
+    EXPECT_EQ(2, *hi[0]);
+    EXPECT_FALSE(lo[1]);
+    EXPECT_FALSE(hi[2]);
+    EXPECT_EQ(4, *hi[3]);
+
+    auto const f = evaluate(fma(a, b, 10));
+    EXPECT_EQ(12, *f[0]);
+    EXPECT_EQ(14, *f[3]);
+    EXPECT_EQ(2u, f.count_engaged());
+
+    Optional_column<double> const x{0.1, 3.0};
+    auto const d = evaluate(fma(x, 10.0, 1.0));
+    EXPECT_EQ(std::fma(0.1, 10.0, 1.0), *d[0]);
+
+    // Mixed types use the common type.
+    auto const mixed = evaluate(ref(a) * 0.5);
+    EXPECT_EQ(0.5, *mixed[0]);
+}
+
+TEST(NullableTest, IntegerDivision) {
+    using namespace opt::nullable;
+    int const min = std::numeric_limits<int>::min();
+    Optional_column<int> const a{7, 7, opt::none, min, -9};
+    Optional_column<int> const b{2, 0, 0, -1, 3};
+    auto const q = evaluate(a / b);
+    EXPECT_EQ(3, *q[0]);
+    EXPECT_FALSE(q[1]);
+    EXPECT_FALSE(q[2]);
+    EXPECT_EQ(min, *q[3]);
+    EXPECT_EQ(-3, *q[4]);
+
+    Optional_column<unsigned> const u{9u, 9u};
+    Optional_column<unsigned> const z{0u, 3u};
+    auto const uq = evaluate(u / z);
+    EXPECT_FALSE(uq[0]);
+    EXPECT_EQ(3u, *uq[1]);
+
+    Optional_column<double> const fd{1.0};
+    EXPECT_TRUE(std::isinf(*evaluate(fd / 0.0)[0]));
+}
+
+TEST(NullableTest, Comparisons) {
+    using namespace opt::nullable;
+    auto const a = random_column<int>(150, 4, 0, 5);
+    auto const b = random_column<int>(150, 5, 0, 5);
+    opt::Optional_bool_vector const lt = evaluate(less(a, b));
+    opt::Optional_bool_vector const eq = evaluate(equal(a, b));
+    opt::Optional_bool_vector const ge = evaluate(greater_equal(a + 1, b));
+    ASSERT_EQ(150u, lt.size());
+    for (std::size_t i = 0; i < 150; ++i) {
+        if (a[i] && b[i]) {
+            EXPECT_EQ(Optional<bool>{*a[i] < *b[i]}, lt[i]);
+            EXPECT_EQ(Optional<bool>{*a[i] == *b[i]}, eq[i]);
+            EXPECT_EQ(Optional<bool>{*a[i] + 1 >= *b[i]}, ge[i]);
+        }
+        else {
+            EXPECT_FALSE(lt[i]);
+            EXPECT_FALSE(ge[i]);
+        }
+    }
+    auto const big = evaluate(greater(a, 3));
+    auto const not_big = evaluate(less_equal(a, 3));
+    EXPECT_EQ(big.count_unknown(), not_big.count_unknown());
+    EXPECT_EQ(big.count_true(), not_big.count_false());
+    EXPECT_EQ(~big, evaluate(not_equal(a, a)) | not_big);
+}
+
+TEST(NullableTest, SizeMismatch) {
+    using namespace opt::nullable;
+    Optional_column<int> const a(3);
+    Optional_column<int> const b(4);
+    EXPECT_THROW(a + b, std::invalid_argument);
+}
@@ -0,0 +1,122 @@
+#include <type_traits>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include <optional/bad_optional_access.hpp>
+#include <optional/none.hpp>
+#include <optional/optional_free_functions.hpp>
+#include <optional/optional_value.hpp>
+
+using opt::Optional;
+
+TEST(OptionalBoolTest, Size) {
+    EXPECT_EQ(1u, sizeof(Optional<bool>));
+    EXPECT_TRUE(std::is_trivially_destructible<Optional<bool>>::value);
+    EXPECT_TRUE(std::is_nothrow_move_constructible<Optional<bool>>::value);
+}
+
+TEST(OptionalBoolTest, Constructors) {
+    Optional<bool> empty;
+    EXPECT_FALSE(empty);
+    Optional<bool> none{opt::none};
+    EXPECT_FALSE(none);
+
+    Optional<bool> t{true};
+    ASSERT_TRUE(t);
+    EXPECT_TRUE(*t);
+    Optional<bool> f{false};
+    ASSERT_TRUE(f);
+    EXPECT_FALSE(*f);
+
+    EXPECT_FALSE(Optional<bool>(false, true));
+    Optional<bool> c{true, false};
+    ASSERT_TRUE(c);
+    EXPECT_FALSE(*c);
+}
+
+TEST(OptionalBoolTest, CopyAndMove) {
+    Optional<bool> t{true};
+    Optional<bool> copy{t};
+    ASSERT_TRUE(copy);
+    EXPECT_TRUE(*copy);
+    EXPECT_TRUE(t);
+
+    Optional<bool> moved{std::move(t)};
+    ASSERT_TRUE(moved);
+    EXPECT_TRUE(*moved);
+    EXPECT_FALSE(t);
+
+    Optional<bool> a;
+    a = copy;
+    EXPECT_TRUE(a && *a);
+    Optional<bool> b;
+    b = std::move(a);
+    EXPECT_TRUE(b && *b);
+    EXPECT_FALSE(a);
+    b = std::move(b);
+    EXPECT_TRUE(b && *b);
+}
+
+TEST(OptionalBoolTest, Conversions) {
+    Optional<int> i{2};
+    Optional<bool> b{i};
+    EXPECT_TRUE(b && *b);
+    EXPECT_FALSE(Optional<bool>{Optional<int>{}});
+
+    Optional<int> back{b};
+    ASSERT_TRUE(back);
+    EXPECT_EQ(1, *back);
+
+    Optional<int> from_moved{std::move(b)};
+    EXPECT_TRUE(from_moved);
+    EXPECT_FALSE(b);
+
+    b = Optional<int>{0};
+    EXPECT_TRUE(b && !*b);
+    b = Optional<int>{};
+    EXPECT_FALSE(b);
+}
+
+TEST(OptionalBoolTest, Assignment) {
+    Optional<bool> b;
+    b = false;
+    ASSERT_TRUE(b);
+    EXPECT_FALSE(*b);
+    *b = true;
+    EXPECT_TRUE(*b);
+    b = opt::none;
+    EXPECT_FALSE(b);
+    b.emplace();
+    EXPECT_TRUE(b && !*b);
+    b.emplace(7);
+    EXPECT_TRUE(b && *b);
+}
+
+TEST(OptionalBoolTest, Access) {
+    Optional<bool> b;
+    EXPECT_THROW(b.value(), opt::Bad_optional_access);
+    EXPECT_TRUE(b.value_or(true));
+    EXPECT_FALSE(b.value_or_eval([] { return false; }));
+
+    b = true;
+    EXPECT_TRUE(b.value());
+    EXPECT_TRUE(b.get());
+    EXPECT_TRUE(*b.get_ptr());
+    EXPECT_TRUE(b.value_or(false));
+    EXPECT_TRUE(std::move(b).value_or(false));
+    EXPECT_FALSE(b);
+}
+
+TEST(OptionalBoolTest, Comparisons) {
+    const Optional<bool> e;
+    const Optional<bool> f{false};
+    const Optional<bool> t{true};
+    EXPECT_TRUE(e == Optional<bool>{});
+    EXPECT_TRUE(t == Optional<bool>{true});
+    EXPECT_FALSE(e == f);
+    EXPECT_FALSE(f == t);
+    EXPECT_TRUE(e < f);
+    EXPECT_TRUE(f < t);
+    EXPECT_FALSE(t < f);
+}
@@ -0,0 +1,120 @@
+#include <cstddef>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <optional/none.hpp>
+#include <optional/optional_bool_vector.hpp>
+#include <optional/optional_free_functions.hpp>
+#include <optional/optional_value.hpp>
+
+using opt::Optional;
+using opt::Optional_bool_vector;
+
+namespace {
+
+auto random_tristate(std::size_t n, unsigned seed) -> std::vector<Optional<bool>>
+{
+    std::mt19937 rng{seed};
+    std::vector<Optional<bool>> v;
+    for (std::size_t i = 0; i < n; ++i) {
+        switch (rng() % 3) {
+            case 0: v.push_back(opt::none); break;
+            case 1: v.push_back(false); break;
+            default: v.push_back(true); break;
+        }
+    }
+    return v;
+}
+
+}  // namespace
+
+TEST(OptionalBoolVectorTest, KleeneScalars) {
+    const Optional<bool> u;
+    const Optional<bool> f{false};
+    const Optional<bool> t{true};
+    EXPECT_EQ(f, opt::kleene_and(f, u));
+    EXPECT_EQ(u, opt::kleene_and(t, u));
+    EXPECT_EQ(t, opt::kleene_and(t, t));
+    EXPECT_EQ(t, opt::kleene_or(t, u));
+    EXPECT_EQ(u, opt::kleene_or(f, u));
+    EXPECT_EQ(f, opt::kleene_or(f, f));
+    EXPECT_EQ(u, opt::kleene_not(u));
+    EXPECT_EQ(f, opt::kleene_not(t));
+    EXPECT_EQ(t, opt::kleene_not(f));
+}
+
+TEST(OptionalBoolVectorTest, AccessAndCounts) {
+    Optional_bool_vector v{true, opt::none, false, true};
+    ASSERT_EQ(4u, v.size());
+    EXPECT_EQ(2u, v.count_true());
+    EXPECT_EQ(1u, v.count_false());
+    EXPECT_EQ(1u, v.count_unknown());
+    EXPECT_EQ(Optional<bool>{true}, Optional<bool>(v[0]));
+    EXPECT_FALSE(Optional<bool>(v[1]));
+
+    v[1] = false;
+    v[0] = opt::none;
+    v[3] = v[2];
+    EXPECT_EQ(Optional<bool>{}, v.get(0));
+    EXPECT_EQ(Optional<bool>{false}, v.get(1));
+    EXPECT_EQ(Optional<bool>{false}, v.get(3));
+    EXPECT_EQ(0u, v.count_true());
+    EXPECT_EQ(1u, v.count_unknown());
+
+    Optional_bool_vector u(100);
+    EXPECT_EQ(100u, u.count_unknown());
+    EXPECT_EQ(2u, u.word_count());
+}
+
+TEST(OptionalBoolVectorTest, Resize) {
+    Optional_bool_vector v;
+    for (int i = 0; i < 130; ++i)
+        v.push_back(true);
+    v.resize(65);
+    EXPECT_EQ(65u, v.count_true());
+    EXPECT_EQ(1u, v.values()[1]);
+    v.resize(70);
+    EXPECT_EQ(5u, v.count_unknown());
+    v.clear();
+    EXPECT_TRUE(v.empty());
+}
+
+TEST(OptionalBoolVectorTest, KleeneVectors) {
+    // Sizes around the word and four word boundaries.
+    for (std::size_t n : {0u, 1u, 63u, 64u, 65u, 255u, 256u, 300u}) {
+        auto const a = random_tristate(n, 1);
+        auto const b = random_tristate(n, 2);
+        Optional_bool_vector const va(a.begin(), a.end());
+        Optional_bool_vector const vb(b.begin(), b.end());
+
+        auto const conj = va & vb;
+        auto const disj = va | vb;
+        auto const neg = ~va;
+        std::size_t unknown = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            EXPECT_EQ(opt::kleene_and(a[i], b[i]), conj[i]) << n << ' ' << i;
+            EXPECT_EQ(opt::kleene_or(a[i], b[i]), disj[i]) << n << ' ' << i;
+            EXPECT_EQ(opt::kleene_not(a[i]), neg[i]) << n << ' ' << i;
+            unknown += !a[i];
+        }
+        EXPECT_EQ(unknown, va.count_unknown());
+        EXPECT_EQ(va, ~~va);
+
+        // Canonical bitmaps: bits past size() stay zero.
+        if (n % 64 != 0) {
+            EXPECT_EQ(0u, conj.validity()[n / 64] >> (n % 64));
+            EXPECT_EQ(0u, disj.validity()[n / 64] >> (n % 64));
+            EXPECT_EQ(0u, neg.values()[n / 64] >> (n % 64));
+        }
+    }
+}
+
+TEST(OptionalBoolVectorTest, SizeMismatch) {
+    Optional_bool_vector a(3);
+    Optional_bool_vector const b(4);
+    EXPECT_THROW(a &= b, std::invalid_argument);
+    EXPECT_THROW(a | b, std::invalid_argument);
+}
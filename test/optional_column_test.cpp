@@ -0,0 +1,97 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <optional/none.hpp>
+#include <optional/optional_column.hpp>
+
+using opt::Optional;
+using opt::Optional_column;
+
+TEST(OptionalColumnTest, DefaultConstructor) {
+    Optional_column<int> c;
+    EXPECT_TRUE(c.empty());
+    EXPECT_EQ(0u, c.size());
+    EXPECT_EQ(0u, c.count_engaged());
+}
+
+TEST(OptionalColumnTest, SizeConstructor) {
+    Optional_column<int> c(70);
+    EXPECT_EQ(70u, c.size());
+    EXPECT_EQ(2u, c.word_count());
+    EXPECT_EQ(0u, c.count_engaged());
+    EXPECT_FALSE(c[69]);
+}
+
+TEST(OptionalColumnTest, PushBackAndAccess) {
+    Optional_column<std::string> c;
+    c.push_back("a");
+    c.push_back(opt::none);
+    c.push_back(Optional<std::string>{"c"});
+    c.push_back(Optional<std::string>{});
+    ASSERT_EQ(4u, c.size());
+    EXPECT_EQ(2u, c.count_engaged());
+    ASSERT_TRUE(c[0]);
+    EXPECT_EQ("a", *c[0]);
+    EXPECT_FALSE(c[1]);
+    EXPECT_EQ("c", *c[2]);
+    EXPECT_FALSE(c[3]);
+    EXPECT_EQ(0x5u, c.validity()[0]);
+
+    *c[0] = "z";
+    const auto& cc = c;
+    EXPECT_EQ("z", *cc[0]);
+}
+
+TEST(OptionalColumnTest, ConstructFromOptionals) {
+    std::vector<Optional<int>> v;
+    for (int i = 0; i < 130; ++i)
+        v.push_back(Optional<int>{i % 3 == 0, i});
+    Optional_column<int> c(v.begin(), v.end());
+    ASSERT_EQ(130u, c.size());
+    EXPECT_EQ(44u, c.count_engaged());
+    for (int i = 0; i < 130; ++i) {
+        EXPECT_EQ(i % 3 == 0, c.is_engaged(i));
+        if (c[i]) {
+            EXPECT_EQ(i, *c[i]);
+        }
+    }
+}
+
+TEST(OptionalColumnTest, SetAndReset) {
+    Optional_column<int> c{1, opt::none, 3};
+    c.set(1, 2);
+    EXPECT_EQ(3u, c.count_engaged());
+    EXPECT_EQ(2, *c[1]);
+    c.reset(0);
+    EXPECT_FALSE(c[0]);
+    EXPECT_EQ(0, c.data()[0]);
+    EXPECT_EQ(2u, c.count_engaged());
+}
+
+TEST(OptionalColumnTest, ResizeClearsTrailingBits) {
+    Optional_column<int> c;
+    for (int i = 0; i < 100; ++i)
+        c.push_back(i);
+    c.resize(10);
+    EXPECT_EQ(10u, c.count_engaged());
+    EXPECT_EQ((std::uint64_t{1} << 10) - 1, c.validity()[0]);
+    c.resize(80);
+    EXPECT_EQ(10u, c.count_engaged());
+    EXPECT_FALSE(c[50]);
+    c.clear();
+    EXPECT_TRUE(c.empty());
+}
+
+TEST(OptionalColumnTest, MemoryUsageCountsCapacity) {
+    Optional_column<double> c;
+    EXPECT_EQ(0u, c.memory_usage());
+    c.reserve(1000);
+    EXPECT_GE(c.memory_usage(), 1000 * sizeof(double) + 16 * 8);
+    c.push_back(1.0);
+    auto const reserved = c.memory_usage();
+    c.push_back(opt::none);
+    EXPECT_EQ(reserved, c.memory_usage());
+}
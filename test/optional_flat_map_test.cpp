@@ -0,0 +1,130 @@
+#include <cstddef>
+#include <map>
+#include <random>
+#include <string>
+#include <unordered_map>
+
+#include <gtest/gtest.h>
+
+#include <optional/none.hpp>
+#include <optional/optional_flat_map.hpp>
+#include <optional/optional_free_functions.hpp>
+#include <optional/optional_value.hpp>
+
+using opt::Optional;
+using opt::Optional_flat_map;
+
+namespace {
+
+// Sends every key to the same few slots, exercising long probe runs,
+// wrap around and the backward shift on erase.
+struct Poor_hash {
+    auto operator()(int x) const -> std::size_t
+    {
+        return static_cast<std::size_t>(x % 3);
+    }
+};
+
+template <typename Map>
+auto check_against_reference(Map& map, int key_range, unsigned seed) -> void
+{
+    std::mt19937 rng{seed};
+    std::unordered_map<int, int> reference;
+    for (int step = 0; step < 20000; ++step) {
+        int const key = static_cast<int>(rng() % key_range);
+        switch (rng() % 4) {
+            case 0:
+            case 1: {
+                bool const inserted = map.insert(key, step);
+                EXPECT_EQ(reference.emplace(key, step).second, inserted);
+                break;
+            }
+            case 2:
+                EXPECT_EQ(reference.erase(key) == 1, map.erase(key));
+                break;
+            default: {
+                auto const found = map.find(key);
+                auto const it = reference.find(key);
+                ASSERT_EQ(it != reference.end(), bool(found));
+                if (found) {
+                    EXPECT_EQ(it->second, *found);
+                }
+            }
+        }
+        ASSERT_EQ(reference.size(), map.size());
+    }
+    for (auto const& kv : reference) {
+        ASSERT_EQ(Optional<int>{kv.second}, Optional<int>{*map.find(kv.first)});
+    }
+    std::size_t visited = 0;
+    for (auto kv : map) {
+        EXPECT_EQ(reference.at(kv.first), kv.second);
+        ++visited;
+    }
+    EXPECT_EQ(reference.size(), visited);
+}
+
+}  // namespace
+
+TEST(OptionalFlatMapTest, Basics) {
+    Optional_flat_map<std::string, int> m;
+    EXPECT_TRUE(m.empty());
+    EXPECT_EQ(0u, m.capacity());
+    EXPECT_FALSE(m.find("a"));
+
+    EXPECT_TRUE(m.insert("a", 1));
+    EXPECT_FALSE(m.insert("a", 2));
+    EXPECT_EQ(1, *m.find("a"));
+    EXPECT_FALSE(m.insert_or_assign("a", 3));
+    EXPECT_EQ(3, *m.find("a"));
+    EXPECT_TRUE(m.insert_or_assign("b", 4));
+    m["c"] += 5;
+    EXPECT_EQ(5, *m.find("c"));
+    EXPECT_EQ(3u, m.size());
+    EXPECT_TRUE(m.contains("b"));
+
+    *m.find("b") = 40;
+    const auto& cm = m;
+    EXPECT_EQ(40, *cm.find("b"));
+
+    EXPECT_TRUE(m.erase("b"));
+    EXPECT_FALSE(m.erase("b"));
+    EXPECT_FALSE(m.contains("b"));
+    EXPECT_EQ(2u, m.size());
+
+    m.clear();
+    EXPECT_TRUE(m.empty());
+    EXPECT_FALSE(m.find("a"));
+    EXPECT_EQ(16u, m.capacity());
+}
+
+TEST(OptionalFlatMapTest, InitializerListAndReserve) {
+    Optional_flat_map<int, std::string> m{{1, "one"}, {2, "two"}};
+    EXPECT_EQ("two", *m.find(2));
+    m.reserve(1000);
+    EXPECT_GE(m.capacity() - m.capacity() / 8, 1000u);
+    EXPECT_EQ("one", *m.find(1));
+    auto const capacity = m.capacity();
+    for (int i = 0; i < 1000; ++i)
+        m.insert_or_assign(i, std::to_string(i));
+    EXPECT_EQ(capacity, m.capacity());
+}
+
+TEST(OptionalFlatMapTest, RandomOperations) {
+    Optional_flat_map<int, int> m;
+    check_against_reference(m, 3000, 1);
+}
+
+TEST(OptionalFlatMapTest, CollidingHashes) {
+    Optional_flat_map<int, int, Poor_hash> m;
+    check_against_reference(m, 200, 2);
+}
+
+TEST(OptionalFlatMapTest, OptionalKeys) {
+    Optional_flat_map<Optional<int>, std::string> m;
+    m.insert(opt::none, "none");
+    m.insert(0, "zero");
+    EXPECT_EQ("none", *m.find(opt::none));
+    EXPECT_EQ("zero", *m.find(0));
+    EXPECT_FALSE(m.find(1));
+}
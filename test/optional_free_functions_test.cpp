@@ -1,3 +1,7 @@
+#include <limits>
+#include <string>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include <optional/none.hpp>
@@ -280,3 +284,43 @@ TEST(OptionalFreeFunctionTest, Swap) {
     EXPECT_TRUE(bool(opt1));
     EXPECT_EQ(6, opt1.get());
 }
+
+namespace {
+
+enum class Color { red, green, blue };
+
+// Every pairing of the given values, plus the empty optional.
+template <typename T>
+auto check_flag_comparisons(std::vector<T> values) -> void {
+    std::vector<Optional<T>> xs{opt::none};
+    for (const T& v : values) {
+        xs.push_back(v);
+    }
+    for (const auto& x : xs) {
+        for (const auto& y : xs) {
+            const bool eq = (x && y) ? *x == *y : !x && !y;
+            const bool lt = !y ? false : !x ? true : *x < *y;
+            EXPECT_EQ(eq, x == y);
+            EXPECT_EQ(!eq, x != y);
+            EXPECT_EQ(lt, x < y);
+        }
+    }
+}
+
+}  // namespace
+
+TEST(OptionalFreeFunctionTest, BranchlessComparisons) {
+    check_flag_comparisons<int>({-3, 0, 0, 7});
+    check_flag_comparisons<unsigned char>({0, 1, 255});
+    check_flag_comparisons<bool>({false, true});
+    check_flag_comparisons<Color>({Color::red, Color::green, Color::blue});
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    check_flag_comparisons<double>({-0.0, 0.0, 1.5, nan});
+
+    // An empty optional never equals an engaged value initialized payload.
+    EXPECT_FALSE(Optional<int>{} == Optional<int>{0});
+    EXPECT_TRUE(Optional<int>{} < Optional<int>{0});
+    EXPECT_FALSE(Optional<double>{nan} == Optional<double>{nan});
+
+    check_flag_comparisons<std::string>({"", "a", "b"});
+}
@@ -0,0 +1,121 @@
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+#include <gtest/gtest.h>
+
+#include <optional/optional_free_functions.hpp>
+#include <optional/optional_tuple.hpp>
+
+using opt::Optional;
+using opt::Optional_tuple;
+
+namespace {
+
+struct Plain_record {
+    Optional<std::int8_t> a;
+    Optional<double> b;
+    Optional<std::int16_t> c;
+    Optional<std::int32_t> d;
+    Optional<std::int8_t> e;
+    Optional<double> f;
+};
+
+using Packed_record = Optional_tuple<std::int8_t,
+                                     double,
+                                     std::int16_t,
+                                     std::int32_t,
+                                     std::int8_t,
+                                     double>;
+
+constexpr auto round_up(std::size_t n, std::size_t align) -> std::size_t
+{
+    return (n + align - 1) / align * align;
+}
+
+// The fields without padding plus a one byte mask, rounded up to the largest
+// alignment. That is 32 bytes on x86-64, where a struct of Optional members
+// takes 56.
+constexpr std::size_t packed_size =
+    round_up(2 * sizeof(double) + sizeof(std::int32_t) + sizeof(std::int16_t) +
+                 2 * sizeof(std::int8_t) + 1,
+             alignof(double) > alignof(std::int32_t) ? alignof(double)
+                                                     : alignof(std::int32_t));
+
+static_assert(sizeof(Packed_record) == packed_size, "");
+static_assert(sizeof(Packed_record) < sizeof(Plain_record), "");
+static_assert(std::is_trivially_copyable<Packed_record>::value, "");
+static_assert(!std::is_trivially_copyable<Optional_tuple<std::string>>::value,
+              "");
+
+}  // namespace
+
+TEST(OptionalTupleTest, EmplaceGetReset) {
+    Packed_record t;
+    EXPECT_EQ(6u, Packed_record::size());
+    EXPECT_EQ(0u, t.present_count());
+    EXPECT_FALSE(t.get<1>());
+
+    t.emplace<1>(2.5);
+    t.emplace<4>(std::int8_t{-3});
+    EXPECT_TRUE(t.has<1>());
+    EXPECT_FALSE(t.has<0>());
+    EXPECT_EQ(2.5, *t.get<1>());
+    EXPECT_EQ(-3, *opt::get<4>(t));
+    EXPECT_EQ(2u, t.present_count());
+    EXPECT_EQ(0x12u, t.presence());
+
+    *t.get<1>() += 1;
+    const auto& ct = t;
+    EXPECT_EQ(3.5, *ct.get<1>());
+
+    t.emplace<1>(7.0);
+    EXPECT_EQ(7.0, *t.get<1>());
+    t.reset<1>();
+    EXPECT_FALSE(t.get<1>());
+    EXPECT_EQ(1u, t.present_count());
+    t.reset();
+    EXPECT_EQ(0u, t.presence());
+}
+
+TEST(OptionalTupleTest, FieldsDoNotOverlap) {
+    Optional_tuple<char, std::int64_t, std::int16_t, char> t;
+    t.emplace<0>('a');
+    t.emplace<1>(std::int64_t{-1});
+    t.emplace<2>(std::int16_t{0x1234});
+    t.emplace<3>('z');
+    EXPECT_EQ('a', *t.get<0>());
+    EXPECT_EQ(-1, *t.get<1>());
+    EXPECT_EQ(0x1234, *t.get<2>());
+    EXPECT_EQ('z', *t.get<3>());
+    EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(&*t.get<1>()) % 8);
+    EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(&*t.get<2>()) % 2);
+}
+
+TEST(OptionalTupleTest, CopyAndMoveNonTrivialFields) {
+    Optional_tuple<std::string, int, std::unique_ptr<int>> t;
+    t.emplace<0>("hello");
+    t.emplace<2>(new int{4});
+
+    auto moved = std::move(t);
+    EXPECT_EQ("hello", *moved.get<0>());
+    EXPECT_FALSE(moved.get<1>());
+    EXPECT_EQ(4, **moved.get<2>());
+
+    Optional_tuple<std::string, int> a;
+    a.emplace<0>("x");
+    a.emplace<1>(1);
+    Optional_tuple<std::string, int> b;
+    b.emplace<0>("y");
+    b = a;
+    EXPECT_EQ("x", *b.get<0>());
+    EXPECT_EQ(1, *b.get<1>());
+    a.reset<1>();
+    b = a;
+    EXPECT_FALSE(b.get<1>());
+    auto c = b;
+    EXPECT_EQ("x", *c.get<0>());
+    EXPECT_EQ(1u, c.present_count());
+}
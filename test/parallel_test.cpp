@@ -0,0 +1,158 @@
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <optional/none.hpp>
+#include <optional/optional_value.hpp>
+#include <optional/parallel.hpp>
+
+using opt::Optional;
+namespace par = opt::par;
+
+namespace {
+
+auto make_data(std::size_t n) -> std::vector<Optional<std::int64_t>>
+{
+    std::vector<Optional<std::int64_t>> v(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        if (i % 3 != 0)
+            v[i] = static_cast<std::int64_t>(i);
+    }
+    return v;
+}
+
+}  // namespace
+
+TEST(ParallelTest, ThreadPoolRunsEveryTask) {
+    par::Thread_pool pool{3};
+    EXPECT_EQ(4u, pool.concurrency());
+    std::vector<int> hits(10000, 0);
+    pool.run(hits.size(), [&](std::size_t i) { ++hits[i]; });
+    for (auto h : hits)
+        EXPECT_EQ(1, h);
+    pool.run(0, [&](std::size_t) { FAIL(); });
+    pool.run(7, [&](std::size_t i) { ++hits[i]; });
+    EXPECT_EQ(2, hits[6]);
+    EXPECT_EQ(1, hits[7]);
+}
+
+TEST(ParallelTest, ThreadPoolWithoutWorkers) {
+    par::Thread_pool pool{0};
+    EXPECT_EQ(1u, pool.concurrency());
+    int sum = 0;
+    pool.run(5, [&](std::size_t i) { sum += static_cast<int>(i); });
+    EXPECT_EQ(10, sum);
+}
+
+TEST(ParallelTest, ThreadPoolRethrows) {
+    par::Thread_pool pool{2};
+    EXPECT_THROW(pool.run(100,
+                          [](std::size_t i) {
+                              if (i == 42)
+                                  throw std::runtime_error{"42"};
+                          }),
+                 std::runtime_error);
+    std::size_t count = 0;
+    std::mutex mtx;
+    pool.run(100, [&](std::size_t) {
+        std::lock_guard<std::mutex> lock{mtx};
+        ++count;
+    });
+    EXPECT_EQ(100u, count);
+}
+
+TEST(ParallelTest, ThreadPoolNestedRun) {
+    par::Thread_pool pool{2};
+    std::vector<int> hits(64 * 64, 0);
+    pool.run(64, [&](std::size_t i) {
+        pool.run(64, [&](std::size_t j) { ++hits[i * 64 + j]; });
+    });
+    for (auto h : hits)
+        EXPECT_EQ(1, h);
+
+    std::vector<Optional<std::int64_t>> v(100000, std::int64_t{1});
+    std::vector<std::int64_t> sums(8);
+    pool.run(sums.size(), [&](std::size_t i) {
+        sums[i] = par::reduce_engaged(pool, v.begin(), v.end(), std::int64_t{0},
+                                      std::plus<std::int64_t>{});
+    });
+    for (auto sum : sums)
+        EXPECT_EQ(100000, sum);
+}
+
+TEST(ParallelTest, ThreadPoolConstFunctor) {
+    par::Thread_pool pool{2};
+    std::vector<int> hits(100, 0);
+    auto const f = [&hits](std::size_t i) { ++hits[i]; };
+    pool.run(hits.size(), f);
+    for (auto h : hits)
+        EXPECT_EQ(1, h);
+}
+
+TEST(ParallelTest, ReduceEngaged) {
+    par::Thread_pool pool{3};
+    auto const v = make_data(100003);
+    std::int64_t expected = 0;
+    for (auto const& x : v) {
+        if (x)
+            expected += *x;
+    }
+    EXPECT_EQ(expected, par::reduce_engaged(pool, v.begin(), v.end(),
+                                            std::int64_t{0}, std::plus<>{}));
+    auto const max = par::reduce_engaged(
+        pool, v.begin(), v.end(), std::int64_t{-1},
+        [](std::int64_t a, std::int64_t b) { return a < b ? b : a; });
+    EXPECT_EQ(100001, max);
+}
+
+TEST(ParallelTest, ReduceEmptyAndAllEmpty) {
+    std::vector<Optional<double>> v;
+    EXPECT_EQ(1.5, par::reduce_engaged(v.begin(), v.end(), 1.5, std::plus<>{}));
+    v.resize(50000);
+    EXPECT_EQ(1.5, par::reduce_engaged(v.begin(), v.end(), 1.5, std::plus<>{}));
+}
+
+TEST(ParallelTest, CountEngaged) {
+    par::Thread_pool pool{3};
+    auto const v = make_data(100000);
+    EXPECT_EQ(66666u, par::count_engaged(pool, v.begin(), v.end()));
+    EXPECT_EQ(66666u, par::count_engaged(v.begin(), v.end()));
+}
+
+TEST(ParallelTest, TransformEngaged) {
+    par::Thread_pool pool{3};
+    auto const v = make_data(50000);
+    std::vector<Optional<std::string>> out(v.size());
+    auto const end = par::transform_engaged(
+        pool, v.begin(), v.end(), out.begin(),
+        [](std::int64_t x) { return std::to_string(x); });
+    EXPECT_EQ(out.end(), end);
+    for (std::size_t i = 0; i < v.size(); ++i) {
+        ASSERT_EQ(bool(v[i]), bool(out[i]));
+        if (v[i]) {
+            EXPECT_EQ(std::to_string(*v[i]), *out[i]);
+        }
+    }
+}
+
+TEST(ParallelTest, PartitionEngagedIsStable) {
+    par::Thread_pool pool{3};
+    auto v = make_data(70001);
+    auto const mid = par::partition_engaged(pool, v.begin(), v.end());
+    ASSERT_EQ(46667, mid - v.begin());
+    std::int64_t previous = -1;
+    for (auto it = v.begin(); it != mid; ++it) {
+        ASSERT_TRUE(*it);
+        EXPECT_LT(previous, **it);
+        EXPECT_NE(0, **it % 3);
+        previous = **it;
+    }
+    for (auto it = mid; it != v.end(); ++it)
+        EXPECT_FALSE(*it);
+}
@@ -0,0 +1,131 @@
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <optional/optional_column.hpp>
+#include <optional/optional_free_functions.hpp>
+#include <optional/optional_value.hpp>
+#include <optional/parse.hpp>
+
+using opt::Optional;
+
+namespace {
+
+enum class Color { red, green, blue };
+
+}  // namespace
+
+template <>
+struct opt::Enum_names<Color> {
+    static auto values() -> std::array<opt::Enum_name<Color>, 3>
+    {
+        return {{{"red", Color::red},
+                 {"green", Color::green},
+                 {"blue", Color::blue}}};
+    }
+};
+
+TEST(ParseTest, Integers) {
+    EXPECT_EQ(Optional<int>{42}, opt::parse<int>("42"));
+    EXPECT_EQ(Optional<int>{-42}, opt::parse<int>("-42"));
+    EXPECT_EQ(Optional<int>{7}, opt::parse<int>("+7"));
+    EXPECT_EQ(Optional<int>{0}, opt::parse<int>("-0"));
+    EXPECT_FALSE(opt::parse<int>(""));
+    EXPECT_FALSE(opt::parse<int>("-"));
+    EXPECT_FALSE(opt::parse<int>(" 1"));
+    EXPECT_FALSE(opt::parse<int>("1 "));
+    EXPECT_FALSE(opt::parse<int>("1.0"));
+    EXPECT_FALSE(opt::parse<int>("0x10"));
+
+    EXPECT_EQ(Optional<int>{std::numeric_limits<int>::max()},
+              opt::parse<int>("2147483647"));
+    EXPECT_EQ(Optional<int>{std::numeric_limits<int>::min()},
+              opt::parse<int>("-2147483648"));
+    EXPECT_FALSE(opt::parse<int>("2147483648"));
+    EXPECT_FALSE(opt::parse<int>("-2147483649"));
+
+    EXPECT_EQ(Optional<std::uint8_t>{255}, opt::parse<std::uint8_t>("255"));
+    EXPECT_FALSE(opt::parse<std::uint8_t>("256"));
+    EXPECT_FALSE(opt::parse<std::uint8_t>("-1"));
+    EXPECT_EQ(Optional<std::int8_t>{-128}, opt::parse<std::int8_t>("-128"));
+    EXPECT_EQ(Optional<std::uint64_t>{18446744073709551615u},
+              opt::parse<std::uint64_t>("18446744073709551615"));
+    EXPECT_FALSE(opt::parse<std::uint64_t>("18446744073709551616"));
+    EXPECT_EQ(Optional<long long>{std::numeric_limits<long long>::min()},
+              opt::parse<long long>(std::string{"-9223372036854775808"}));
+}
+
+TEST(ParseTest, Floating) {
+    EXPECT_EQ(Optional<double>{1.5}, opt::parse<double>("1.5"));
+    EXPECT_EQ(Optional<double>{-0.25}, opt::parse<double>("-0.25"));
+    EXPECT_EQ(Optional<double>{0.1}, opt::parse<double>("0.1"));
+    EXPECT_EQ(Optional<double>{1e300}, opt::parse<double>("1e300"));
+    EXPECT_EQ(Optional<double>{1.5e-7}, opt::parse<double>("+15E-8"));
+    EXPECT_EQ(Optional<double>{0.5}, opt::parse<double>(".5"));
+    EXPECT_EQ(Optional<double>{3.0}, opt::parse<double>("3"));
+    EXPECT_EQ(Optional<double>{123456789012345678901234567890.0},
+              opt::parse<double>("123456789012345678901234567890"));
+    EXPECT_EQ(Optional<double>{0.000123},
+              opt::parse<double>("0.000123000000000000000000000"));
+    EXPECT_EQ(Optional<float>{0.1f}, opt::parse<float>("0.1"));
+    EXPECT_EQ(Optional<float>{3.4e38f}, opt::parse<float>("3.4e38"));
+
+    EXPECT_TRUE(std::isinf(*opt::parse<double>("inf")));
+    EXPECT_TRUE(std::isnan(*opt::parse<double>("nan")));
+
+    EXPECT_FALSE(opt::parse<double>(""));
+    EXPECT_FALSE(opt::parse<double>("."));
+    EXPECT_FALSE(opt::parse<double>("e5"));
+    EXPECT_FALSE(opt::parse<double>("1.5e"));
+    EXPECT_FALSE(opt::parse<double>("1.5x"));
+    EXPECT_FALSE(opt::parse<double>(" 1.5"));
+    EXPECT_FALSE(opt::parse<double>("1e400"));
+    EXPECT_FALSE(opt::parse<float>("1e39"));
+    EXPECT_FALSE(opt::parse<double>("0x1p3"));
+    EXPECT_FALSE(opt::parse<double>("1..5"));
+    EXPECT_FALSE(opt::parse<double>("+-1.5"));
+    EXPECT_FALSE(opt::parse<double>("++1"));
+    EXPECT_FALSE(opt::parse<double>("-+1"));
+    EXPECT_FALSE(opt::parse<float>("+-0"));
+}
+
+TEST(ParseTest, BoolsAndEnums) {
+    EXPECT_EQ(Optional<bool>{true}, opt::parse<bool>("true"));
+    EXPECT_EQ(Optional<bool>{true}, opt::parse<bool>("1"));
+    EXPECT_EQ(Optional<bool>{false}, opt::parse<bool>("false"));
+    EXPECT_EQ(Optional<bool>{false}, opt::parse<bool>("0"));
+    EXPECT_FALSE(opt::parse<bool>("True"));
+    EXPECT_FALSE(opt::parse<bool>("2"));
+
+    EXPECT_EQ(Optional<Color>{Color::green}, opt::parse<Color>("green"));
+    EXPECT_EQ(Optional<Color>{Color::blue}, opt::parse<Color>("blue"));
+    EXPECT_FALSE(opt::parse<Color>("gree"));
+    EXPECT_FALSE(opt::parse<Color>("greens"));
+}
+
+TEST(ParseTest, Column) {
+    auto const c = opt::parse_column<int>("1,,x,-4,", ',');
+    ASSERT_EQ(5u, c.size());
+    EXPECT_EQ(1, *c[0]);
+    EXPECT_FALSE(c[1]);
+    EXPECT_FALSE(c[2]);
+    EXPECT_EQ(-4, *c[3]);
+    EXPECT_FALSE(c[4]);
+    EXPECT_EQ(2u, c.count_engaged());
+
+    EXPECT_EQ(0u, opt::parse_column<int>("", ',').size());
+    EXPECT_EQ(1u, opt::parse_column<int>(",", '\n').size());
+
+    std::string text;
+    for (int i = 0; i < 200; ++i)
+        text += std::to_string(i * 0.5) + '\n';
+    text.pop_back();
+    auto const d = opt::parse_column<double>(text, '\n');
+    ASSERT_EQ(200u, d.size());
+    EXPECT_EQ(200u, d.count_engaged());
+    EXPECT_EQ(99.5, *d[199]);
+}
@@ -0,0 +1,129 @@
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <optional/pull.hpp>
+
+namespace pull = opt::pull;
+
+namespace {
+
+template <typename Source>
+auto drain(Source& source)
+    -> std::vector<std::decay_t<typename Source::Value_type>>
+{
+    std::vector<std::decay_t<typename Source::Value_type>> result;
+    while (auto x = source.next())
+        result.push_back(*x);
+    return result;
+}
+
+// Source producing 0, 1, ..., n - 1, then optionally throwing.
+class Counter {
+   public:
+    using Value_type = const int;
+
+    Counter(int n, bool throw_at_end = false)
+        : n_{n}, throw_at_end_{throw_at_end}
+    {}
+
+    auto next() -> opt::Optional<const int&>
+    {
+        if (i_ == n_) {
+            if (throw_at_end_)
+                throw std::runtime_error{"end"};
+            return opt::none;
+        }
+        current_ = i_++;
+        return current_;
+    }
+
+   private:
+    int n_;
+    bool throw_at_end_;
+    int i_{0};
+    int current_{0};
+};
+
+}  // namespace
+
+TEST(PullTest, RangeSourceYieldsReferences) {
+    std::vector<int> v{1, 2, 3};
+    auto source = pull::from(v);
+    auto first = source.next();
+    ASSERT_TRUE(first);
+    EXPECT_EQ(&v[0], &*first);
+    *first = 10;
+    EXPECT_EQ(10, v[0]);
+    EXPECT_TRUE(source.next());
+    EXPECT_TRUE(source.next());
+    EXPECT_FALSE(source.next());
+    EXPECT_FALSE(source.next());
+}
+
+TEST(PullTest, EmptyRange) {
+    std::vector<int> v;
+    auto source = pull::from(v);
+    EXPECT_FALSE(source.next());
+}
+
+TEST(PullTest, MapFilterTake) {
+    std::vector<int> v{1, 2, 3, 4, 5, 6, 7, 8};
+    auto p = pull::from(v) | pull::filter([](int x) { return x % 2 == 0; }) |
+             pull::map([](int x) { return std::to_string(x * x); }) |
+             pull::take(3);
+    EXPECT_EQ((std::vector<std::string>{"4", "16", "36"}), drain(p));
+}
+
+TEST(PullTest, TakeMoreThanAvailable) {
+    auto p = Counter{3} | pull::take(10);
+    EXPECT_EQ((std::vector<int>{0, 1, 2}), drain(p));
+    auto q = Counter{3} | pull::take(0);
+    EXPECT_TRUE(drain(q).empty());
+}
+
+TEST(PullTest, Chunk) {
+    auto p = Counter{7} | pull::chunk(3);
+    auto const chunks = drain(p);
+    ASSERT_EQ(3u, chunks.size());
+    EXPECT_EQ((std::vector<int>{0, 1, 2}), chunks[0]);
+    EXPECT_EQ((std::vector<int>{3, 4, 5}), chunks[1]);
+    EXPECT_EQ((std::vector<int>{6}), chunks[2]);
+}
+
+TEST(PullTest, Handoff) {
+    auto p = Counter{10000} | pull::map([](int x) { return x * 2; }) |
+             pull::handoff(16) | pull::filter([](int x) { return x % 3 == 0; });
+    auto const result = drain(p);
+    ASSERT_EQ(3334u, result.size());
+    for (std::size_t i = 0; i < result.size(); ++i)
+        EXPECT_EQ(static_cast<int>(i * 6), result[i]);
+}
+
+TEST(PullTest, HandoffStoppedEarly) {
+    auto p = Counter{1000000} | pull::handoff(4) | pull::take(3);
+    EXPECT_EQ((std::vector<int>{0, 1, 2}), drain(p));
+}
+
+TEST(PullTest, HandoffPropagatesExceptions) {
+    auto p = Counter{5, true} | pull::handoff(2);
+    for (int i = 0; i < 5; ++i)
+        EXPECT_TRUE(p.next());
+    EXPECT_THROW(p.next(), std::runtime_error);
+}
+
+TEST(PullTest, HandoffQueue) {
+    pull::Handoff_queue<int> q{2};
+    EXPECT_TRUE(q.push(1));
+    EXPECT_TRUE(q.push(2));
+    q.close();
+    EXPECT_EQ(1, *q.pop());
+    EXPECT_EQ(2, *q.pop());
+    EXPECT_FALSE(q.pop());
+    EXPECT_FALSE(q.pop());
+    q.cancel();
+    EXPECT_FALSE(q.push(3));
+}
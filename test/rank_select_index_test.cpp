@@ -0,0 +1,80 @@
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <optional/none.hpp>
+#include <optional/optional_column.hpp>
+#include <optional/optional_free_functions.hpp>
+#include <optional/rank_select_index.hpp>
+
+using opt::Optional;
+using opt::Rank_select_index;
+
+namespace {
+
+auto expect_consistent(const Rank_select_index& index,
+                       const std::vector<bool>& bits) -> void
+{
+    ASSERT_EQ(bits.size(), index.size());
+    std::size_t rank = 0;
+    for (std::size_t i = 0; i < bits.size(); ++i) {
+        ASSERT_EQ(rank, index.rank(i)) << i;
+        ASSERT_EQ(bits[i], index.is_engaged(i)) << i;
+        if (bits[i]) {
+            ASSERT_EQ(i, index.select(rank)) << rank;
+            ASSERT_EQ(Optional<std::size_t>{rank}, index.dense_index_of(i));
+            ++rank;
+        }
+        else {
+            ASSERT_FALSE(index.dense_index_of(i));
+        }
+    }
+    EXPECT_EQ(rank, index.rank(bits.size()));
+    EXPECT_EQ(rank, index.count_engaged());
+}
+
+}  // namespace
+
+TEST(RankSelectIndexTest, Empty) {
+    Rank_select_index const index;
+    EXPECT_EQ(0u, index.size());
+    EXPECT_EQ(0u, index.count_engaged());
+    EXPECT_EQ(0u, index.rank(0));
+}
+
+TEST(RankSelectIndexTest, FromOptionals) {
+    std::vector<Optional<int>> const xs{1, opt::none, 3, opt::none, opt::none, 6};
+    Rank_select_index const index(xs.begin(), xs.end());
+    expect_consistent(index, {true, false, true, false, false, true});
+    EXPECT_EQ(5u, index.select(2));
+    EXPECT_EQ(Optional<std::size_t>{1}, index.dense_index_of(2));
+}
+
+TEST(RankSelectIndexTest, Densities) {
+    std::mt19937 rng{46};
+    // Sizes cross word, block and superblock boundaries and select samples.
+    for (auto const per_mille : {0u, 3u, 100u, 500u, 999u, 1000u}) {
+        std::vector<bool> bits(150000 + rng() % 64);
+        std::vector<Optional<char>> xs;
+        for (std::size_t i = 0; i < bits.size(); ++i) {
+            bits[i] = rng() % 1000 < per_mille;
+            xs.push_back(bits[i] ? Optional<char>{'x'} : opt::none);
+        }
+        opt::Optional_column<char> const column(xs.begin(), xs.end());
+        Rank_select_index const from_bitmap(column.validity(), column.size());
+        expect_consistent(from_bitmap, bits);
+        Rank_select_index const from_optionals(xs.begin(), xs.end());
+        expect_consistent(from_optionals, bits);
+    }
+}
+
+TEST(RankSelectIndexTest, Overhead) {
+    std::vector<std::uint64_t> words(1 << 16, ~std::uint64_t{0});
+    Rank_select_index const index(words.data(), words.size() * 64);
+    auto const bitmap_bytes = words.size() * sizeof(std::uint64_t);
+    // Dense bitmaps have the most select samples.
+    EXPECT_LT(index.directory_bytes(), bitmap_bytes * 4 / 100);
+}
@@ -0,0 +1,110 @@
+#include <cstddef>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <optional/none.hpp>
+#include <optional/optional_free_functions.hpp>
+#include <optional/rle_optional_column.hpp>
+
+using opt::Optional;
+using opt::Rle_optional_column;
+
+TEST(RleOptionalColumnTest, RunsMerge) {
+    Rle_optional_column<int> c{1, 1, opt::none, opt::none, opt::none, 2, 1};
+    EXPECT_EQ(7u, c.size());
+    EXPECT_EQ(4u, c.run_count());
+    EXPECT_EQ(4u, c.count_engaged());
+
+    auto const r = c.run(1);
+    EXPECT_EQ(2u, r.first);
+    EXPECT_EQ(3u, r.length);
+    EXPECT_FALSE(r.value);
+    EXPECT_EQ(1, *c.run(0).value);
+
+    EXPECT_EQ(1, *c[1]);
+    EXPECT_FALSE(c[2]);
+    EXPECT_FALSE(c[4]);
+    EXPECT_EQ(2, *c[5]);
+    EXPECT_EQ(1, *c[6]);
+    EXPECT_EQ(2u, c.run_of(5));
+
+    c.append(1, 10);
+    c.append(opt::none, 0);
+    c.append(Optional<int>{}, 5);
+    c.push_back(opt::none);
+    EXPECT_EQ(23u, c.size());
+    EXPECT_EQ(5u, c.run_count());
+    EXPECT_EQ(14u, c.count_engaged());
+
+    c.clear();
+    EXPECT_TRUE(c.empty());
+    EXPECT_EQ(0u, c.run_count());
+}
+
+TEST(RleOptionalColumnTest, IterationAndDecoding) {
+    std::mt19937 rng{5};
+    std::vector<Optional<std::string>> expected;
+    Rle_optional_column<std::string> c;
+    for (int run = 0; run < 200; ++run) {
+        auto const length = 1 + rng() % 150;
+        Optional<std::string> const value{rng() % 3 != 0,
+                                          std::to_string(rng() % 4)};
+        for (std::size_t i = 0; i < length; ++i)
+            expected.push_back(value);
+        c.append(value, length);
+    }
+    ASSERT_EQ(expected.size(), c.size());
+
+    std::size_t i = 0;
+    for (Optional<const std::string&> x : c) {
+        ASSERT_EQ(bool(expected[i]), bool(x)) << i;
+        if (x) {
+            EXPECT_EQ(*expected[i], *x);
+        }
+        ++i;
+    }
+    EXPECT_EQ(expected.size(), i);
+
+    auto const column = c.to_column();
+    ASSERT_EQ(expected.size(), column.size());
+    EXPECT_EQ(c.count_engaged(), column.count_engaged());
+    for (i = 0; i < expected.size(); i += 7) {
+        ASSERT_EQ(bool(expected[i]), bool(column[i]));
+        ASSERT_EQ(bool(expected[i]), bool(c[i]));
+        if (expected[i]) {
+            EXPECT_EQ(*expected[i], *column[i]);
+            EXPECT_EQ(*expected[i], *c[i]);
+        }
+    }
+}
+
+TEST(RleOptionalColumnTest, Reductions) {
+    Rle_optional_column<long> c;
+    c.append(3, 1000);
+    c.append(opt::none, 5000);
+    c.append(-1, 10);
+    EXPECT_EQ(2990, opt::sum(c));
+    EXPECT_EQ(3000, opt::sum(c, 10L));
+    auto const longest = opt::reduce_runs(
+        c, std::size_t{0}, [](std::size_t acc, long, std::size_t length) {
+            return length > acc ? length : acc;
+        });
+    EXPECT_EQ(1000u, longest);
+}
+
+TEST(RleOptionalColumnTest, Compression) {
+    // Sensor style data: readings that hold steady for a while, with gaps.
+    std::mt19937 rng{6};
+    Rle_optional_column<double> c;
+    while (c.size() < 1000000) {
+        if (rng() % 4 == 0)
+            c.append(opt::none, 200 + rng() % 2000);
+        else
+            c.append(static_cast<double>(rng() % 100), 100 + rng() % 1000);
+    }
+    auto const dense_bytes = c.size() * sizeof(double) + c.size() / 8;
+    EXPECT_GT(dense_bytes, 20 * c.memory_usage());
+}
@@ -0,0 +1,100 @@
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <optional/optional_free_functions.hpp>
+#include <optional/slot_map.hpp>
+
+using opt::Slot_handle;
+using opt::Slot_map;
+
+TEST(SlotMapTest, InsertGetErase) {
+    Slot_map<std::string> m;
+    EXPECT_TRUE(m.empty());
+    EXPECT_FALSE(m.get(Slot_handle{}));
+
+    auto const a = m.insert("a");
+    auto const b = m.emplace(3, 'b');
+    EXPECT_EQ(2u, m.size());
+    EXPECT_EQ("a", *m.get(a));
+    EXPECT_EQ("bbb", *m.get(b));
+    *m.get(a) += "!";
+    const auto& cm = m;
+    EXPECT_EQ("a!", *cm.get(a));
+
+    EXPECT_TRUE(m.erase(a));
+    EXPECT_FALSE(m.erase(a));
+    EXPECT_FALSE(m.contains(a));
+    EXPECT_FALSE(m.get(a));
+    EXPECT_EQ("bbb", *m.get(b));
+    EXPECT_EQ(1u, m.size());
+}
+
+TEST(SlotMapTest, ReusedSlotRejectsStaleHandle) {
+    Slot_map<int> m;
+    auto const a = m.insert(1);
+    m.erase(a);
+    auto const b = m.insert(2);
+    EXPECT_EQ(a.index, b.index);
+    EXPECT_NE(a, b);
+    EXPECT_FALSE(m.get(a));
+    EXPECT_EQ(2, *m.get(b));
+}
+
+TEST(SlotMapTest, DenseIteration) {
+    Slot_map<int> m;
+    std::vector<Slot_handle> handles;
+    for (int i = 0; i < 10; ++i)
+        handles.push_back(m.insert(i));
+    m.erase(handles[0]);
+    m.erase(handles[5]);
+
+    int sum = 0;
+    for (int x : m)
+        sum += x;
+    EXPECT_EQ(45 - 5, sum);
+    EXPECT_EQ(m.size(), static_cast<std::size_t>(m.end() - m.begin()));
+    for (std::size_t i = 0; i < m.size(); ++i)
+        EXPECT_EQ(&m.data()[i], &*m.get(m.handle_at(i)));
+
+    m.clear();
+    EXPECT_TRUE(m.empty());
+    EXPECT_FALSE(m.get(handles[1]));
+}
+
+TEST(SlotMapTest, MoveOnlyElements) {
+    Slot_map<std::unique_ptr<int>> m;
+    auto const a = m.insert(std::make_unique<int>(1));
+    auto const b = m.insert(std::make_unique<int>(2));
+    m.erase(a);
+    EXPECT_EQ(2, **m.get(b));
+}
+
+TEST(SlotMapTest, RandomOperations) {
+    std::mt19937 rng{3};
+    Slot_map<int> m;
+    std::vector<std::pair<Slot_handle, int>> live;
+    std::vector<Slot_handle> dead;
+    for (int step = 0; step < 20000; ++step) {
+        if (live.empty() || rng() % 3 != 0) {
+            live.push_back({m.insert(step), step});
+        }
+        else {
+            auto const i = rng() % live.size();
+            EXPECT_TRUE(m.erase(live[i].first));
+            dead.push_back(live[i].first);
+            live[i] = live.back();
+            live.pop_back();
+        }
+    }
+    ASSERT_EQ(live.size(), m.size());
+    for (auto const& entry : live)
+        EXPECT_EQ(entry.second, *m.get(entry.first));
+    for (auto const& h : dead)
+        EXPECT_FALSE(m.get(h));
+}
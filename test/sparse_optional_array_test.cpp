@@ -0,0 +1,139 @@
+#include <cstddef>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <optional/optional_free_functions.hpp>
+#include <optional/sparse_optional_array.hpp>
+
+using opt::Optional;
+using opt::Sparse_optional_array;
+
+namespace {
+
+template <typename T>
+auto expect_matches(const Sparse_optional_array<T>& a,
+                    const std::map<std::size_t, T>& expected) -> void
+{
+    ASSERT_EQ(expected.size(), a.count());
+    auto it = expected.begin();
+    for (auto entry : a) {
+        ASSERT_NE(expected.end(), it);
+        EXPECT_EQ(it->first, entry.first);
+        EXPECT_EQ(it->second, entry.second);
+        ++it;
+    }
+    EXPECT_EQ(expected.end(), it);
+    for (auto const& kv : expected)
+        EXPECT_EQ(Optional<T>{kv.second}, Optional<T>{*a[kv.first]});
+}
+
+}  // namespace
+
+TEST(SparseOptionalArrayTest, SetGetReset) {
+    Sparse_optional_array<std::string> a;
+    EXPECT_TRUE(a.empty());
+    EXPECT_FALSE(a[0]);
+
+    a.set(1000000000, "far");
+    a.set(5, "near");
+    a.set(5, "near!");
+    EXPECT_EQ(2u, a.count());
+    EXPECT_EQ("far", *a[1000000000]);
+    EXPECT_EQ("near!", *a[5]);
+    EXPECT_FALSE(a[6]);
+    EXPECT_FALSE(a[1000000000 + 65536]);
+    EXPECT_TRUE(a.contains(5));
+
+    *a[5] += "?";
+    const auto& ca = a;
+    EXPECT_EQ("near!?", *ca[5]);
+
+    a.reset(5);
+    a.reset(7);
+    EXPECT_FALSE(a.contains(5));
+    EXPECT_EQ(1u, a.count());
+    a.clear();
+    EXPECT_TRUE(a.empty());
+}
+
+TEST(SparseOptionalArrayTest, DenseChunksConvertBothWays) {
+    Sparse_optional_array<int> a;
+    std::map<std::size_t, int> expected;
+    for (int i = 0; i < 6000; ++i) {
+        std::size_t const index = 3 * 65536 + static_cast<std::size_t>(i) * 7 % 65536;
+        a.set(index, i);
+        expected[index] = i;
+    }
+    expect_matches(a, expected);
+    auto const dense_bytes = a.memory_usage();
+
+    for (int i = 0; i < 5000; ++i) {
+        std::size_t const index = 3 * 65536 + static_cast<std::size_t>(i) * 7 % 65536;
+        a.reset(index);
+        expected.erase(index);
+    }
+    expect_matches(a, expected);
+    EXPECT_LT(a.memory_usage(), dense_bytes);
+}
+
+TEST(SparseOptionalArrayTest, RandomOperations) {
+    std::mt19937_64 rng{4};
+    Sparse_optional_array<long> a;
+    std::map<std::size_t, long> expected;
+    for (int step = 0; step < 30000; ++step) {
+        // A few hot chunks, so some of them become dense.
+        std::size_t const index = (rng() % 4) * 1000003 + rng() % 20000;
+        if (rng() % 3 == 0) {
+            a.reset(index);
+            expected.erase(index);
+        }
+        else {
+            a.set(index, step);
+            expected[index] = step;
+        }
+    }
+    expect_matches(a, expected);
+}
+
+TEST(SparseOptionalArrayTest, UnionAndIntersection) {
+    Sparse_optional_array<int> a;
+    Sparse_optional_array<int> b;
+    std::map<std::size_t, int> both;
+    std::map<std::size_t, int> either;
+    for (std::size_t i = 0; i < 150000; i += 3) {
+        a.set(i, 1);
+        either[i] = 1;
+    }
+    for (std::size_t i = 0; i < 300000; i += 5) {
+        b.set(i, 2);
+        if (i % 3 == 0 && i < 150000)
+            both[i] = 1;
+        else
+            either[i] = 2;
+    }
+    b.set(10000000, 2);
+    either[10000000] = 2;
+
+    expect_matches(opt::set_union(a, b), either);
+    expect_matches(opt::set_intersection(a, b), both);
+
+    Sparse_optional_array<std::string> mask;
+    mask.set(3, "x");
+    mask.set(149997, "y");
+    a.intersect(mask);
+    expect_matches(a, std::map<std::size_t, int>{{3, 1}, {149997, 1}});
+}
+
+TEST(SparseOptionalArrayTest, MemoryAtLowFill) {
+    // 1000 engaged elements spread over 10^9 indices.
+    Sparse_optional_array<double> a;
+    for (std::size_t i = 0; i < 1000; ++i)
+        a.set(i * 999983, 1.0);
+    EXPECT_EQ(1000u, a.count());
+    // A dense bitmap alone would need 125 MB.
+    EXPECT_LT(a.memory_usage(), 200000u);
+}
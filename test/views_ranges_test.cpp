@@ -0,0 +1,47 @@
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <optional/none.hpp>
+#include <optional/optional_column.hpp>
+#include <optional/optional_value.hpp>
+#include <optional/views.hpp>
+
+#if defined(__cpp_lib_ranges)
+#include <algorithm>
+#include <ranges>
+
+using opt::Optional;
+
+TEST(ViewsRangesTest, ModelsRangesConcepts) {
+    using Engaged =
+        decltype(std::declval<std::vector<Optional<int>>&>() |
+                 opt::views::engaged);
+    static_assert(std::ranges::view<Engaged>);
+    static_assert(std::ranges::forward_range<Engaged>);
+    static_assert(std::ranges::borrowed_range<Engaged>);
+
+    using Bitmap = decltype(std::declval<opt::Optional_column<int>&>() |
+                            opt::views::values_or(0));
+    static_assert(std::ranges::view<Bitmap>);
+    static_assert(std::ranges::input_range<Bitmap>);
+
+    using Flat = decltype(std::declval<opt::Optional_column<int>&>() |
+                          opt::views::flatten);
+    static_assert(std::ranges::view<Flat>);
+    static_assert(std::ranges::input_range<Flat>);
+}
+
+TEST(ViewsRangesTest, ComposesWithStdViews) {
+    std::vector<Optional<int>> v{1, opt::none, 3, opt::none, 5, 6};
+    std::vector<int> result;
+    for (int i : v | opt::views::engaged |
+                     std::views::filter([](int i) { return i % 2 == 1; }) |
+                     std::views::take(2))
+        result.push_back(i);
+    EXPECT_EQ((std::vector<int>{1, 3}), result);
+
+    opt::Optional_column<int> c{opt::none, 2, opt::none, 4};
+    EXPECT_EQ(2, std::ranges::count(c | opt::views::values_or(0), 0));
+}
+#endif  // defined(__cpp_lib_ranges)
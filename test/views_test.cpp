@@ -0,0 +1,142 @@
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <optional/none.hpp>
+#include <optional/optional_column.hpp>
+#include <optional/optional_reference.hpp>
+#include <optional/optional_value.hpp>
+#include <optional/views.hpp>
+
+using opt::Optional;
+namespace views = opt::views;
+
+namespace {
+
+template <typename Range>
+auto collect(const Range& r)
+{
+    std::vector<std::decay_t<decltype(*r.begin())>> result;
+    for (auto&& x : r)
+        result.push_back(x);
+    return result;
+}
+
+auto make_column(std::size_t n) -> opt::Optional_column<int>
+{
+    // Engaged at multiples of 7 and in [200, 210), long empty runs otherwise.
+    opt::Optional_column<int> c;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (i % 7 == 0 || (i >= 200 && i < 210))
+            c.push_back(static_cast<int>(i));
+        else
+            c.push_back(opt::none);
+    }
+    return c;
+}
+
+}  // namespace
+
+TEST(ViewsTest, EngagedVector) {
+    std::vector<Optional<int>> v{1, opt::none, 3, opt::none, opt::none, 6};
+    EXPECT_EQ((std::vector<int>{1, 3, 6}), collect(v | views::engaged));
+
+    for (int& i : views::engaged(v))
+        i *= 10;
+    EXPECT_EQ(30, *v[2]);
+
+    const auto& cv = v;
+    EXPECT_EQ((std::vector<int>{10, 30, 60}), collect(cv | views::engaged));
+}
+
+TEST(ViewsTest, EngagedEmptyAndAllEmpty) {
+    std::vector<Optional<int>> v;
+    EXPECT_TRUE((v | views::engaged).empty());
+    v.resize(5);
+    EXPECT_TRUE((v | views::engaged).empty());
+}
+
+TEST(ViewsTest, EngagedReferences) {
+    int a = 1;
+    int b = 2;
+    std::vector<Optional<int&>> v{a, opt::none, b};
+    for (int& i : v | views::engaged)
+        ++i;
+    EXPECT_EQ(2, a);
+    EXPECT_EQ(3, b);
+}
+
+TEST(ViewsTest, EngagedBitmap) {
+    auto c = make_column(300);
+    std::vector<int> expected;
+    for (int i = 0; i < 300; ++i) {
+        if (i % 7 == 0 || (i >= 200 && i < 210))
+            expected.push_back(i);
+    }
+    EXPECT_EQ(expected, collect(c | views::engaged));
+    EXPECT_EQ(expected, collect(views::flatten(c)));
+
+    for (int& i : c | views::engaged)
+        i = -i;
+    EXPECT_EQ(-7, *c[7]);
+}
+
+TEST(ViewsTest, FlattenBitmapCopies) {
+    auto c = make_column(10);
+    auto flat = c | views::flatten;
+    static_assert(std::is_same<int, decltype(*flat.begin())>::value, "");
+    for (auto&& i : flat)
+        i = -1;
+    EXPECT_EQ(7, *c[7]);
+}
+
+TEST(ViewsTest, EngagedBitmapSkipsEmptyWords) {
+    opt::Optional_column<int> c(1000);
+    c.set(999, 5);
+    c.set(0, 1);
+    EXPECT_EQ((std::vector<int>{1, 5}), collect(c | views::engaged));
+    opt::Optional_column<int> empty(1000);
+    EXPECT_TRUE((empty | views::engaged).empty());
+}
+
+TEST(ViewsTest, ValuesOr) {
+    std::vector<Optional<int>> v{1, opt::none, 3};
+    EXPECT_EQ((std::vector<int>{1, -1, 3}), collect(v | views::values_or(-1)));
+    EXPECT_EQ((std::vector<int>{1, 0, 3}), collect(views::values_or(v, 0)));
+
+    opt::Optional_column<int> c{opt::none, 2, opt::none};
+    EXPECT_EQ((std::vector<int>{9, 2, 9}), collect(c | views::values_or(9)));
+}
+
+TEST(ViewsTest, TransformOptKeepsGaps) {
+    std::vector<Optional<int>> v{1, opt::none, 3};
+    auto const r = collect(
+        v | views::transform_opt([](int i) { return std::to_string(i); }));
+    ASSERT_EQ(3u, r.size());
+    EXPECT_EQ("1", *r[0]);
+    EXPECT_FALSE(r[1]);
+    EXPECT_EQ("3", *r[2]);
+
+    opt::Optional_column<int> c{opt::none, 2};
+    auto const rc = collect(views::transform_opt(c, [](int i) { return i * 2; }));
+    ASSERT_EQ(2u, rc.size());
+    EXPECT_FALSE(rc[0]);
+    EXPECT_EQ(4, *rc[1]);
+}
+
+TEST(ViewsTest, FlattenComposes) {
+    std::vector<Optional<int>> v{1, opt::none, 3, opt::none};
+    auto strings =
+        v | views::transform_opt([](int i) { return std::to_string(i); }) |
+        views::flatten;
+    EXPECT_EQ((std::vector<std::string>{"1", "3"}), collect(strings));
+    EXPECT_EQ((std::vector<int>{1, 3}), collect(v | views::flatten));
+}
+
+TEST(ViewsTest, IteratorsOutliveView) {
+    std::vector<Optional<int>> v{opt::none, 2};
+    auto it = (v | views::engaged).begin();
+    EXPECT_EQ(2, *it);
+}
@@ -0,0 +1,99 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <gtest/gtest.h>
+
+#include <optional/bad_optional_access.hpp>
+#include <optional/none.hpp>
+#include <optional/optional_free_functions.hpp>
+#include <optional/wire.hpp>
+
+using opt::Optional;
+using opt::Wire_message;
+using opt::Wire_optional_view;
+
+namespace {
+
+enum class Side : std::uint8_t { buy = 1, sell = 2 };
+
+using Quote = Wire_message<std::uint32_t, double, std::int16_t, Side>;
+
+static_assert(Quote::size() == 1 + 4 + 8 + 2 + 1, "");
+static_assert(Quote::offset<0>() == 1, "");
+static_assert(Quote::offset<1>() == 5, "");
+static_assert(Quote::offset<2>() == 13, "");
+static_assert(Quote::offset<3>() == 15, "");
+static_assert(opt::wire_size<double>() == 9, "");
+
+}  // namespace
+
+TEST(WireTest, StandaloneField) {
+    unsigned char buffer[2 * 5 + 1];
+    // Misaligned on purpose.
+    auto p = opt::encode(Optional<std::int32_t>{-2}, buffer + 1);
+    EXPECT_EQ(buffer + 6, p);
+    opt::encode(Optional<std::int32_t>{}, p);
+
+    unsigned char const expected[] = {1, 0xFE, 0xFF, 0xFF, 0xFF};
+    EXPECT_EQ(0, std::memcmp(expected, buffer + 1, 5));
+
+    Wire_optional_view<std::int32_t> const x{buffer + 1};
+    ASSERT_TRUE(x);
+    EXPECT_EQ(-2, *x);
+    EXPECT_EQ(-2, x.value());
+    EXPECT_EQ(Optional<std::int32_t>{-2}, x.to_optional());
+
+    Wire_optional_view<std::int32_t> const y{buffer + 6};
+    EXPECT_FALSE(y);
+    EXPECT_EQ(7, y.value_or(7));
+    EXPECT_FALSE(y.to_optional());
+    EXPECT_THROW(y.value(), opt::Bad_optional_access);
+}
+
+TEST(WireTest, MessageRoundTrip) {
+    unsigned char buffer[Quote::size() + 3];
+    auto const message = buffer + 3;
+    auto const end = Quote::encode(message, 42u, 1.5, opt::none, Side::sell);
+    EXPECT_EQ(message + Quote::size(), end);
+    EXPECT_EQ(0x0B, message[0]);
+
+    EXPECT_EQ(42u, *Quote::view<0>(message));
+    EXPECT_EQ(1.5, *Quote::view<1>(message));
+    EXPECT_FALSE(Quote::view<2>(message));
+    EXPECT_EQ(Side::sell, *Quote::view<3>(message));
+
+    Quote::write<2>(message, std::int16_t{-300});
+    Quote::write<1>(message, opt::none);
+    EXPECT_EQ(-300, *Quote::view<2>(message));
+    EXPECT_FALSE(Quote::view<1>(message));
+    EXPECT_EQ(0.0, Quote::view<1>(message).value_or(0.0));
+    EXPECT_EQ(42u, *Quote::view<0>(message));
+}
+
+TEST(WireTest, ManyFieldsSpanPresenceBytes) {
+    using Wide = Wire_message<std::uint8_t, std::uint8_t, std::uint8_t,
+                              std::uint8_t, std::uint8_t, std::uint8_t,
+                              std::uint8_t, std::uint8_t, std::uint64_t>;
+    static_assert(Wide::size() == 2 + 8 + 8, "");
+    unsigned char message[Wide::size()] = {};
+    Wide::write<8>(message, std::uint64_t{0x0102030405060708});
+    EXPECT_EQ(0, message[0]);
+    EXPECT_EQ(1, message[1]);
+    EXPECT_EQ(0x08, message[Wide::offset<8>()]);
+    EXPECT_EQ(0x0102030405060708u, *Wide::view<8>(message));
+    EXPECT_FALSE(Wide::view<7>(message));
+}
+
+#if defined(__cpp_lib_byte)
+TEST(WireTest, StdByteBuffers) {
+    std::byte buffer[Quote::size()];
+    Quote::encode(buffer, opt::none, 2.0, std::int16_t{1}, opt::none);
+    EXPECT_FALSE(Quote::view<0>(buffer));
+    EXPECT_EQ(2.0, *Quote::view<1>(buffer));
+
+    std::byte field[opt::wire_size<float>()];
+    opt::encode(Optional<float>{0.5f}, field);
+    EXPECT_EQ(0.5f, *Wire_optional_view<float>{field});
+}
+#endif